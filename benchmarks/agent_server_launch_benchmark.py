@@ -0,0 +1,105 @@
+# -*- coding: utf-8 -*-
+"""Benchmark launching local agent servers, comparing servers started as
+new processes (which initialize agentscope again) against servers forked
+from the warm server template. It reports the latency of launching a
+server and the proportional set size (PSS) of each server, which counts
+the memory shared copy-on-write with the template only partially.
+
+Usage:
+
+    python benchmarks/agent_server_launch_benchmark.py --n_servers 8
+"""
+import argparse
+import os
+import time
+
+import agentscope
+from agentscope.server import RpcAgentServerLauncher
+from agentscope.server import configure_server_template
+from agentscope.server.server_template import get_server_template
+
+
+def _pss_mb(pid: int) -> float:
+    """Return the PSS (MB) of a process, or -1 if it's unavailable."""
+    try:
+        with open(f"/proc/{pid}/smaps_rollup", encoding="utf-8") as f:
+            for line in f:
+                if line.startswith("Pss:"):
+                    return int(line.split()[1]) / 1024
+    except OSError:
+        pass
+    return -1
+
+
+def _children(ppid: int) -> list:
+    """Return the pids of the child processes of a process."""
+    children = []
+    for pid in os.listdir("/proc"):
+        if not pid.isdigit():
+            continue
+        try:
+            with open(f"/proc/{pid}/stat", encoding="utf-8") as f:
+                fields = f.read().rsplit(")", 1)[1].split()
+        except OSError:
+            continue
+        if int(fields[1]) == ppid:
+            children.append(int(pid))
+    return children
+
+
+def _bench(n_servers: int, use_template: bool) -> tuple:
+    """Launch the servers and return the average launch latency (ms) and
+    the average PSS (MB) of the servers."""
+    configure_server_template(
+        enable=use_template,
+        preload_modules=["grpc", "tiktoken"],
+    )
+    launchers = []
+    latencies = []
+    for _ in range(n_servers):
+        launcher = RpcAgentServerLauncher(host="localhost", local_mode=True)
+        start = time.perf_counter()
+        launcher.launch()
+        latencies.append(time.perf_counter() - start)
+        launchers.append(launcher)
+
+    if use_template:
+        # The servers are the children of the template
+        pids = _children(get_server_template().process.pid)
+    else:
+        pids = [launcher.server.pid for launcher in launchers]
+    pss = [_pss_mb(pid) for pid in pids]
+
+    for launcher in launchers:
+        launcher.shutdown()
+    # Exclude the first launch, which starts the template
+    latencies = latencies[1:] if use_template else latencies
+    return (
+        sum(latencies) / len(latencies) * 1000,
+        sum(pss) / max(len(pss), 1),
+    )
+
+
+def main() -> None:
+    """Run the benchmark."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--n_servers", type=int, default=8)
+    args = parser.parse_args()
+
+    agentscope.init(save_code=False, logger_level="WARNING")
+    process_latency, process_pss = _bench(args.n_servers, False)
+    template_latency, template_pss = _bench(args.n_servers, True)
+
+    print(f"servers: {args.n_servers}")
+    print(
+        f"new process:   {process_latency:.1f} ms/launch, "
+        f"{process_pss:.1f} MB PSS/server",
+    )
+    print(
+        f"from template: {template_latency:.1f} ms/launch, "
+        f"{template_pss:.1f} MB PSS/server",
+    )
+
+
+if __name__ == "__main__":
+    main()
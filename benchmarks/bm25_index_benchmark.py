@@ -0,0 +1,147 @@
+# -*- coding: utf-8 -*-
+"""Benchmark the BM25 index of `LlamaIndexKnowledge` on a local corpus, by
+default the docs and the source code of this repository split into
+paragraphs. The benchmark reports the time to build, persist and reload the
+index, and the throughput of the keyword and identifier queries, compared
+against scoring every chunk in pure Python. The queries are answered without
+any embedding call, so the sparse retrieval costs only the numbers below.
+
+Usage:
+
+    python benchmarks/bm25_index_benchmark.py --corpus docs src --repeat 20
+"""
+import argparse
+import math
+import os
+import random
+import re
+import shutil
+import tempfile
+import time
+from collections import Counter
+from typing import List, Tuple
+
+from agentscope.rag.bm25_index import BM25Index, tokenize
+
+
+def _load_corpus(roots: List[str], exts: Tuple[str, ...]) -> List[str]:
+    """Split the files under the roots into paragraphs."""
+    chunks = []
+    for root in roots:
+        for dir_path, _, file_names in os.walk(root):
+            for file_name in sorted(file_names):
+                if not file_name.endswith(exts):
+                    continue
+                with open(
+                    os.path.join(dir_path, file_name),
+                    encoding="utf-8",
+                    errors="ignore",
+                ) as f:
+                    text = f.read()
+                chunks.extend(
+                    _.strip() for _ in re.split(r"\n\s*\n", text) if _.strip()
+                )
+    return chunks
+
+
+def _naive_query(
+    docs: List[Counter],
+    df: Counter,
+    avg_length: float,
+    query: str,
+    top_k: int,
+) -> List[int]:
+    """Score every chunk by BM25 one by one."""
+    k1, b = 1.2, 0.75
+    terms = set(tokenize(query))
+    scores = []
+    for row, tf in enumerate(docs):
+        length = sum(tf.values())
+        score = 0.0
+        for term in terms:
+            if tf[term] == 0:
+                continue
+            idf = math.log(1 + (len(docs) - df[term] + 0.5) / (df[term] + 0.5))
+            score += (
+                idf
+                * tf[term]
+                * (k1 + 1)
+                / (tf[term] + k1 * (1 - b + b * length / avg_length))
+            )
+        if score > 0:
+            scores.append((score, row))
+    return [row for _, row in sorted(scores, reverse=True)[:top_k]]
+
+
+def main() -> None:
+    """Run the benchmark."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--corpus", nargs="+", default=["docs", "src"])
+    parser.add_argument("--exts", nargs="+", default=[".md", ".py"])
+    parser.add_argument("--repeat", type=int, default=20)
+    parser.add_argument("--n_queries", type=int, default=200)
+    parser.add_argument("--top_k", type=int, default=5)
+    args = parser.parse_args()
+
+    base = _load_corpus(args.corpus, tuple(args.exts))
+    # repeat the corpus to simulate a larger knowledge
+    chunks = base * args.repeat
+    ids = [f"node_{i}" for i in range(len(chunks))]
+    ref_doc_ids = [f"doc_{i // 20}" for i in range(len(chunks))]
+    # identifiers and words picked from the corpus as the queries
+    rng = random.Random(0)
+    vocabulary = sorted({_ for chunk in base for _ in tokenize(chunk)})
+    queries = [
+        " ".join(rng.sample(vocabulary, rng.randint(1, 3)))
+        for _ in range(args.n_queries)
+    ]
+    print(
+        f"chunks: {len(chunks)} ({len(base)} x {args.repeat}), "
+        f"vocabulary: {len(vocabulary)}",
+    )
+
+    root = tempfile.mkdtemp()
+    try:
+        start = time.perf_counter()
+        index = BM25Index(root)
+        index.add(ids, ref_doc_ids, chunks)
+        duration = time.perf_counter() - start
+        print(
+            f"build: {duration:.2f} s "
+            f"({len(chunks) / duration:.0f} chunks/s)",
+        )
+
+        start = time.perf_counter()
+        index.persist()
+        size = os.path.getsize(os.path.join(root, "bm25_index.json"))
+        print(
+            f"persist: {time.perf_counter() - start:.2f} s, "
+            f"{size / 2**20:.1f} MB",
+        )
+
+        start = time.perf_counter()
+        index = BM25Index(root)
+        index.query(queries[0], args.top_k)
+        print(f"load and first query: {time.perf_counter() - start:.2f} s")
+
+        start = time.perf_counter()
+        for query in queries:
+            index.query(query, args.top_k)
+        qps = len(queries) / (time.perf_counter() - start)
+        print(f"BM25Index: {qps:.1f} queries/s")
+
+        docs = [Counter(tokenize(_)) for _ in chunks]
+        df = Counter(term for tf in docs for term in tf)
+        avg_length = sum(sum(tf.values()) for tf in docs) / len(docs)
+        n_naive = max(1, len(queries) // 20)
+        start = time.perf_counter()
+        for query in queries[:n_naive]:
+            _naive_query(docs, df, avg_length, query, args.top_k)
+        qps = n_naive / (time.perf_counter() - start)
+        print(f"pure Python scoring: {qps:.1f} queries/s")
+    finally:
+        shutil.rmtree(root, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    main()
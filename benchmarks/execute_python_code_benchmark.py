@@ -0,0 +1,54 @@
+# -*- coding: utf-8 -*-
+"""Benchmark the per-execution latency of `execute_python_code` with a new
+process (or container) for each execution against the warm sandbox pool.
+
+Usage:
+
+    python benchmarks/execute_python_code_benchmark.py --n_runs 50
+    python benchmarks/execute_python_code_benchmark.py --n_runs 10 --docker
+"""
+import argparse
+import time
+
+from agentscope.service import configure_sandbox_pool, execute_python_code
+
+_CODE = "import math\nprint(math.sqrt(16))"
+
+
+def _bench(n_runs: int, use_docker: bool) -> float:
+    """Return the average latency (ms) of `n_runs` executions."""
+    start = time.perf_counter()
+    for _ in range(n_runs):
+        response = execute_python_code(
+            _CODE,
+            timeout=10,
+            use_docker=use_docker,
+        )
+        assert "4.0" in response.content, response.content
+    return (time.perf_counter() - start) / n_runs * 1000
+
+
+def main() -> None:
+    """Run the benchmark."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--n_runs", type=int, default=50)
+    parser.add_argument("--docker", action="store_true")
+    args = parser.parse_args()
+
+    configure_sandbox_pool(pool_size=0)
+    _bench(1, args.docker)
+    fresh = _bench(args.n_runs, args.docker)
+
+    configure_sandbox_pool(pool_size=2, max_runs=args.n_runs + 1)
+    # warm up
+    _bench(1, args.docker)
+    pooled = _bench(args.n_runs, args.docker)
+    configure_sandbox_pool()
+
+    print(f"new sandbox per run: {fresh:.3f} ms/run")
+    print(f"warm sandbox pool:   {pooled:.3f} ms/run")
+    print(f"saved per run:       {fresh - pooled:.3f} ms")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,77 @@
+# -*- coding: utf-8 -*-
+"""Benchmark the per-call latency of `requests.post` against the shared,
+connection-pooled session on a local stub HTTP server.
+
+Usage:
+
+    python benchmarks/http_session_benchmark.py --n_calls 500
+"""
+import argparse
+import json
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+import requests
+
+from agentscope.utils.http_session import get_http_session
+
+
+class _StubHandler(BaseHTTPRequestHandler):
+    """A stub handler that answers every POST request with a small json."""
+
+    protocol_version = "HTTP/1.1"
+    # Send the headers and body in one segment, so that the keep-alive
+    # connections are not delayed by Nagle's algorithm
+    wbufsize = -1
+    disable_nagle_algorithm = True
+
+    def do_POST(self) -> None:  # pylint: disable=invalid-name
+        """Handle the POST request."""
+        length = int(self.headers.get("Content-Length", 0))
+        self.rfile.read(length)
+        body = json.dumps({"data": {"response": "ok"}}).encode()
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+
+    def log_message(self, *args: object) -> None:
+        """Keep the benchmark output clean."""
+
+
+def _bench(post: callable, url: str, n_calls: int) -> float:
+    """Return the average latency (ms) of `n_calls` post calls."""
+    start = time.perf_counter()
+    for _ in range(n_calls):
+        post(url, json={"inputs": "hello"}, timeout=10).json()
+    return (time.perf_counter() - start) / n_calls * 1000
+
+
+def main() -> None:
+    """Run the benchmark."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--n_calls", type=int, default=500)
+    args = parser.parse_args()
+
+    server = ThreadingHTTPServer(("127.0.0.1", 0), _StubHandler)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    url = f"http://127.0.0.1:{server.server_address[1]}/"
+
+    # warm up
+    _bench(requests.post, url, 10)
+    _bench(get_http_session().post, url, 10)
+
+    plain = _bench(requests.post, url, args.n_calls)
+    pooled = _bench(get_http_session().post, url, args.n_calls)
+
+    print(f"requests.post:       {plain:.3f} ms/call")
+    print(f"pooled session.post: {pooled:.3f} ms/call")
+    print(f"saved per call:      {plain - pooled:.3f} ms")
+
+    server.shutdown()
+
+
+if __name__ == "__main__":
+    main()
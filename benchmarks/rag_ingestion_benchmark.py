@@ -0,0 +1,142 @@
+# -*- coding: utf-8 -*-
+"""Benchmark building a knowledge from many files with `LlamaIndexKnowledge`,
+comparing the serial ingestion (one process, one chunk per embedding call)
+against loading and splitting the files in multiple processes and embedding
+the chunks concurrently in batches. The embedding model is simulated with a
+fixed latency per call, so the result reflects the ingestion overhead
+rather than a real provider.
+
+Usage:
+
+    python benchmarks/rag_ingestion_benchmark.py --n_files 10000
+"""
+import argparse
+import os
+import shutil
+import tempfile
+import time
+from typing import Any
+
+from agentscope.models import ModelResponse, ModelWrapperBase
+from agentscope.rag import LlamaIndexKnowledge
+
+
+class SimulatedEmbeddingModel(ModelWrapperBase):
+    """An embedding model taking a fixed latency per call plus a small
+    latency per text, like a remote embedding API."""
+
+    model_type: str = "simulated_embedding"
+    max_batch_size: int = 64
+
+    def __init__(self, latency: float, per_text_latency: float) -> None:
+        super().__init__(config_name="simulated_embedding")
+        self.latency = latency
+        self.per_text_latency = per_text_latency
+
+    def __call__(self, texts: Any, **kwargs: Any) -> ModelResponse:
+        """Return a constant embedding for each text after the latency."""
+        texts = [texts] if isinstance(texts, str) else texts
+        time.sleep(self.latency + self.per_text_latency * len(texts))
+        return ModelResponse(embedding=[[1.0, 0.0, 0.0]] * len(texts))
+
+    def format(self, *args: Any) -> Any:
+        """Embedding models don't format messages."""
+        raise NotImplementedError
+
+
+def _write_files(data_dir: str, n_files: int) -> None:
+    """Write the text files to be ingested."""
+    paragraph = "AgentScope builds multi-agent applications. " * 40
+    for i in range(n_files):
+        with open(
+            os.path.join(data_dir, f"file_{i}.txt"),
+            "w",
+            encoding="utf-8",
+        ) as f:
+            f.write(f"Document {i}.\n\n" + "\n\n".join([paragraph] * 4))
+
+
+def _bench(data_dir: str, model: ModelWrapperBase, **kwargs: Any) -> dict:
+    """Build the knowledge and return the ingestion metrics."""
+    knowledge_config = {
+        "knowledge_id": "",
+        "chunk_size": 256,
+        "data_processing": [
+            {
+                "load_data": {
+                    "loader": {
+                        "create_object": True,
+                        "module": "llama_index.core",
+                        "class": "SimpleDirectoryReader",
+                        "init_args": {
+                            "input_dir": data_dir,
+                            "required_exts": ".txt",
+                        },
+                    },
+                },
+            },
+        ],
+    }
+    persist_root = tempfile.mkdtemp()
+    try:
+        start = time.perf_counter()
+        knowledge = LlamaIndexKnowledge(
+            knowledge_id="bench",
+            emb_model=model,
+            knowledge_config=knowledge_config,
+            persist_root=persist_root,
+            showprogress=False,
+            **kwargs,
+        )
+        metrics = dict(knowledge.ingestion_metrics)
+        metrics["total_seconds"] = time.perf_counter() - start
+    finally:
+        shutil.rmtree(persist_root, ignore_errors=True)
+    return metrics
+
+
+def _report(name: str, metrics: dict) -> None:
+    """Print the metrics of an ingestion."""
+    print(
+        f"{name}: {metrics['total_seconds']:.1f} s total, "
+        f"load {metrics['load_seconds']:.1f} s, "
+        f"split {metrics['split_seconds']:.1f} s, "
+        f"embed {metrics['embed_seconds']:.1f} s "
+        f"({metrics['embedded_nodes'] / metrics['embed_seconds']:.0f} "
+        f"chunks/s)",
+    )
+
+
+def main() -> None:
+    """Run the benchmark."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--n_files", type=int, default=10000)
+    parser.add_argument("--latency", type=float, default=0.02)
+    parser.add_argument("--per_text_latency", type=float, default=0.0005)
+    args = parser.parse_args()
+
+    model = SimulatedEmbeddingModel(args.latency, args.per_text_latency)
+    data_dir = tempfile.mkdtemp()
+    try:
+        _write_files(data_dir, args.n_files)
+        serial = _bench(
+            data_dir,
+            model,
+            num_workers=1,
+            embed_batch_size=1,
+            embed_concurrency=1,
+        )
+        parallel = _bench(data_dir, model)
+    finally:
+        shutil.rmtree(data_dir, ignore_errors=True)
+
+    print(
+        f"files: {args.n_files}, chunks: {serial['nodes']}, "
+        f"CPUs: {os.cpu_count()}",
+    )
+    _report("serial  ", serial)
+    _report("parallel", parallel)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,94 @@
+# -*- coding: utf-8 -*-
+"""Benchmark creating and cloning a large number of distributed agents on
+local agent servers. It compares
+
+- creating the agents one request per agent against
+  `RpcAgent.create_in_batch`, which sends a request per batch of agents and
+  requests the servers concurrently,
+- cloning the agents one request per clone (the previous `clone_instances`)
+  against cloning them in one request.
+
+Usage:
+
+    python benchmarks/rpc_agent_create_benchmark.py --n_agents 10000
+"""
+import argparse
+import time
+from typing import Optional, Sequence, Union
+
+from agentscope.agents import AgentBase, RpcAgent
+from agentscope.message import Msg
+from agentscope.server import RpcAgentServerLauncher
+
+
+class BenchAgent(AgentBase):
+    """A light agent to measure the overhead of creation."""
+
+    def reply(self, x: Optional[Union[Msg, Sequence[Msg]]] = None) -> Msg:
+        """Echo the input."""
+        return x
+
+
+def _create(ports: list, n_agents: int, prefix: str) -> list:
+    """Create the agents evenly on the servers."""
+    return [
+        BenchAgent(name=f"{prefix}{i}").to_dist(
+            host="localhost",
+            port=ports[i % len(ports)],
+        )
+        for i in range(n_agents)
+    ]
+
+
+def main() -> None:
+    """Run the benchmark."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--n_agents", type=int, default=10000)
+    parser.add_argument("--n_servers", type=int, default=4)
+    parser.add_argument("--n_serial", type=int, default=1000)
+    parser.add_argument("--batch_size", type=int, default=1000)
+    args = parser.parse_args()
+
+    launchers = [
+        RpcAgentServerLauncher(host="localhost", custom_agents=[BenchAgent])
+        for _ in range(args.n_servers)
+    ]
+    for launcher in launchers:
+        launcher.launch()
+    ports = [launcher.port for launcher in launchers]
+
+    try:
+        # The serial creation is measured on fewer agents and extrapolated
+        start = time.perf_counter()
+        _create(ports, args.n_serial, "s")
+        serial = (time.perf_counter() - start) / args.n_serial
+
+        start = time.perf_counter()
+        with RpcAgent.create_in_batch(batch_size=args.batch_size):
+            agents = _create(ports, args.n_agents, "b")
+        batch = time.perf_counter() - start
+        msg = Msg(name="user", content="hi", role="user")
+        assert agents[-1](msg).content == "hi"
+
+        start = time.perf_counter()
+        for _ in range(args.n_serial):
+            agents[0].client.call_func("_clone_agent")
+        serial_clone = (time.perf_counter() - start) / args.n_serial
+
+        start = time.perf_counter()
+        clones = agents[0].clone_instances(args.n_agents, including_self=False)
+        batch_clone = time.perf_counter() - start
+        assert len(clones) == args.n_agents
+    finally:
+        for launcher in launchers:
+            launcher.shutdown()
+
+    print(f"agents: {args.n_agents}, servers: {args.n_servers}")
+    print(f"serial create (estimated): {serial * args.n_agents:.2f} s")
+    print(f"create_in_batch:           {batch:.2f} s")
+    print(f"serial clone (estimated):  {serial_clone * args.n_agents:.2f} s")
+    print(f"clone_instances:           {batch_clone:.2f} s")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,230 @@
+# -*- coding: utf-8 -*-
+"""Benchmark the vector stores of `LlamaIndexKnowledge`, comparing the
+JSON-persisted vectors of llama-index's default `SimpleVectorStore` against
+the memory-mapped float32/float16 matrix of `MmapEmbeddingStore`, with and
+without the IVF index. Each store is loaded and queried in a new process,
+and the benchmark reports the load time, the growth of the resident memory
+(RSS) by loading and querying the store, the query throughput, and the
+recall of the top k against the exact search. The files are in the page
+cache after being written, so the load time doesn't include the disk reads.
+
+Usage:
+
+    python benchmarks/vector_store_benchmark.py --n_vectors 50000 --dim 384
+"""
+import argparse
+import heapq
+import json
+import multiprocessing
+import os
+import shutil
+import tempfile
+import time
+from typing import Any, Callable, List
+
+import numpy as np
+
+from agentscope.rag.mmap_vector_store import MmapEmbeddingStore
+
+try:
+    from llama_index.core.indices.query.embedding_utils import (
+        get_top_k_embeddings,
+    )
+except ImportError:
+
+    def get_top_k_embeddings(
+        query_embedding: List[float],
+        embeddings: List[List[float]],
+        similarity_top_k: int,
+        embedding_ids: List[str],
+    ) -> tuple:
+        """The brute-force search of SimpleVectorStore in llama-index,
+        which scores the embeddings one by one."""
+        query = np.array(query_embedding)
+        heap: list = []
+        embeddings = np.array(embeddings)
+        for embedding, embedding_id in zip(embeddings, embedding_ids):
+            similarity = np.dot(query, embedding) / (
+                np.linalg.norm(query) * np.linalg.norm(embedding)
+            )
+            heapq.heappush(heap, (similarity, embedding_id))
+            if len(heap) > similarity_top_k:
+                heapq.heappop(heap)
+        result = sorted(heap, reverse=True)
+        return [_[0] for _ in result], [_[1] for _ in result]
+
+
+def _rss_mb() -> float:
+    """The resident memory (MB) of the current process."""
+    with open("/proc/self/status", encoding="utf-8") as f:
+        for line in f:
+            if line.startswith("VmRSS:"):
+                return int(line.split()[1]) / 1024
+    return -1
+
+
+def _load_json(persist_dir: str, **kwargs: Any) -> Callable:
+    """Load the vectors persisted as SimpleVectorStore does."""
+    del kwargs
+    with open(
+        os.path.join(persist_dir, "default__vector_store.json"),
+        encoding="utf-8",
+    ) as f:
+        embedding_dict = json.load(f)["embedding_dict"]
+    ids = list(embedding_dict.keys())
+    embeddings = list(embedding_dict.values())
+
+    def query(query_embedding: List[float], top_k: int) -> list:
+        return get_top_k_embeddings(
+            query_embedding,
+            embeddings,
+            similarity_top_k=top_k,
+            embedding_ids=ids,
+        )[1]
+
+    return query
+
+
+def _load_mmap(persist_dir: str, **kwargs: Any) -> Callable:
+    """Open the memory-mapped store, which is loaded on the first query."""
+    store = MmapEmbeddingStore(persist_dir, **kwargs)
+
+    def query(query_embedding: List[float], top_k: int) -> list:
+        return store.query(query_embedding, top_k)[0]
+
+    return query
+
+
+def _run(
+    loader: Callable,
+    persist_dir: str,
+    queries: np.ndarray,
+    top_k: int,
+    kwargs: dict,
+    results: Any,
+) -> None:
+    """Load a store and query it in a new process."""
+    rss = _rss_mb()
+    start = time.perf_counter()
+    query = loader(persist_dir, **kwargs)
+    # the first query includes the lazy loading
+    found = [query(queries[0].tolist(), top_k)]
+    load_seconds = time.perf_counter() - start
+
+    start = time.perf_counter()
+    for embedding in queries[1:]:
+        found.append(query(embedding.tolist(), top_k))
+    qps = (len(queries) - 1) / (time.perf_counter() - start)
+    results.put((load_seconds, _rss_mb() - rss, qps, found))
+
+
+def _bench(
+    loader: Callable,
+    persist_dir: str,
+    queries: np.ndarray,
+    top_k: int,
+    **kwargs: Any,
+) -> tuple:
+    """Run a store in a new process and return its results."""
+    ctx = multiprocessing.get_context("spawn")
+    results = ctx.Queue()
+    process = ctx.Process(
+        target=_run,
+        args=(loader, persist_dir, queries, top_k, kwargs, results),
+    )
+    process.start()
+    result = results.get()
+    process.join()
+    return result
+
+
+def main() -> None:
+    """Run the benchmark."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--n_vectors", type=int, default=50000)
+    parser.add_argument("--dim", type=int, default=384)
+    parser.add_argument("--n_queries", type=int, default=50)
+    parser.add_argument("--top_k", type=int, default=5)
+    parser.add_argument("--nlist", type=int, default=256)
+    parser.add_argument("--nprobe", type=int, default=16)
+    args = parser.parse_args()
+
+    # clustered embeddings, like the chunks of documents on a few topics
+    rng = np.random.default_rng(0)
+    centers = rng.normal(size=(args.nlist, args.dim))
+    embeddings = (
+        centers[rng.integers(args.nlist, size=args.n_vectors)]
+        + rng.normal(size=(args.n_vectors, args.dim)) * 0.5
+    ).astype(np.float32)
+    queries = embeddings[rng.integers(args.n_vectors, size=args.n_queries)]
+    queries = queries + rng.normal(size=queries.shape) * 0.1
+    ids = [f"node_{i}" for i in range(args.n_vectors)]
+
+    root = tempfile.mkdtemp()
+    try:
+        json_dir = os.path.join(root, "json")
+        os.makedirs(json_dir)
+        with open(
+            os.path.join(json_dir, "default__vector_store.json"),
+            "w",
+            encoding="utf-8",
+        ) as f:
+            json.dump(
+                {
+                    "embedding_dict": dict(zip(ids, embeddings.tolist())),
+                    "text_id_to_ref_doc_id": {_: _ for _ in ids},
+                    "metadata_dict": {},
+                },
+                f,
+            )
+        for name, dtype, nlist in [
+            ("float32", "float32", None),
+            ("float16", "float16", None),
+            ("float16_ivf", "float16", args.nlist),
+        ]:
+            store = MmapEmbeddingStore(
+                os.path.join(root, name),
+                dtype=dtype,
+                nlist=nlist,
+            )
+            store.add(ids, ids, embeddings)
+            store.persist()
+
+        runs = [
+            ("SimpleVectorStore (JSON)", _load_json, "json", {}),
+            ("mmap float32", _load_mmap, "float32", {}),
+            ("mmap float16", _load_mmap, "float16", {}),
+            (
+                f"mmap float16 + IVF (nprobe={args.nprobe})",
+                _load_mmap,
+                "float16_ivf",
+                {"nprobe": args.nprobe},
+            ),
+        ]
+        print(f"vectors: {args.n_vectors}, dim: {args.dim}")
+        exact = None
+        for name, loader, sub_dir, kwargs in runs:
+            load_seconds, rss, qps, found = _bench(
+                loader,
+                os.path.join(root, sub_dir),
+                queries,
+                args.top_k,
+                **kwargs,
+            )
+            exact = exact or found
+            recall = np.mean(
+                [
+                    len(set(a) & set(b)) / args.top_k
+                    for a, b in zip(found, exact)
+                ],
+            )
+            print(
+                f"{name}: load {load_seconds:.2f} s, RSS +{rss:.0f} MB, "
+                f"{qps:.1f} queries/s, recall@{args.top_k} {recall:.3f}",
+            )
+    finally:
+        shutil.rmtree(root, ignore_errors=True)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,204 @@
+# -*- coding: utf-8 -*-
+"""Benchmark loading and parsing a batch of web pages, which are generated
+as local HTML fixtures and served by stub HTTP servers with a simulated
+network latency. It compares
+
+- the BeautifulSoup based parser (the previous `parse_html_to_text`)
+  against the single-pass `HTMLTextExtractor`,
+- serial `load_web` calls against `load_webs`, without and with the
+  conditional-GET cache.
+
+Usage:
+
+    python benchmarks/web_digest_benchmark.py --n_pages 40 --latency_ms 50
+"""
+import argparse
+import hashlib
+import shutil
+import tempfile
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from typing import Callable, List, Sequence
+
+from agentscope.service import load_web, load_webs, parse_html_to_text
+from agentscope.service.service_status import ServiceExecStatus
+from agentscope.service.web.web_digest import is_valid_url
+
+_SELECTED_TAGS = ("h", "p", "li", "div", "a")
+
+
+def _make_fixture(index: int, n_sections: int) -> bytes:
+    """Generate a web page with nested sections, lists and links."""
+    sections = []
+    for i in range(n_sections):
+        sections.append(
+            f"<div class='section'><h2>Section {i}</h2>"
+            f"<p>Paragraph {i} of page {index} with "
+            f"<a href='https://example.com/{index}/{i}'>a link</a> and "
+            "<b>some bold text</b>.</p>"
+            "<ul><li>first item</li><li>second item</li></ul>"
+            "<script>var ignored = 1;</script></div>",
+        )
+    return (
+        "<!DOCTYPE html><html><head><title>Fixture</title></head><body>"
+        + "".join(sections)
+        + "</body></html>"
+    ).encode("utf-8")
+
+
+def _make_handler(pages: dict, latency: float) -> type:
+    """Create a handler serving the pages with ETags after the latency."""
+
+    class _StubHandler(BaseHTTPRequestHandler):
+        """A stub handler that answers conditional GET requests."""
+
+        protocol_version = "HTTP/1.1"
+
+        def do_GET(self) -> None:  # pylint: disable=invalid-name
+            """Handle the GET request."""
+            time.sleep(latency)
+            body = pages[self.path]
+            etag = f'"{hashlib.md5(body).hexdigest()}"'
+            if self.headers.get("If-None-Match") == etag:
+                self.send_response(304)
+                self.send_header("ETag", etag)
+                self.send_header("Content-Length", "0")
+                self.end_headers()
+                return
+            self.send_response(200)
+            self.send_header("Content-Type", "text/html; charset=utf-8")
+            self.send_header("ETag", etag)
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def log_message(self, *args: object) -> None:
+            """Keep the benchmark output clean."""
+
+    return _StubHandler
+
+
+def _parse_with_bs4(html_text: str, html_selected_tags: Sequence[str]) -> str:
+    """The previous BeautifulSoup based `parse_html_to_text`."""
+    from bs4 import BeautifulSoup, NavigableString, Tag
+
+    doc = BeautifulSoup(html_text, "html.parser")
+
+    def get_navigable_strings(e: Tag) -> str:
+        text = ""
+        for child in e.children:
+            if isinstance(child, Tag):
+                text += get_navigable_strings(child).strip(" \n\t")
+            elif isinstance(child, NavigableString):
+                if (e.name == "a") and (href := e.get("href")):
+                    if is_valid_url(href):
+                        text += f"[{child.strip()}]({href})"
+                else:
+                    text += child.text
+        return " ".join(text.split())
+
+    text_parts = ""
+    for element in doc.find_all(recursive=True):
+        if element.name in html_selected_tags:
+            text_parts += get_navigable_strings(element).strip(" \n\t")
+            element.decompose()
+    return text_parts
+
+
+def _bench_parse(
+    parse: Callable[[str, Sequence[str]], str],
+    htmls: List[str],
+) -> float:
+    """Return the average latency (ms) of parsing a page."""
+    start = time.perf_counter()
+    for html in htmls:
+        parse(html, _SELECTED_TAGS)
+    return (time.perf_counter() - start) / len(htmls) * 1000
+
+
+def _bench_load(load: Callable[[], None]) -> float:
+    """Return the latency (ms) of loading the whole batch."""
+    start = time.perf_counter()
+    load()
+    return (time.perf_counter() - start) * 1000
+
+
+def main() -> None:
+    """Run the benchmark."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--n_pages", type=int, default=40)
+    parser.add_argument("--n_hosts", type=int, default=4)
+    parser.add_argument("--n_sections", type=int, default=200)
+    parser.add_argument("--latency_ms", type=float, default=50)
+    parser.add_argument("--max_workers", type=int, default=8)
+    parser.add_argument("--max_per_host", type=int, default=2)
+    args = parser.parse_args()
+
+    pages = {
+        f"/page/{i}": _make_fixture(i, args.n_sections)
+        for i in range(args.n_pages)
+    }
+    handler = _make_handler(pages, args.latency_ms / 1000)
+    servers = [
+        ThreadingHTTPServer(("127.0.0.1", 0), handler)
+        for _ in range(args.n_hosts)
+    ]
+    for server in servers:
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+    urls = [
+        f"http://127.0.0.1:{servers[i % args.n_hosts].server_address[1]}"
+        f"{path}"
+        for i, path in enumerate(pages)
+    ]
+
+    # Parsing
+    htmls = [page.decode("utf-8") for page in pages.values()]
+    assert _parse_with_bs4(htmls[0], _SELECTED_TAGS) == parse_html_to_text(
+        htmls[0],
+        _SELECTED_TAGS,
+    )
+    bs4_parse = _bench_parse(_parse_with_bs4, htmls)
+    stream_parse = _bench_parse(parse_html_to_text, htmls)
+
+    # Loading
+    def _serial() -> None:
+        for url in urls:
+            response = load_web(url, html_selected_tags=_SELECTED_TAGS)
+            assert response.status == ServiceExecStatus.SUCCESS
+
+    def _concurrent(cache_dir: str = None) -> None:
+        response = load_webs(
+            urls,
+            html_selected_tags=_SELECTED_TAGS,
+            max_workers=args.max_workers,
+            max_per_host=args.max_per_host,
+            cache_dir=cache_dir,
+        )
+        assert all(
+            _.status == ServiceExecStatus.SUCCESS
+            for _ in response.content.values()
+        )
+
+    cache_dir = tempfile.mkdtemp()
+    try:
+        serial = _bench_load(_serial)
+        concurrent = _bench_load(_concurrent)
+        # Fill the cache, then load the pages revalidated by the ETags
+        _concurrent(cache_dir)
+        cached = _bench_load(lambda: _concurrent(cache_dir))
+    finally:
+        shutil.rmtree(cache_dir)
+        for server in servers:
+            server.shutdown()
+
+    print(f"pages: {args.n_pages}, hosts: {args.n_hosts}")
+    print(f"bs4 parse:                 {bs4_parse:.3f} ms/page")
+    print(f"single-pass parse:         {stream_parse:.3f} ms/page")
+    print(f"serial load_web:           {serial:.1f} ms/batch")
+    print(f"load_webs:                 {concurrent:.1f} ms/batch")
+    print(f"load_webs (cached, 304):   {cached:.1f} ms/batch")
+
+
+if __name__ == "__main__":
+    main()
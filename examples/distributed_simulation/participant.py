@@ -8,7 +8,7 @@ from typing import Optional, Union, Sequence
 from loguru import logger
 
 from agentscope.message import Msg
-from agentscope.agents import AgentBase
+from agentscope.agents import AgentBase, RpcAgent
 
 
 class RandomParticipant(AgentBase):
@@ -111,30 +111,32 @@ class Moderator(AgentBase):
     ) -> None:
         super().__init__(name)
         self.max_value = max_value
-        if agent_type == "llm":
-            self.participants = [
-                LLMParticipant(
-                    name=config["name"],
-                    model_config_name=config["model_config_name"],
-                    max_value=max_value,
-                ).to_dist(
-                    host=config["host"],
-                    port=config["port"],
-                )
-                for config in part_configs
-            ]
-        else:
-            self.participants = [
-                RandomParticipant(
-                    name=config["name"],
-                    max_value=max_value,
-                    sleep_time=sleep_time,
-                ).to_dist(
-                    host=config["host"],
-                    port=config["port"],
-                )
-                for config in part_configs
-            ]
+        # create the participants in bulk with a request per agent server
+        with RpcAgent.create_in_batch():
+            if agent_type == "llm":
+                self.participants = [
+                    LLMParticipant(
+                        name=config["name"],
+                        model_config_name=config["model_config_name"],
+                        max_value=max_value,
+                    ).to_dist(
+                        host=config["host"],
+                        port=config["port"],
+                    )
+                    for config in part_configs
+                ]
+            else:
+                self.participants = [
+                    RandomParticipant(
+                        name=config["name"],
+                        max_value=max_value,
+                        sleep_time=sleep_time,
+                    ).to_dist(
+                        host=config["host"],
+                        port=config["port"],
+                    )
+                    for config in part_configs
+                ]
 
     def reply(self, x: Optional[Union[Msg, Sequence[Msg]]] = None) -> Msg:
         results = []
@@ -2,7 +2,10 @@
 """ Base class for Agent """
 
 from __future__ import annotations
+import queue
+import threading
 from abc import ABCMeta
+from concurrent.futures import ThreadPoolExecutor
 from typing import Optional
 from typing import Sequence
 from typing import Union
@@ -12,9 +15,79 @@ import uuid
 from loguru import logger
 
 from agentscope.agents.operator import Operator
+from agentscope.constants import _DEFAULT_BROADCAST_MAX_WORKERS
 from agentscope.message import Msg
 from agentscope.models import load_model_by_config_name
-from agentscope.memory import TemporaryMemory
+from agentscope.memory import TemporaryMemory, PromptBudget
+
+_broadcast_executor: Optional[ThreadPoolExecutor] = None
+_broadcast_executor_lock = threading.Lock()
+
+
+def _get_broadcast_executor() -> ThreadPoolExecutor:
+    """Get the thread pool shared by all broadcasts, which is created on
+    first use."""
+    global _broadcast_executor
+    with _broadcast_executor_lock:
+        if _broadcast_executor is None:
+            _broadcast_executor = ThreadPoolExecutor(
+                max_workers=_DEFAULT_BROADCAST_MAX_WORKERS,
+                thread_name_prefix="broadcast",
+            )
+        return _broadcast_executor
+
+
+class _Inbox:
+    """A bounded queue of the messages to be observed by an agent, which are
+    observed in order by a background thread. Putting a message blocks when
+    the inbox is full, so that a slow agent slows down the broadcast instead
+    of accumulating unbounded messages."""
+
+    _CLOSE = object()
+
+    def __init__(self, agent: AgentBase, maxsize: int) -> None:
+        self.agent = agent
+        self.queue: queue.Queue = queue.Queue(maxsize=maxsize)
+        self.error: Optional[Exception] = None
+        self.thread = threading.Thread(
+            target=self._run,
+            name=f"inbox-{agent.name}",
+            daemon=True,
+        )
+        self.thread.start()
+
+    def _run(self) -> None:
+        while True:
+            x = self.queue.get()
+            try:
+                if x is _Inbox._CLOSE:
+                    return
+                self.agent.observe(x)
+            except Exception as e:
+                logger.error(
+                    f"Agent [{self.agent.name}] fails to observe: {e}"
+                )
+                if self.error is None:
+                    self.error = e
+            finally:
+                self.queue.task_done()
+
+    def put(self, x: Union[dict, Sequence[dict]]) -> None:
+        """Put a message into the inbox."""
+        self.queue.put(x)
+
+    def join(self) -> None:
+        """Wait until all the messages in the inbox are observed, and raise
+        the first error occurred in observing."""
+        self.queue.join()
+        if self.error is not None:
+            error, self.error = self.error, None
+            raise error
+
+    def close(self) -> None:
+        """Observe the remaining messages and stop the background thread."""
+        self.queue.put(_Inbox._CLOSE)
+        self.thread.join()
 
 
 class _AgentMeta(ABCMeta):
@@ -135,6 +208,10 @@ class AgentBase(Operator, metaclass=_AgentMeta):
 
     _version: int = 1
 
+    concurrent_observe: bool = False
+    """Whether the agent observes a broadcast message in a separate thread,
+    which only pays off when `observe` waits for I/O, e.g. a remote call."""
+
     def __init__(
         self,
         name: str,
@@ -192,8 +269,10 @@ class AgentBase(Operator, metaclass=_AgentMeta):
             self.sys_prompt = sys_prompt
 
         # TODO: support to receive a ModelWrapper instance
+        self.prompt_budget = None
         if model_config_name is not None:
             self.model = load_model_by_config_name(model_config_name)
+            self.prompt_budget = PromptBudget.from_model(self.model)
 
         if use_memory:
             self.memory = TemporaryMemory(memory_config)
@@ -206,6 +285,8 @@ class AgentBase(Operator, metaclass=_AgentMeta):
         # The audience of this agent, which means if this agent generates a
         # response, it will be passed to all agents in the audience.
         self._audience = None
+        # The inbox to observe the broadcast messages asynchronously
+        self._inbox: Optional[_Inbox] = None
         # convert to distributed agent, conversion is in `_AgentMeta`
         if to_dist is not False and to_dist is not None:
             logger.info(
@@ -272,6 +353,30 @@ class AgentBase(Operator, metaclass=_AgentMeta):
             f'"reply" function.',
         )
 
+    def get_prompt_memory(
+        self,
+        *reserved: Union[Msg, str, None],
+    ) -> list:
+        """Get the messages in memory to build the prompt. If the prompt
+        budget is set in the model configuration, only the messages within
+        the budget are returned.
+
+        Args:
+            reserved (`Union[Msg, str, None]`):
+                The other parts of the prompt, e.g. the system prompt and the
+                hint message, whose tokens are deducted from the budget.
+
+        Returns:
+            `list`: The selected messages in chronological order.
+        """
+        if self.memory is None:
+            return []
+        memory = self.memory.get_memory()
+        prompt_budget = getattr(self, "prompt_budget", None)
+        if prompt_budget is None:
+            return memory
+        return prompt_budget.select(memory, reserved=reserved)
+
     def load_from_config(self, config: dict) -> None:
         """Load configuration for this agent.
 
@@ -293,6 +398,10 @@ class AgentBase(Operator, metaclass=_AgentMeta):
     def __call__(self, *args: Any, **kwargs: Any) -> dict:
         """Calling the reply function, and broadcast the generated
         response to all audiences if needed."""
+        # observe all the broadcast messages before replying
+        if self._inbox is not None:
+            self._inbox.join()
+
         res = self.reply(*args, **kwargs)
 
         # broadcast to audiences if needed
@@ -341,6 +450,95 @@ class AgentBase(Operator, metaclass=_AgentMeta):
         if self.memory:
             self.memory.add(x)
 
+    @classmethod
+    def observe_all(
+        cls,
+        agents: Sequence[AgentBase],
+        x: Union[dict, Sequence[dict]],
+    ) -> None:
+        """Let a group of agents of this class observe the same input. It's
+        called by `broadcast`, and can be overridden to observe in batch,
+        e.g. `RpcAgent` sends a single request to each agent server.
+
+        Args:
+            agents (`Sequence[AgentBase]`):
+                The agents of this class.
+            x (`Union[dict, Sequence[dict]]`):
+                The input message to be observed.
+        """
+        for agent in agents:
+            agent.observe(x)
+
+    @staticmethod
+    def broadcast(
+        agents: Sequence[AgentBase],
+        x: Union[dict, Sequence[dict]],
+    ) -> None:
+        """Let the agents observe the same input. The agents with an inbox
+        (see `open_inbox`) observe it asynchronously. The agents whose
+        classes override `observe_all` (e.g. `RpcAgent`) are grouped to
+        observe in batch, and the groups and the agents with
+        `concurrent_observe` observe concurrently in a shared thread pool.
+        The other agents observe one by one in the calling thread.
+
+        Args:
+            agents (`Sequence[AgentBase]`):
+                The agents to observe the input.
+            x (`Union[dict, Sequence[dict]]`):
+                The input message to be observed.
+        """
+        groups: dict = {}
+        serial = []
+        for agent in agents:
+            inbox = agent._inbox  # pylint: disable=protected-access
+            if inbox is not None:
+                inbox.put(x)
+                continue
+            observe_all = type(agent).observe_all.__func__
+            if observe_all is not AgentBase.observe_all.__func__:
+                groups.setdefault(observe_all, []).append(agent)
+            elif agent.concurrent_observe:
+                groups[id(agent)] = [agent]
+            else:
+                serial.append(agent)
+
+        if len(groups) + bool(serial) <= 1:
+            for group in groups.values():
+                type(group[0]).observe_all(group, x)
+            AgentBase.observe_all(serial, x)
+            return
+
+        executor = _get_broadcast_executor()
+        futures = [
+            executor.submit(type(_[0]).observe_all, _, x)
+            for _ in groups.values()
+        ]
+        try:
+            AgentBase.observe_all(serial, x)
+        finally:
+            for future in futures:
+                future.result()
+
+    def open_inbox(self, maxsize: int = 64) -> None:
+        """Observe the broadcast messages asynchronously through a bounded
+        inbox. The messages in the inbox are always observed before the
+        agent replies.
+
+        Args:
+            maxsize (`int`, defaults to `64`):
+                The maximum number of messages waiting in the inbox.
+        """
+        if self._inbox is None:
+            self._inbox = _Inbox(self, maxsize)
+
+    def close_inbox(self) -> None:
+        """Observe the remaining messages in the inbox and close it."""
+        if self._inbox is not None:
+            inbox, self._inbox = self._inbox, None
+            inbox.close()
+            if inbox.error is not None:
+                raise inbox.error
+
     def reset_audience(self, audience: Sequence[AgentBase]) -> None:
         """Set the audience of this agent, which means if this agent
         generates a response, it will be passed to all audiences.
@@ -379,8 +577,7 @@ class AgentBase(Operator, metaclass=_AgentMeta):
 
     def _broadcast_to_audience(self, x: dict) -> None:
         """Broadcast the input to all audiences."""
-        for agent in self._audience:
-            agent.observe(x)
+        self.broadcast(self._audience, x)
 
     @property
     def agent_id(self) -> str:
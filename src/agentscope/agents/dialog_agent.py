@@ -61,10 +61,11 @@ class DialogAgent(AgentBase):
             self.memory.add(x)
 
         # prepare prompt
+        sys_msg = Msg("system", self.sys_prompt, role="system")
         prompt = self.model.format(
-            Msg("system", self.sys_prompt, role="system"),
+            sys_msg,
             self.memory
-            and self.memory.get_memory()
+            and self.get_prompt_memory(sys_msg)
             or x,  # type: ignore[arg-type]
         )
 
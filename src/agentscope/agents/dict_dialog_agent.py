@@ -90,12 +90,14 @@ class DictDialogAgent(AgentBase):
             self.memory.add(x)
 
         # prepare prompt
+        sys_msg = Msg("system", self.sys_prompt, role="system")
+        hint_msg = Msg("system", self.parser.format_instruction, "system")
         prompt = self.model.format(
-            Msg("system", self.sys_prompt, role="system"),
+            sys_msg,
             self.memory
-            and self.memory.get_memory()
+            and self.get_prompt_memory(sys_msg, hint_msg)
             or x,  # type: ignore[arg-type]
-            Msg("system", self.parser.format_instruction, "system"),
+            hint_msg,
         )
 
         # call llm
@@ -6,12 +6,16 @@ with LlamaIndex.
 Notice, this is a Beta version of RAG agent.
 """
 
+from concurrent.futures import ThreadPoolExecutor
 from typing import Any, Optional, Union, Sequence
 from loguru import logger
 
 from agentscope.agents.agent import AgentBase
+from agentscope.constants import DEFAULT_DEDUP_THRESHOLD, DEFAULT_TOP_K
 from agentscope.message import Msg
 from agentscope.rag import Knowledge
+from agentscope.rag.fusion import fuse_results
+from agentscope.rag.reranker import Reranker
 
 CHECKING_PROMPT = """
                 Is the retrieved content relevant to the query?
@@ -36,6 +40,10 @@ class LlamaIndexAgent(AgentBase):
         similarity_top_k: int = None,
         log_retrieval: bool = True,
         recent_n_mem_for_retrieve: int = 1,
+        fusion: Optional[str] = "rrf",
+        fusion_top_k: Optional[int] = None,
+        dedup_threshold: Optional[float] = DEFAULT_DEDUP_THRESHOLD,
+        reranker: Optional[Reranker] = None,
         **kwargs: Any,
     ) -> None:
         """
@@ -69,6 +77,21 @@ class LlamaIndexAgent(AgentBase):
             recent_n_mem_for_retrieve (int):
                 the number of pieces of memory used as part of
                 retrival query
+            fusion (Optional[str]):
+                how to merge the results of the knowledge, "rrf" for
+                reciprocal rank fusion, "score" to rank by the similarity
+                scores, or None to concatenate the results of each
+                knowledge without deduplication
+            fusion_top_k (Optional[int]):
+                the number of chunks kept after fusion, defaults to all
+            dedup_threshold (Optional[float]):
+                the Jaccard similarity of the words, above which two
+                retrieved chunks are merged as near-identical ones
+            reranker (Optional[Reranker]):
+                if given, the knowledge over-retrieves the candidates, which
+                are reranked after fusion, and the most relevant ones within
+                the top_n (defaults to fusion_top_k or similarity_top_k) and
+                the token budget of the reranker are kept
         """
         super().__init__(
             name=name,
@@ -80,6 +103,10 @@ class LlamaIndexAgent(AgentBase):
         self.similarity_top_k = similarity_top_k
         self.log_retrieval = log_retrieval
         self.recent_n_mem_for_retrieve = recent_n_mem_for_retrieve
+        self.fusion = fusion
+        self.fusion_top_k = fusion_top_k
+        self.dedup_threshold = dedup_threshold
+        self.reranker = reranker
         self.description = kwargs.get("description", "")
 
     def reply(self, x: Optional[Union[Msg, Sequence[Msg]]] = None) -> Msg:
@@ -124,26 +151,21 @@ class LlamaIndexAgent(AgentBase):
         if len(query) > 0:
             # when content has information, do retrieval
             scores = []
-            for knowledge in self.knowledge_list:
-                retrieved_nodes = knowledge.retrieve(
-                    str(query),
-                    self.similarity_top_k,
+            for node in self._retrieve(str(query)):
+                scores.append(node.score)
+                retrieved_docs_to_string += (
+                    "\n>>>> score:"
+                    + str(node.score)
+                    + "\n>>>> source:"
+                    + str(node.node.get_metadata_str())
+                    + "\n>>>> content:"
+                    + node.get_content()
                 )
-                for node in retrieved_nodes:
-                    scores.append(node.score)
-                    retrieved_docs_to_string += (
-                        "\n>>>> score:"
-                        + str(node.score)
-                        + "\n>>>> source:"
-                        + str(node.node.get_metadata_str())
-                        + "\n>>>> content:"
-                        + node.get_content()
-                    )
 
             if self.log_retrieval:
                 self.speak("[retrieved]:" + retrieved_docs_to_string)
 
-            if max(scores) < 0.4:
+            if max(scores, default=0.0) < 0.4:
                 # if the max score is lower than 0.4, then we let LLM
                 # decide whether the retrieved content is relevant
                 # to the user input.
@@ -192,3 +214,76 @@ class LlamaIndexAgent(AgentBase):
             self.memory.add(msg)
 
         return msg
+
+    def _retrieve(self, query: str) -> list:
+        """
+        Retrieve from all the knowledge concurrently. The query is embedded
+        once for the knowledge sharing an embedding model, and the results
+        are fused into one ranking with the near-identical chunks merged,
+        which is reranked if a reranker is given.
+
+        Args:
+            query (str): the query for retrieval.
+
+        Returns:
+            list: the retrieved nodes (NodeWithScore) in the fused order.
+        """
+        if len(self.knowledge_list) == 0:
+            return []
+
+        top_k = self.similarity_top_k
+        if self.reranker is not None:
+            top_k = self.reranker.n_candidates(top_k or DEFAULT_TOP_K)
+
+        # one knowledge per embedding model embeds the query
+        embedders = {}
+        for knowledge in self.knowledge_list:
+            key = getattr(knowledge, "query_embedding_key", None)
+            if key is not None:
+                embedders.setdefault(id(key), knowledge)
+
+        with ThreadPoolExecutor(
+            max_workers=len(self.knowledge_list),
+        ) as executor:
+            embeddings = dict(
+                zip(
+                    embedders.keys(),
+                    executor.map(
+                        lambda _: _.embed_query(query),
+                        embedders.values(),
+                    ),
+                ),
+            )
+
+            def retrieve(knowledge: Knowledge) -> list:
+                key = getattr(knowledge, "query_embedding_key", None)
+                return knowledge.retrieve(
+                    query,
+                    top_k,
+                    query_embedding=embeddings.get(id(key)),
+                )
+
+            ranked_lists = list(executor.map(retrieve, self.knowledge_list))
+
+        if self.fusion is None:
+            nodes = [node for ranked in ranked_lists for node in ranked]
+        else:
+            fused = fuse_results(
+                ranked_lists,
+                get_text=lambda _: _.get_content(),
+                get_score=lambda _: _.score,
+                method=self.fusion,
+                dedup_threshold=self.dedup_threshold,
+            )
+            nodes = [node for node, _ in fused]
+        if self.reranker is None:
+            return nodes[: self.fusion_top_k]
+        reranked, _ = self.reranker.rerank(
+            query,
+            nodes,
+            top_n=self.reranker.top_n
+            or self.fusion_top_k
+            or self.similarity_top_k
+            or DEFAULT_TOP_K,
+        )
+        return [node for node, _ in reranked]
@@ -161,7 +161,10 @@ class ReActAgent(AgentBase):
             )
 
             # Prepare prompt for the model
-            prompt = self.model.format(self.memory.get_memory(), hint_msg)
+            prompt = self.model.format(
+                self.get_prompt_memory(hint_msg),
+                hint_msg,
+            )
 
             # Generate and parse the response
             try:
@@ -254,7 +257,7 @@ class ReActAgent(AgentBase):
         )
 
         # Generate a reply by summarizing the current situation
-        prompt = self.model.format(self.memory.get_memory(), hint_msg)
+        prompt = self.model.format(self.get_prompt_memory(hint_msg), hint_msg)
         res = self.model(prompt)
         res_msg = Msg(self.name, res.text, "assistant")
         self.speak(res_msg)
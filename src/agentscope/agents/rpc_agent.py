@@ -1,6 +1,10 @@
 # -*- coding: utf-8 -*-
 """ Base class for Rpc Agent """
-from typing import Type, Optional, Union, Sequence
+import json
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from contextlib import contextmanager
+from typing import Type, Optional, Union, Sequence, Generator
 
 from agentscope.agents.agent import AgentBase
 from agentscope.message import (
@@ -10,8 +14,12 @@ from agentscope.message import (
 )
 from agentscope.rpc import RpcAgentClient
 from agentscope.server.launcher import RpcAgentServerLauncher
+from agentscope.server.server_pool import get_server_pool
 from agentscope.studio._client import _studio_client
 
+# The agents whose creation is deferred by `RpcAgent.create_in_batch`
+_deferred_creation = threading.local()
+
 
 class RpcAgent(AgentBase):
     """A wrapper to extend an AgentBase into a gRPC Client."""
@@ -64,6 +72,7 @@ class RpcAgent(AgentBase):
         self.host = host
         self.port = port
         self.server_launcher = None
+        self.server_pool = None
         self.client = None
         self.connect_existing = connect_existing
         if agent_id is not None:
@@ -75,15 +84,21 @@ class RpcAgent(AgentBase):
             studio_url = None
             if _studio_client.active:
                 studio_url = _studio_client.studio_url
-            self.server_launcher = RpcAgentServerLauncher(
-                host=self.host,
-                port=port,
-                max_pool_size=max_pool_size,
-                max_timeout_seconds=max_timeout_seconds,
-                local_mode=local_mode,
-                custom_agents=[agent_class],
-                studio_url=studio_url,
-            )
+            self.launcher_configs = {
+                "host": self.host,
+                "max_pool_size": max_pool_size,
+                "max_timeout_seconds": max_timeout_seconds,
+                "local_mode": local_mode,
+                "custom_agents": [agent_class],
+                "studio_url": studio_url,
+            }
+            # place the agent on a shared server of the pool if enabled
+            self.server_pool = get_server_pool()
+            if self.server_pool is None:
+                self.server_launcher = RpcAgentServerLauncher(
+                    port=port,
+                    **self.launcher_configs,
+                )
             if not lazy_launch:
                 self._launch_server()
         else:
@@ -93,18 +108,31 @@ class RpcAgent(AgentBase):
                 agent_id=self.agent_id,
             )
             if not self.connect_existing:
-                self.client.create_agent(agent_configs)
+                deferred = getattr(_deferred_creation, "agents", None)
+                if deferred is None:
+                    self.client.create_agent(agent_configs)
+                else:
+                    deferred.append(self)
 
     def _launch_server(self) -> None:
-        """Launch a rpc server and update the port and the client"""
-        self.server_launcher.launch()
+        """Launch a rpc server (or place the agent on a shared server of the
+        pool) and update the port and the client"""
+        agent_configs = self.agent_configs
+        if self.server_pool is not None:
+            self.server_launcher = self.server_pool.acquire(
+                **self.launcher_configs,
+            )
+            # The shared server may be launched for another agent class
+            agent_configs = {**agent_configs, "agent_class": self.agent_class}
+        else:
+            self.server_launcher.launch()
         self.port = self.server_launcher.port
         self.client = RpcAgentClient(
             host=self.host,
             port=self.port,
             agent_id=self.agent_id,
         )
-        self.client.create_agent(self.agent_configs)
+        self.client.create_agent(agent_configs)
 
     def reply(self, x: Optional[Union[Msg, Sequence[Msg]]] = None) -> Msg:
         if self.client is None:
@@ -124,6 +152,50 @@ class RpcAgent(AgentBase):
             value=serialize(x),  # type: ignore[arg-type]
         )
 
+    @classmethod
+    def observe_all(
+        cls,
+        agents: Sequence[AgentBase],
+        x: Union[dict, Sequence[dict]],
+    ) -> None:
+        """Let the agents observe the same input with a single request to
+        each agent server, and the servers are requested concurrently."""
+        servers: dict = {}
+        for agent in agents:
+            if agent.client is None:
+                agent._launch_server()  # pylint: disable=protected-access
+            servers.setdefault((agent.host, agent.port), []).append(agent)
+
+        value = serialize(x)  # type: ignore[arg-type]
+
+        def _observe(server_agents: list) -> None:
+            if len(server_agents) == 1:
+                server_agents[0].observe(x)
+                return
+            RpcAgentClient(
+                host=server_agents[0].host,
+                port=server_agents[0].port,
+                agent_id=server_agents[0].agent_id,
+            ).call_func(
+                func_name="_observe_batch",
+                value=json.dumps(
+                    {
+                        "agent_ids": [_.agent_id for _ in server_agents],
+                        "value": value,
+                    },
+                ),
+            )
+
+        if len(servers) == 1:
+            _observe(list(servers.values())[0])
+            return
+
+        with ThreadPoolExecutor(max_workers=len(servers)) as executor:
+            for future in [
+                executor.submit(_observe, _) for _ in servers.values()
+            ]:
+                future.result()
+
     def clone_instances(
         self,
         num_instances: int,
@@ -155,9 +227,17 @@ class RpcAgent(AgentBase):
         if including_self:
             generated_instances.append(self)
 
-        # clone instances without agent server
-        for _ in range(generated_instance_number):
-            new_agent_id = self.client.call_func("_clone_agent")
+        if generated_instance_number <= 0:
+            return generated_instances
+
+        # clone instances without agent server in one request
+        new_agent_ids = json.loads(
+            self.client.call_func(
+                "_clone_agent",
+                json.dumps({"num_instances": generated_instance_number}),
+            ),
+        )
+        for new_agent_id in new_agent_ids:
             generated_instances.append(
                 RpcAgent(
                     name=self.name,
@@ -169,9 +249,100 @@ class RpcAgent(AgentBase):
             )
         return generated_instances
 
+    @classmethod
+    @contextmanager
+    def create_in_batch(
+        cls,
+        batch_size: int = 1000,
+        max_workers: Optional[int] = None,
+    ) -> Generator[None, None, None]:
+        """Defer creating the agents converted to connect to existing agent
+        servers within the context, and create them in bulk when the
+        context exits by `create_all`.
+
+        Example:
+
+        .. code-block:: python
+
+            with RpcAgent.create_in_batch():
+                agents = [
+                    MyAgent(name=f"a{i}").to_dist(host=host, port=port)
+                    for i in range(10000)
+                ]
+
+        Args:
+            batch_size (`int`, defaults to `1000`):
+                The maximum number of agents created in one request.
+            max_workers (`Optional[int]`, defaults to `None`):
+                The maximum number of concurrent requests.
+        """
+        outer = getattr(_deferred_creation, "agents", None)
+        _deferred_creation.agents = []
+        try:
+            yield
+            agents = _deferred_creation.agents
+        finally:
+            _deferred_creation.agents = outer
+        cls.create_all(agents, batch_size=batch_size, max_workers=max_workers)
+
+    @classmethod
+    def create_all(
+        cls,
+        agents: Sequence[AgentBase],
+        batch_size: int = 1000,
+        max_workers: Optional[int] = None,
+    ) -> None:
+        """Create the agents in their agent servers with a request per
+        `batch_size` agents, and the requests are sent concurrently.
+
+        Args:
+            agents (`Sequence[AgentBase]`):
+                The agents connected to existing agent servers.
+            batch_size (`int`, defaults to `1000`):
+                The maximum number of agents created in one request.
+            max_workers (`Optional[int]`, defaults to `None`):
+                The maximum number of concurrent requests.
+        """
+        servers: dict = {}
+        for agent in agents:
+            servers.setdefault((agent.host, agent.port), {})[
+                agent.agent_id
+            ] = agent.agent_configs
+
+        batches = []
+        for (host, port), agent_configs in servers.items():
+            agent_ids = list(agent_configs)
+            for i in range(0, len(agent_ids), batch_size):
+                batches.append(
+                    (
+                        RpcAgentClient(host=host, port=port),
+                        {
+                            _: agent_configs[_]
+                            for _ in agent_ids[i : i + batch_size]
+                        },
+                    ),
+                )
+        if len(batches) == 0:
+            return
+
+        workers = min(max_workers or len(batches), len(batches))
+        with ThreadPoolExecutor(max_workers=workers) as executor:
+            for future in [
+                executor.submit(client.create_agents, configs)
+                for client, configs in batches
+            ]:
+                future.result()
+
     def stop(self) -> None:
-        """Stop the RpcAgent and the rpc server."""
-        if self.server_launcher is not None:
+        """Stop the RpcAgent and the rpc server, or release the agent from
+        the shared server."""
+        if self.server_launcher is None:
+            return
+        if self.server_pool is not None:
+            launcher, self.server_launcher = self.server_launcher, None
+            self.client.delete_agent()
+            self.server_pool.release(launcher)
+        else:
             self.server_launcher.shutdown()
 
     def __del__(self) -> None:
@@ -25,6 +25,20 @@ _DEFAULT_MAX_RETRIES = 3
 _DEFAULT_MESSAGES_KEY = "inputs"
 _DEFAULT_RETRY_INTERVAL = 1
 _DEFAULT_API_BUDGET = None
+# for http session
+_DEFAULT_HTTP_POOL_CONNECTIONS = 10
+_DEFAULT_HTTP_POOL_MAXSIZE = 10
+# for sql query
+_DEFAULT_SQL_POOL_SIZE = 4
+_DEFAULT_SQL_PAGE_SIZE = 500
+_DEFAULT_SQL_MAX_BYTES = 65536
+# for agent server, the seconds to wait for a forked server to start
+_DEFAULT_SERVER_LAUNCH_TIMEOUT = 60
+# for msghub, the maximum number of threads observing a broadcast message
+_DEFAULT_BROADCAST_MAX_WORKERS = 16
+# for web digest, the size and the age limits of the web page cache
+_DEFAULT_WEB_CACHE_MAX_BYTES = 256 * 1024 * 1024
+_DEFAULT_WEB_CACHE_MAX_AGE = 7 * 24 * 3600
 # for execute python
 _DEFAULT_PYPI_MIRROR = "http://mirrors.aliyun.com/pypi/simple/"
 _DEFAULT_TRUSTED_HOST = "mirrors.aliyun.com"
@@ -41,6 +55,11 @@ You need to keep all the key information of the text in the summary.
 _DEFAULT_TOKEN_LIMIT_PROMPT = """
 Summarize the text after TEXT in less than {} tokens:
 """
+_DEFAULT_MERGE_SUMMARY_PROMPT = """
+The text consists of the summaries of consecutive parts of a long document.
+Merge them into one summary of the whole document.
+"""
+_DEFAULT_SUMMARY_CACHE_SIZE = 4096
 
 # typing
 Embedding = list[Number]
@@ -65,3 +84,15 @@ class ShrinkPolicy(IntEnum):
 DEFAULT_CHUNK_SIZE = 1024
 DEFAULT_CHUNK_OVERLAP = 20
 DEFAULT_TOP_K = 5
+DEFAULT_EMBED_CONCURRENCY = 4
+# the minimum number of files or documents for each process when loading
+# and splitting them in parallel
+DEFAULT_DOCS_PER_WORKER = 64
+DEFAULT_RRF_K = 60
+DEFAULT_DEDUP_THRESHOLD = 0.9
+# the number of (query, chunk) pairs scored in one call of a reranker
+DEFAULT_RERANK_BATCH_SIZE = 32
+DEFAULT_RERANK_CACHE_SIZE = 4096
+# the number of candidates retrieved for reranking, as a multiple of the
+# number of chunks kept
+DEFAULT_RERANK_OVER_RETRIEVE = 4
@@ -23,6 +23,28 @@ class ResponseParsingError(Exception):
 class JsonParsingError(ResponseParsingError):
     """The exception class for JSON parsing error."""
 
+    truncated: bool
+    """If the JSON text is truncated, e.g. it ends inside a string."""
+
+    def __init__(
+        self,
+        message: str,
+        raw_response: str = None,
+        truncated: bool = False,
+    ) -> None:
+        """Initialize the exception with the message.
+
+        Args:
+            raw_response (`str`):
+                Record the raw response from the model.
+            truncated (`bool`, defaults to `False`):
+                If the JSON text is truncated, which can be fixed by asking
+                the model to continue rather than to regenerate.
+        """
+        super().__init__(message, raw_response)
+
+        self.truncated = truncated
+
 
 class JsonDictValidationError(ResponseParsingError):
     """The exception class for JSON dict validation error."""
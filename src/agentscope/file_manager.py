@@ -247,6 +247,51 @@ class _FileManager:
         except FileNotFoundError:
             return None
 
+    def _get_embedding_matrix_path(
+        self,
+        texts: List[str],
+        embedding_model: Union[str, dict],
+    ) -> str:
+        """Get the cache path of the embedding matrix of the texts."""
+        record_hash = _get_text_embedding_record_hash(
+            json.dumps(texts, ensure_ascii=False),
+            embedding_model,
+            self.hash_method,
+        )
+        return os.path.join(
+            self.dir_cache_embedding,
+            f"matrix_{record_hash}.npy",
+        )
+
+    def cache_embedding_matrix(
+        self,
+        texts: List[str],
+        matrix: np.ndarray,
+        embedding_model: Union[str, dict],
+    ) -> None:
+        """Cache the embeddings of a list of texts as a single float32
+        matrix, so that they can be loaded at once by other processes."""
+        path = self._get_embedding_matrix_path(texts, embedding_model)
+
+        # Write into a temporary file first, since the cache directory may be
+        # read by other processes at the same time
+        tmp_path = f"{path}.{os.getpid()}.tmp"
+        with open(tmp_path, "wb") as file:
+            np.save(file, np.asarray(matrix, dtype=np.float32))
+        os.replace(tmp_path, path)
+
+    def fetch_cached_embedding_matrix(
+        self,
+        texts: List[str],
+        embedding_model: Union[str, dict],
+    ) -> Optional[np.ndarray]:
+        """Fetch the embedding matrix of a list of texts from the cache."""
+        path = self._get_embedding_matrix_path(texts, embedding_model)
+        try:
+            return np.load(path)
+        except FileNotFoundError:
+            return None
+
     @staticmethod
     def _flush() -> None:
         """
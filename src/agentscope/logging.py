@@ -220,6 +220,23 @@ def _level_format(record: dict) -> str:
         )
 
 
+def add_console_sink(level: LOG_LEVEL = "INFO") -> None:
+    """Add the standard output sink for all logging except chat.
+
+    Args:
+        level (`str`, defaults to `"INFO"`):
+            The logging level.
+    """
+    logger.add(
+        sys.stdout,
+        filter=lambda record: record["level"].name
+        not in [LEVEL_SAVE_LOG, LEVEL_SAVE_MSG],
+        format=_level_format,
+        enqueue=True,
+        level=level,
+    )
+
+
 def setup_logger(
     path_log: Optional[str] = None,
     level: LOG_LEVEL = "INFO",
@@ -246,15 +263,7 @@ def setup_logger(
 
         # set logging level
         logger.remove()
-        # standard output for all logging except chat
-        logger.add(
-            sys.stdout,
-            filter=lambda record: record["level"].name
-            not in [LEVEL_SAVE_LOG, LEVEL_SAVE_MSG],
-            format=_level_format,
-            enqueue=True,
-            level=level,
-        )
+        add_console_sink(level)
 
     if path_log is not None:
         os.makedirs(path_log, exist_ok=True)
@@ -6,8 +6,10 @@ import al memory related modules
 
 from .memory import MemoryBase
 from .temporary_memory import TemporaryMemory
+from .prompt_budget import PromptBudget
 
 __all__ = [
     "MemoryBase",
     "TemporaryMemory",
+    "PromptBudget",
 ]
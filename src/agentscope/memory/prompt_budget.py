@@ -0,0 +1,311 @@
+# -*- coding: utf-8 -*-
+"""Select the messages from memory within a token budget, so that the cost
+of the prompt stays bounded for arbitrarily long conversations."""
+import hashlib
+from typing import Literal, Optional, Sequence, Union, Any, List
+
+from loguru import logger
+
+from ..message import Msg
+from ..models import (
+    ModelWrapperBase,
+    EmbeddingBatcher,
+    load_model_by_config_name,
+)
+from ..utils.token_utils import count_msg_tokens
+from ..utils.tools import _convert_to_str
+
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
+_DEFAULT_SUMMARY_TOKENS = 256
+
+_SUMMARIZE_PROMPT = (
+    "Summarize the following conversation in less than {} tokens, and keep "
+    "all the key information, e.g. facts, decisions and unfinished tasks. "
+    "The summary of the earlier conversation (if any) is given first."
+)
+
+
+class PromptBudget:
+    """Select the messages from memory that fit in a token budget.
+
+    The leading system messages in the memory (e.g. the system prompt of
+    `ReActAgent`) are always kept, and the others are selected by one of
+    the following strategies:
+
+        - `"recency"`: keep the most recent messages.
+        - `"retrieval"`: keep the latest message and the messages most
+          relevant to it, ranked by the similarity of their embeddings.
+        - `"summarize"`: keep the most recent messages, and replace the
+          dropped ones with a summary, which is updated incrementally as more
+          messages are dropped.
+
+    The selected messages are always returned in their original order.
+
+    Example:
+
+        .. code-block:: python
+
+            budget = PromptBudget(max_tokens=4000, model=agent.model)
+            prompt = agent.model.format(
+                sys_msg,
+                budget.select(agent.memory.get_memory(), reserved=[sys_msg]),
+            )
+    """
+
+    def __init__(
+        self,
+        max_tokens: int,
+        model: Optional[ModelWrapperBase] = None,
+        strategy: Literal["recency", "retrieval", "summarize"] = "recency",
+        embedding_model: Optional[ModelWrapperBase] = None,
+        max_summary_tokens: int = _DEFAULT_SUMMARY_TOKENS,
+    ) -> None:
+        """Initialize the prompt budget.
+
+        Args:
+            max_tokens (`int`):
+                The maximum number of tokens of the selected messages and
+                the reserved ones.
+            model (`Optional[ModelWrapperBase]`, defaults to `None`):
+                The model the prompt is built for. Its model name is used to
+                count the tokens, and it summarizes the dropped messages in
+                the `"summarize"` strategy.
+            strategy (`Literal["recency", "retrieval", "summarize"]`, \
+            defaults to `"recency"`):
+                The strategy to select the messages.
+            embedding_model (`Optional[ModelWrapperBase]`, defaults to \
+            `None`):
+                The embedding model used in the `"retrieval"` strategy.
+            max_summary_tokens (`int`, defaults to `256`):
+                The tokens reserved for the summary in the `"summarize"`
+                strategy.
+        """
+        if strategy not in ["recency", "retrieval", "summarize"]:
+            raise ValueError(f"Unsupported strategy [{strategy}].")
+        if strategy == "retrieval" and embedding_model is None:
+            raise ValueError(
+                "The embedding model is required by the retrieval strategy.",
+            )
+        if strategy == "summarize" and model is None:
+            raise ValueError(
+                "The model is required by the summarize strategy.",
+            )
+
+        self.max_tokens = max_tokens
+        self.model = model
+        self.model_name = getattr(model, "model_name", None)
+        self.strategy = strategy
+        self.embedding_model = (
+            EmbeddingBatcher.get_batcher(embedding_model)
+            if embedding_model is not None
+            else None
+        )
+        self.max_summary_tokens = max_summary_tokens
+
+        self._summary: Optional[str] = None
+        self._summarized_ids: set = set()
+        # The embeddings of the messages in the `"retrieval"` strategy,
+        # keyed by the id and the content of the messages
+        self._embeddings: dict = {}
+
+    @classmethod
+    def from_model(
+        cls,
+        model: ModelWrapperBase,
+    ) -> Optional["PromptBudget"]:
+        """Create the prompt budget according to the `prompt_budget` field
+        in the model configuration, e.g.
+        `{"max_tokens": 4000, "strategy": "summarize"}`. The embedding model
+        of the `"retrieval"` strategy is given by its config name, e.g.
+        `{"max_tokens": 4000, "strategy": "retrieval",
+        "embedding_model_config_name": "my_embedding_config"}`. Return
+        `None` if the field is not set."""
+        config = getattr(model, "prompt_budget", None)
+        if isinstance(config, int):
+            config = {"max_tokens": config}
+        if not isinstance(config, dict):
+            return None
+        config = dict(config)
+        embedding_config_name = config.pop(
+            "embedding_model_config_name",
+            None,
+        )
+        if embedding_config_name is not None:
+            config["embedding_model"] = load_model_by_config_name(
+                embedding_config_name,
+            )
+        return cls(model=model, **config)
+
+    def count(self, msgs: Sequence[Any]) -> int:
+        """Count the tokens of the messages."""
+        return sum(count_msg_tokens(_, self.model_name) for _ in msgs)
+
+    def select(
+        self,
+        memory: Sequence[Msg],
+        reserved: Optional[Sequence[Union[Msg, str, None]]] = None,
+    ) -> List[Msg]:
+        """Select the messages within the budget.
+
+        Args:
+            memory (`Sequence[Msg]`):
+                The messages in memory, in chronological order.
+            reserved (`Optional[Sequence[Union[Msg, str, None]]]`, \
+            defaults to `None`):
+                The other parts of the prompt (e.g. the system prompt and
+                the format instruction), whose tokens are deducted from the
+                budget first.
+
+        Returns:
+            `List[Msg]`: The selected messages in chronological order.
+        """
+        memory = list(memory)
+        remaining = self.max_tokens - self.count(
+            [_ for _ in reserved or [] if _ is not None],
+        )
+
+        # Keep the leading system messages
+        n_pinned = 0
+        while n_pinned < len(memory) and memory[n_pinned].role == "system":
+            n_pinned += 1
+        pinned, candidates = memory[:n_pinned], memory[n_pinned:]
+        remaining -= self.count(pinned)
+
+        if self.count(candidates) <= remaining:
+            return memory
+
+        if self.strategy == "retrieval":
+            selected = self._select_by_relevance(candidates, remaining)
+            return pinned + selected
+
+        if self.strategy == "summarize":
+            remaining -= self.max_summary_tokens
+
+        selected = self._select_by_recency(candidates, remaining)
+
+        if self.strategy == "summarize":
+            dropped = candidates[: len(candidates) - len(selected)]
+            summary = self._summarize(dropped)
+            if summary is not None:
+                return pinned + [summary] + selected
+
+        return pinned + selected
+
+    def _select_by_recency(
+        self,
+        candidates: List[Msg],
+        remaining: int,
+    ) -> List[Msg]:
+        """Select the most recent messages, while the latest one is always
+        kept."""
+        n_selected = 0
+        for msg in reversed(candidates):
+            n_tokens = count_msg_tokens(msg, self.model_name)
+            if n_tokens > remaining and n_selected > 0:
+                break
+            remaining -= n_tokens
+            n_selected += 1
+
+        if remaining < 0:
+            logger.warning(
+                "The latest message exceeds the prompt budget by "
+                f"{-remaining} tokens.",
+            )
+        return candidates[len(candidates) - n_selected :]  # noqa: E203
+
+    def _select_by_relevance(
+        self,
+        candidates: List[Msg],
+        remaining: int,
+    ) -> List[Msg]:
+        """Select the latest message and the messages most relevant to it."""
+        latest, others = candidates[-1], candidates[:-1]
+        remaining -= count_msg_tokens(latest, self.model_name)
+        if len(others) == 0:
+            return [latest]
+
+        keys = [_embedding_key(_) for _ in candidates]
+        # Only keep the embeddings of the messages still in memory
+        self._embeddings = {
+            key: self._embeddings[key]
+            for key in keys
+            if key in self._embeddings
+        }
+
+        # Embed the messages without embeddings in one batch
+        to_embed = []
+        for key, msg in zip(keys, candidates):
+            if key in self._embeddings:
+                continue
+            if msg.get("embedding") is not None:
+                self._embeddings[key] = msg.embedding
+            else:
+                to_embed.append((key, msg))
+        if len(to_embed) > 0:
+            embeddings = self.embedding_model(
+                [_convert_to_str(msg.content) for _, msg in to_embed],
+            ).embedding
+            for (key, _), embedding in zip(to_embed, embeddings):
+                self._embeddings[key] = list(embedding)
+
+        matrix = np.array(
+            [self._embeddings[_] for _ in keys[:-1]],
+            dtype=np.float32,
+        )
+        query = np.array(self._embeddings[keys[-1]], dtype=np.float32)
+        norms = np.linalg.norm(matrix, axis=1) * np.linalg.norm(query)
+        scores = matrix @ query / (norms + 1e-8)
+
+        selected_indices = []
+        for index in np.argsort(-scores):
+            n_tokens = count_msg_tokens(others[index], self.model_name)
+            if n_tokens <= remaining:
+                remaining -= n_tokens
+                selected_indices.append(int(index))
+
+        return [others[_] for _ in sorted(selected_indices)] + [latest]
+
+    def _summarize(self, dropped: List[Msg]) -> Optional[Msg]:
+        """Summarize the dropped messages incrementally."""
+        new_msgs = [_ for _ in dropped if _.id not in self._summarized_ids]
+
+        if len(new_msgs) > 0:
+            history = "\n".join(
+                f"{_.name}: {_convert_to_str(_.content)}" for _ in new_msgs
+            )
+            if self._summary is not None:
+                history = f"Summary: {self._summary}\n{history}"
+
+            prompt = self.model.format(
+                Msg(
+                    "system",
+                    _SUMMARIZE_PROMPT.format(self.max_summary_tokens),
+                    role="system",
+                ),
+                Msg("user", history, role="user"),
+            )
+            try:
+                self._summary = self.model(prompt).text
+                self._summarized_ids.update(_.id for _ in new_msgs)
+            except Exception as e:
+                logger.warning(f"Fail to summarize the dropped messages: {e}")
+
+        if self._summary is None:
+            return None
+
+        return Msg(
+            "system",
+            f"Summary of the earlier conversation: {self._summary}",
+            role="system",
+        )
+
+
+def _embedding_key(msg: Msg) -> tuple:
+    """The key of the cached embedding of a message, which changes with the
+    content of the message."""
+    content = _convert_to_str(msg.content).encode("utf-8")
+    return msg.id, hashlib.sha1(content).hexdigest()
@@ -40,6 +40,7 @@ from .zhipu_model import (
 from .litellm_model import (
     LiteLLMChatWrapper,
 )
+from .embedding_batcher import EmbeddingBatcher
 
 
 __all__ = [
@@ -63,6 +64,7 @@ __all__ = [
     "ZhipuAIChatWrapper",
     "ZhipuAIEmbeddingWrapper",
     "LiteLLMChatWrapper",
+    "EmbeddingBatcher",
     "load_model_by_config_name",
     "load_config_by_name",
     "read_model_configs",
@@ -120,7 +122,13 @@ def load_model_by_config_name(config_name: str) -> ModelWrapperBase:
 
     kwargs = {k: v for k, v in config.items() if k != "model_type"}
 
-    return _get_model_wrapper(model_type=model_type)(**kwargs)
+    # The prompt budget is used by agents rather than the model API
+    prompt_budget = kwargs.pop("prompt_budget", None)
+
+    model = _get_model_wrapper(model_type=model_type)(**kwargs)
+    if prompt_budget is not None:
+        model.prompt_budget = prompt_budget
+    return model
 
 
 def clear_model_configs() -> None:
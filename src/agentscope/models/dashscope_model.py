@@ -421,6 +421,9 @@ class DashScopeTextEmbeddingWrapper(DashScopeWrapperBase):
 
     model_type: str = "dashscope_text_embedding"
 
+    max_batch_size: int = 25
+    """The maximum number of texts in one embedding request."""
+
     def _register_default_metrics(self) -> None:
         # Set monitor accordingly
         # TODO: set quota to the following metrics
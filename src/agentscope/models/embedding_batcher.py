@@ -0,0 +1,262 @@
+# -*- coding: utf-8 -*-
+"""A coalescing layer that gathers concurrent embedding requests into
+provider-sized batches."""
+import queue
+import threading
+import time
+from concurrent.futures import Future, ThreadPoolExecutor
+from typing import Any, Union, List, Sequence, Optional
+
+from loguru import logger
+
+from .model import ModelWrapperBase
+from .response import ModelResponse
+from ..message import Msg
+
+_DEFAULT_MAX_WAIT = 0.01
+_DEFAULT_MAX_CONCURRENCY = 4
+
+_BATCHERS: dict[str, "EmbeddingBatcher"] = {}
+_BATCHERS_LOCK = threading.Lock()
+
+
+class _EmbeddingRequest:
+    """The embedding request issued by a single caller, which is filled by
+    one or more batches."""
+
+    def __init__(self, n_texts: int) -> None:
+        self.future = Future()
+        self.embeddings: List[Any] = [None] * n_texts
+        self.remaining = n_texts
+        self.lock = threading.Lock()
+
+    def fill(self, index: int, embedding: Any) -> None:
+        """Fill the embedding of the `index`-th text, and resolve the future
+        once all the texts are embedded."""
+        with self.lock:
+            self.embeddings[index] = embedding
+            self.remaining -= 1
+            done = self.remaining == 0
+        if done and not self.future.done():
+            self.future.set_result(self.embeddings)
+
+    def fail(self, error: BaseException) -> None:
+        """Fail the request with the given error."""
+        with self.lock:
+            if not self.future.done():
+                self.future.set_exception(error)
+
+
+class EmbeddingBatcher(ModelWrapperBase):
+    """Wrap an embedding model wrapper so that the texts from concurrent
+    callers (e.g. many agents, or the threads of a RAG ingestion pipeline)
+    are gathered within a small time window, sent to the provider in batches
+    no larger than its limit, and the embeddings are scattered back to the
+    callers in their original order.
+
+    Example:
+
+        .. code-block:: python
+
+            emb_model = load_model_by_config_name("my_embedding_config")
+            emb_model = EmbeddingBatcher.get_batcher(emb_model)
+
+            # Used exactly like the wrapped model
+            emb_model(["text1", "text2"]).embedding
+    """
+
+    def __init__(
+        self,
+        model: ModelWrapperBase,
+        max_batch_size: Optional[int] = None,
+        max_wait: float = _DEFAULT_MAX_WAIT,
+        max_concurrency: int = _DEFAULT_MAX_CONCURRENCY,
+    ) -> None:
+        """Initialize the embedding batcher.
+
+        Args:
+            model (`ModelWrapperBase`):
+                The embedding model wrapper to be called in batches.
+            max_batch_size (`Optional[int]`, defaults to `None`):
+                The maximum number of texts in one provider request. If not
+                given, the `max_batch_size` attribute of the wrapped model is
+                used.
+            max_wait (`float`, defaults to `0.01`):
+                The time window (in seconds) to wait for more texts after the
+                first text of a batch arrives.
+            max_concurrency (`int`, defaults to `4`):
+                The maximum number of batches in flight at the same time.
+        """
+        super().__init__(
+            config_name=getattr(model, "config_name", type(model).__name__),
+        )
+
+        self.model = model
+        if hasattr(model, "model_name"):
+            self.model_name = model.model_name
+        self.max_batch_size = max(
+            1,
+            max_batch_size or getattr(model, "max_batch_size", 1),
+        )
+        self.max_wait = max_wait
+
+        self._queue: queue.Queue = queue.Queue()
+        self._executor = ThreadPoolExecutor(
+            max_workers=max_concurrency,
+            thread_name_prefix="embedding_batcher",
+        )
+        self._worker: Optional[threading.Thread] = None
+        self._worker_lock = threading.Lock()
+
+    @classmethod
+    def get_batcher(
+        cls,
+        model: ModelWrapperBase,
+        **kwargs: Any,
+    ) -> "EmbeddingBatcher":
+        """Get the batcher shared by all model wrappers with the same
+        config name, so that requests from different agents are coalesced
+        together.
+
+        Args:
+            model (`ModelWrapperBase`):
+                The embedding model wrapper.
+            **kwargs (`Any`):
+                The arguments to initialize the batcher if it doesn't exist.
+
+        Returns:
+            `EmbeddingBatcher`: The shared embedding batcher.
+        """
+        if isinstance(model, EmbeddingBatcher):
+            return model
+
+        key = getattr(model, "config_name", type(model).__name__)
+        with _BATCHERS_LOCK:
+            if key not in _BATCHERS:
+                _BATCHERS[key] = cls(model, **kwargs)
+            return _BATCHERS[key]
+
+    def __call__(
+        self,
+        texts: Union[List[str], str],
+        **kwargs: Any,
+    ) -> ModelResponse:
+        """Embed the texts, blocking until all of them are embedded.
+
+        Args:
+            texts (`Union[List[str], str]`):
+                The texts to be embedded.
+            **kwargs (`Any`):
+                The keyword arguments to the wrapped model. Requests with
+                extra arguments cannot be merged with others, so they are
+                forwarded to the wrapped model directly.
+
+        Returns:
+            `ModelResponse`:
+                A list of embeddings in embedding field, in the same order
+                as the input texts.
+        """
+        if len(kwargs) > 0:
+            return self.model(texts, **kwargs)
+
+        if isinstance(texts, str):
+            texts = [texts]
+
+        if len(texts) == 0:
+            return ModelResponse(embedding=[])
+
+        request = _EmbeddingRequest(len(texts))
+
+        self._ensure_worker()
+        for index, text in enumerate(texts):
+            self._queue.put((text, request, index))
+
+        return ModelResponse(embedding=request.future.result())
+
+    def _ensure_worker(self) -> None:
+        """Start the background thread collecting the batches."""
+        if self._worker is not None and self._worker.is_alive():
+            return
+        with self._worker_lock:
+            if self._worker is None or not self._worker.is_alive():
+                self._worker = threading.Thread(
+                    target=self._collect,
+                    name=f"embedding_batcher_{self.config_name}",
+                    daemon=True,
+                )
+                self._worker.start()
+
+    def _collect(self) -> None:
+        """Collect the queued texts into batches and dispatch them."""
+        while True:
+            item = self._queue.get()
+            if item is None:
+                return
+
+            batch = [item]
+            deadline = time.monotonic() + self.max_wait
+            closed = False
+            while len(batch) < self.max_batch_size:
+                timeout = deadline - time.monotonic()
+                try:
+                    if timeout > 0:
+                        item = self._queue.get(timeout=timeout)
+                    else:
+                        # Take the texts that are already queued
+                        item = self._queue.get_nowait()
+                except queue.Empty:
+                    break
+                if item is None:
+                    closed = True
+                    break
+                batch.append(item)
+
+            self._executor.submit(self._dispatch, batch)
+
+            if closed:
+                return
+
+    def _dispatch(self, batch: list) -> None:
+        """Call the wrapped model with one batch and scatter the
+        embeddings."""
+        texts = [text for text, _, _ in batch]
+        try:
+            if self.max_batch_size == 1:
+                # The wrapped model may only accept a single text
+                embeddings = self.model(texts[0]).embedding
+            else:
+                embeddings = self.model(texts).embedding
+
+            if len(embeddings) != len(texts):
+                raise RuntimeError(
+                    f"Expect {len(texts)} embeddings from model "
+                    f"[{self.config_name}], but got {len(embeddings)}.",
+                )
+        except Exception as e:
+            logger.error(
+                f"Fail to embed a batch of {len(texts)} texts with model "
+                f"[{self.config_name}]: {e}",
+            )
+            for _, request, _ in batch:
+                request.fail(e)
+            return
+
+        for (_, request, index), embedding in zip(batch, embeddings):
+            request.fill(index, embedding)
+
+    def close(self) -> None:
+        """Flush the queued texts and stop the batcher."""
+        self._queue.put(None)
+        if self._worker is not None:
+            self._worker.join()
+        self._executor.shutdown(wait=True)
+
+    def format(
+        self,
+        *args: Union[Msg, Sequence[Msg]],
+    ) -> Union[List[dict], str]:
+        raise RuntimeError(
+            f"Model Wrapper [{type(self).__name__}] doesn't "
+            f"need to format the input. Please try to use the "
+            f"model wrapper directly.",
+        )
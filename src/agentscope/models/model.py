@@ -58,23 +58,68 @@ import inspect
 import time
 from abc import ABCMeta
 from functools import wraps
-from typing import Sequence, Any, Callable, Union, List, Type
+from typing import Sequence, Any, Callable, Union, List, Type, Optional
 
 from loguru import logger
 
 from agentscope.utils import QuotaExceededError
 from .response import ModelResponse
-from ..exception import ResponseParsingError
+from ..exception import ResponseParsingError, TagNotFoundError
 
 from ..file_manager import file_manager
 from ..message import Msg
 from ..utils import MonitorFactory
-from ..utils.monitor import get_full_name
+from ..utils.monitor import get_full_name, record_parse_tier
 from ..utils.tools import _get_timestamp
 from ..constants import _DEFAULT_MAX_RETRIES
 from ..constants import _DEFAULT_RETRY_INTERVAL
 
 
+_CONTINUATION_PROMPT = (
+    "Your previous response was cut off. Continue it exactly from where it "
+    "stopped, without repeating any of it."
+)
+
+
+def _is_truncated(error: ResponseParsingError) -> bool:
+    """Check if the parsing error is caused by a truncated response."""
+    if isinstance(error, TagNotFoundError):
+        return error.missing_end_tag and not error.missing_begin_tag
+    return getattr(error, "truncated", False)
+
+
+def _is_chat_messages(messages: Any) -> bool:
+    """Check if the argument is a list of chat messages with roles and
+    contents."""
+    return (
+        isinstance(messages, list)
+        and len(messages) > 0
+        and all(
+            isinstance(_, dict) and "role" in _ and "content" in _
+            for _ in messages
+        )
+    )
+
+
+def _get_continuation_args(
+    args: tuple,
+    kwargs: dict,
+    partial_text: str,
+) -> Optional[tuple]:
+    """Append the truncated response and a continuation request to the chat
+    messages in the arguments of the model call. Return `None` if the
+    messages are not found."""
+    continuation = [
+        {"role": "assistant", "content": partial_text},
+        {"role": "user", "content": _CONTINUATION_PROMPT},
+    ]
+    if len(args) > 0 and _is_chat_messages(args[0]):
+        return (args[0] + continuation, *args[1:]), kwargs
+    if _is_chat_messages(kwargs.get("messages", None)):
+        return args, {**kwargs, "messages": kwargs["messages"] + continuation}
+    return None
+
+
 def _response_parse_decorator(
     model_call: Callable,
 ) -> Callable:
@@ -83,11 +128,17 @@ def _response_parse_decorator(
     detailed process is as follows:
 
         1. If `parse_func` is provided, then the response will be parsed first.
+        The parsers repair the small defects in JSON objects by themselves.
+
+        2. If the parsing fails because the response is truncated, and the
+        prompt is a list of chat messages, the model will be asked to
+        continue the truncated response, and the concatenated response will
+        be parsed again. Only the missing tail is generated in this way.
 
-        2. If the parsing fails (throws an exception), then response generation
+        3. If the parsing still fails, then response generation
         will be repeated for `max_retries` times and parsed again.
 
-        3. After `max_retries` times, if the parsing still fails, then if
+        4. After `max_retries` times, if the parsing still fails, then if
         `fault_handler` is provided, the response will be processed by
         `fault_handler`.
     """
@@ -120,23 +171,62 @@ def _response_parse_decorator(
         for itr in range(1, max_retries + 1):
             # Call the model
             response = model_call(self, *args, **kwargs)
+            response_text = response.text
 
             # Parse the response if needed
             try:
-                return parse_func(response)
+                parsed_response = parse_func(response)
+                if itr > 1:
+                    record_parse_tier("regenerated")
+                return parsed_response
             except ResponseParsingError as e:
-                if itr < max_retries:
+                error = e
+
+            # Ask the model to continue the truncated response
+            continuation_args = None
+            if _is_truncated(error) and isinstance(response_text, str):
+                continuation_args = _get_continuation_args(
+                    args,
+                    kwargs,
+                    response_text,
+                )
+            if continuation_args is not None:
+                logger.debug("Continue the truncated response.")
+                try:
+                    continuation = model_call(
+                        self,
+                        *continuation_args[0],
+                        **continuation_args[1],
+                    )
+                    parsed_response = parse_func(
+                        ModelResponse(
+                            text=response_text + (continuation.text or ""),
+                            raw=continuation.raw,
+                        ),
+                    )
+                    record_parse_tier("continued")
+                    return parsed_response
+                except ResponseParsingError as e:
+                    error = e
+                except Exception as e:  # pylint: disable=broad-except
+                    # Fall back to regenerating the whole response
                     logger.warning(
-                        f"Fail to parse response ({itr}/{max_retries}):\n"
-                        f"{response}.\n"
-                        f"{e.__class__.__name__}: {e}",
+                        f"Fail to continue the truncated response: {e}",
                     )
-                    time.sleep(_DEFAULT_RETRY_INTERVAL * itr)
+
+            if itr < max_retries:
+                logger.warning(
+                    f"Fail to parse response ({itr}/{max_retries}):\n"
+                    f"{response}.\n"
+                    f"{error.__class__.__name__}: {error}",
+                )
+                time.sleep(_DEFAULT_RETRY_INTERVAL * itr)
+            else:
+                record_parse_tier("failed")
+                if fault_handler is not None and callable(fault_handler):
+                    return fault_handler(response)
                 else:
-                    if fault_handler is not None and callable(fault_handler):
-                        return fault_handler(response)
-                    else:
-                        raise
+                    raise error
         return {}
 
     return checking_wrapper
@@ -180,6 +270,12 @@ class ModelWrapperBase(metaclass=_ModelWrapperMeta):
     model_name: str
     """The name of the model, which is used in model api calling."""
 
+    prompt_budget: Optional[Union[dict, int]] = None
+    """The token budget of the prompts built by agents for this model, e.g.
+    `{"max_tokens": 4000, "strategy": "recency"}`, which is set by the
+    `prompt_budget` field in model configuration. See
+    :py:class:`agentscope.memory.PromptBudget` for details."""
+
     def __init__(
         self,  # pylint: disable=W0613
         config_name: str,
@@ -278,6 +278,10 @@ class OllamaEmbeddingWrapper(OllamaWrapperBase):
 
     model_type: str = "ollama_embedding"
 
+    max_batch_size: int = 1
+    """The maximum number of texts in one embedding request. Ollama
+    embedding API only accepts a single prompt."""
+
     def __call__(
         self,
         prompt: str,
@@ -447,6 +447,9 @@ class OpenAIEmbeddingWrapper(OpenAIWrapperBase):
 
     model_type: str = "openai_embedding"
 
+    max_batch_size: int = 2048
+    """The maximum number of texts in one embedding request."""
+
     def _register_default_metrics(self) -> None:
         # Set monitor accordingly
         # TODO: set quota to the following metrics
@@ -13,6 +13,7 @@ from ..constants import _DEFAULT_MAX_RETRIES
 from ..constants import _DEFAULT_MESSAGES_KEY
 from ..constants import _DEFAULT_RETRY_INTERVAL
 from ..message import Msg
+from ..utils.http_session import get_http_session
 from ..utils.tools import _convert_to_str
 
 
@@ -62,11 +63,13 @@ class PostAPIModelWrapperBase(ModelWrapperBase, ABC):
 
         Note:
             When an object of `PostApiModelWrapper` is called, the arguments
-            will of post requests will be used as follows:
+            will of post requests will be used as follows, where `session`
+            is the connection-pooled session returned by
+            `agentscope.utils.http_session.get_http_session`:
 
             .. code-block:: python
 
-                request.post(
+                session.post(
                     url=api_url,
                     headers=headers,
                     json={
@@ -93,7 +96,8 @@ class PostAPIModelWrapperBase(ModelWrapperBase, ABC):
         return ModelResponse(raw=response)
 
     def __call__(self, input_: str, **kwargs: Any) -> ModelResponse:
-        """Calling the model with requests.post.
+        """Calling the model with the post method of the shared http
+        session.
 
         Args:
             input_ (`str`):
@@ -129,7 +133,7 @@ class PostAPIModelWrapperBase(ModelWrapperBase, ABC):
 
         # step2: prepare post requests
         for i in range(1, self.max_retries + 1):
-            response = requests.post(**request_kwargs)
+            response = get_http_session().post(**request_kwargs)
 
             if response.status_code == requests.codes.ok:
                 break
@@ -249,6 +253,32 @@ class PostAPIEmbeddingWrapper(PostAPIModelWrapperBase):
 
     model_type: str = "post_api_embedding"
 
+    max_batch_size: int = 1
+    """The maximum number of texts in one embedding request. Set it to a
+    larger value in the model configuration if the API accepts a list of
+    texts."""
+
+    def __init__(
+        self,
+        config_name: str,
+        api_url: str,
+        max_batch_size: int = 1,
+        **kwargs: Any,
+    ) -> None:
+        """Initialize the embedding model wrapper.
+
+        Args:
+            config_name (`str`):
+                The id of the model.
+            api_url (`str`):
+                The url of the post request api.
+            max_batch_size (`int`, defaults to `1`):
+                The maximum number of texts in one embedding request, which
+                is used by `EmbeddingBatcher` to coalesce requests.
+        """
+        super().__init__(config_name=config_name, api_url=api_url, **kwargs)
+        self.max_batch_size = max_batch_size
+
     def _parse_response(self, response: dict) -> ModelResponse:
         """
         Parse the response json data into ModelResponse with embedding.
@@ -16,6 +16,8 @@ class MsgHubManager:
         self,
         participants: Sequence[AgentBase],
         announcement: Optional[Union[Sequence[dict], dict]] = None,
+        async_observe: bool = False,
+        inbox_size: int = 64,
     ) -> None:
         """Initialize a msghub manager from the given arguments.
 
@@ -26,9 +28,20 @@ class MsgHubManager:
                 (`Optional[Union[list[dict], dict]]`, defaults to `None`):
                 The message that will be broadcast to all participants at
                 the first without requiring response.
+            async_observe (`bool`, defaults to `False`):
+                Whether the participants observe the broadcast messages
+                asynchronously through their own inboxes, so that the
+                broadcast returns without waiting for the observations.
+                The messages in the inbox are always observed before the
+                agent replies.
+            inbox_size (`int`, defaults to `64`):
+                The maximum number of messages waiting in each inbox, the
+                broadcast blocks when an inbox is full.
         """
         self.participants = participants
         self.announcement = announcement
+        self.async_observe = async_observe
+        self.inbox_size = inbox_size
 
     def __enter__(self) -> MsgHubManager:
         """Will be called when entering the msghub."""
@@ -42,17 +55,30 @@ class MsgHubManager:
 
         self._reset_audience()
 
+        if self.async_observe:
+            for agent in self.participants:
+                agent.open_inbox(self.inbox_size)
+
         # broadcast the input message to all participants
         if self.announcement is not None:
-            for agent in self.participants:
-                agent.observe(self.announcement)
+            self.broadcast(self.announcement)
 
         return self
 
     def __exit__(self, *args: Any, **kwargs: Any) -> None:
-        """Will be called when exiting the msghub."""
+        """Will be called when exiting the msghub. The inboxes of all the
+        participants are closed, and the first error raised when observing
+        the remaining messages is re-raised afterwards."""
+        error = None
         for agent in self.participants:
-            agent.clear_audience()
+            try:
+                agent.clear_audience()
+                agent.close_inbox()
+            except Exception as e:
+                if error is None:
+                    error = e
+        if error is not None:
+            raise error
 
     def _reset_audience(self) -> None:
         """Reset the audience for agent in `self.participant`"""
@@ -70,6 +96,8 @@ class MsgHubManager:
         for agent in new_participant:
             if agent not in self.participants:
                 self.participants.append(agent)
+                if self.async_observe:
+                    agent.open_inbox(self.inbox_size)
             else:
                 logger.warning(
                     f"Skip adding agent [{agent.name}] for it has "
@@ -90,6 +118,7 @@ class MsgHubManager:
             if agent in self.participants:
                 # Clear the audience of the deleted agent firstly
                 agent.clear_audience()
+                agent.close_inbox()
 
                 # remove agent from self.participant
                 self.participants.pop(self.participants.index(agent))
@@ -103,20 +132,23 @@ class MsgHubManager:
         self._reset_audience()
 
     def broadcast(self, msg: Union[dict, list[dict]]) -> None:
-        """Broadcast the message to all participants.
+        """Broadcast the message to all participants. The distributed
+        participants in the same agent server observe it in a single
+        request, and different servers are requested concurrently.
 
         Args:
             msg (`Union[dict, list[dict]]`):
                 One or a list of dict messages to broadcast among all
                 participants.
         """
-        for agent in self.participants:
-            agent.observe(msg)
+        AgentBase.broadcast(self.participants, msg)
 
 
 def msghub(
     participants: Sequence[AgentBase],
     announcement: Optional[Union[Sequence[dict], dict]] = None,
+    async_observe: bool = False,
+    inbox_size: int = 64,
 ) -> MsgHubManager:
     """msghub is used to share messages among a group of agents.
 
@@ -126,6 +158,11 @@ def msghub(
         announcement (`Optional[Union[list[dict], dict]]`, defaults to `None`):
             The message that will be broadcast to all participants at the
             very beginning without requiring response.
+        async_observe (`bool`, defaults to `False`):
+            Whether the participants observe the broadcast messages
+            asynchronously through their own bounded inboxes.
+        inbox_size (`int`, defaults to `64`):
+            The maximum number of messages waiting in each inbox.
 
     Example:
         In the following code, we create a msghub with three agents, and each
@@ -151,4 +188,9 @@ def msghub(
             agent1.observe(x2)
             agent3.observe(x2)
     """
-    return MsgHubManager(participants, announcement)
+    return MsgHubManager(
+        participants,
+        announcement,
+        async_observe=async_observe,
+        inbox_size=inbox_size,
+    )
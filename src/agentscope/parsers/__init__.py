@@ -1,6 +1,11 @@
 # -*- coding: utf-8 -*-
 """Model response parser module."""
 from .parser_base import ParserBase
+from .stream_parser import (
+    TagScanner,
+    MultiTaggedContentStream,
+    MarkdownJsonDictStream,
+)
 from .json_object_parser import (
     MarkdownJsonObjectParser,
     MarkdownJsonDictParser,
@@ -19,4 +24,7 @@ __all__ = [
     "MarkdownCodeBlockParser",
     "TaggedContent",
     "MultiTaggedContentParser",
+    "TagScanner",
+    "MultiTaggedContentStream",
+    "MarkdownJsonDictStream",
 ]
@@ -16,7 +16,10 @@ from agentscope.exception import (
 )
 from agentscope.models import ModelResponse
 from agentscope.parsers import ParserBase
+from agentscope.parsers.json_repair import repair_json
 from agentscope.parsers.parser_base import DictFilterMixin
+from agentscope.parsers.stream_parser import MarkdownJsonDictStream
+from agentscope.utils.monitor import record_parse_tier
 from agentscope.utils.tools import _join_str_with_comma_and
 
 
@@ -65,6 +68,7 @@ class MarkdownJsonObjectParser(ParserBase):
         field in the response object."""
 
         # extract the content and try to fix the missing tags by hand
+        missing_end_tag = False
         try:
             extract_text = self._extract_first_content_by_tag(
                 response,
@@ -83,6 +87,7 @@ class MarkdownJsonObjectParser(ParserBase):
                     )
                 if e.missing_end_tag:
                     response_copy.text = response_copy.text + self.tag_end
+                    missing_end_tag = True
 
                 # Try again to extract the content
                 extract_text = self._extract_first_content_by_tag(
@@ -106,13 +111,30 @@ class MarkdownJsonObjectParser(ParserBase):
             response.parsed = parsed_json
             return response
         except json.decoder.JSONDecodeError as e:
-            raw_response = f"{self.tag_begin}{extract_text}{self.tag_end}"
-            raise JsonParsingError(
-                f"The content between {self.tag_begin} and {self.tag_end} "
-                f"MUST be a JSON object."
-                f'When parsing "{raw_response}", an error occurred: {e}',
-                raw_response=raw_response,
-            ) from None
+            error = e
+
+        # Repair the small defects rather than regenerating the response
+        # The unclosed brackets are only regarded as truncated if the code
+        # block isn't closed either
+        repaired_text, truncated = repair_json(extract_text)
+        truncated = truncated and missing_end_tag
+        if not truncated:
+            try:
+                response.parsed = json.loads(repaired_text)
+                logger.debug(f"Repair the JSON object: {error}")
+                record_parse_tier("repaired")
+                return response
+            except json.decoder.JSONDecodeError:
+                pass
+
+        raw_response = f"{self.tag_begin}{extract_text}{self.tag_end}"
+        raise JsonParsingError(
+            f"The content between {self.tag_begin} and {self.tag_end} "
+            f"MUST be a JSON object."
+            f'When parsing "{raw_response}", an error occurred: {error}',
+            raw_response=raw_response,
+            truncated=truncated,
+        ) from None
 
     @property
     def format_instruction(self) -> str:
@@ -294,3 +316,11 @@ class MarkdownJsonDictParser(MarkdownJsonObjectParser, DictFilterMixin):
             )
 
         return response
+
+    def stream(self) -> MarkdownJsonDictStream:
+        """Create an incremental parser, which consumes the response text
+        piece by piece (e.g. the deltas of a streaming response), returns the
+        top-level fields of the JSON dictionary once their values are
+        complete, and raises the parsing error as soon as the response is
+        found malformed."""
+        return MarkdownJsonDictStream(self)
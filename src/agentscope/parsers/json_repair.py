@@ -0,0 +1,104 @@
+# -*- coding: utf-8 -*-
+"""A tolerant repairer for the common mistakes in JSON generated by LLMs, so
+that a response with small defects doesn't need to be regenerated."""
+from typing import List, Tuple
+
+_CLOSERS = {"{": "}", "[": "]"}
+
+
+def _next_non_space(text: str, start: int) -> str:
+    """Get the next non-whitespace character, or an empty string."""
+    for index in range(start, len(text)):
+        if not text[index].isspace():
+            return text[index]
+    return ""
+
+
+def _strip_trailing_comma(chars: List[str]) -> None:
+    """Remove the trailing comma (and the whitespaces after it)."""
+    index = len(chars) - 1
+    while index >= 0 and chars[index].isspace():
+        index -= 1
+    if index >= 0 and chars[index] == ",":
+        del chars[index:]
+
+
+def _repair_string_char(
+    text: str,
+    index: int,
+    escape: bool,
+) -> Tuple[str, bool, bool]:
+    """Repair a character inside a string.
+
+    Returns:
+        `Tuple[str, bool, bool]`:
+            The repaired character, whether the string continues, and whether
+            the next character is escaped.
+    """
+    char = text[index]
+    if escape:
+        return char, True, False
+    if char == "\\":
+        return char, True, True
+    if char == '"':
+        if _next_non_space(text, index + 1) not in ",:}]":
+            return '\\"', True, False
+        return char, False, False
+    if char == "\n":
+        return "\\n", True, False
+    return char, True, False
+
+
+def repair_json(text: str) -> Tuple[str, bool]:
+    """Repair the JSON text in a single pass, including
+
+        - trailing commas before the closing brackets,
+        - unescaped double quotes and raw newlines inside strings, where a
+          double quote is regarded as the end of a string only if it's
+          followed by `,`, `:`, `}`, `]` or the end of the text,
+        - missing closing brackets at the end of the text, which are
+          appended and reported as possibly truncated.
+
+    Args:
+        text (`str`):
+            The JSON text to be repaired.
+
+    Returns:
+        `Tuple[str, bool]`:
+            The repaired text, and whether the text may be truncated, i.e.
+            it ends inside a string or with unclosed brackets. If the block
+            enclosing the text (e.g. a markdown fence) isn't terminated
+            either, the text may have lost content (e.g. the remaining items
+            of a list of function calls), so the caller shouldn't accept it
+            as repaired. The string it ends inside is left unclosed.
+    """
+    chars: List[str] = []
+    closers: List[str] = []
+    in_string = False
+    escape = False
+
+    for index, char in enumerate(text):
+        if in_string:
+            char, in_string, escape = _repair_string_char(text, index, escape)
+            chars.append(char)
+            continue
+
+        if char == '"':
+            in_string = True
+        elif char in _CLOSERS:
+            closers.append(_CLOSERS[char])
+        elif char in "}]":
+            _strip_trailing_comma(chars)
+            if len(closers) > 0 and closers[-1] == char:
+                closers.pop()
+        chars.append(char)
+
+    if in_string:
+        return "".join(chars), True
+
+    if len(closers) > 0:
+        _strip_trailing_comma(chars)
+        chars.extend(reversed(closers))
+        return "".join(chars), True
+
+    return "".join(chars), False
@@ -0,0 +1,412 @@
+# -*- coding: utf-8 -*-
+"""Incremental parsers that consume the model response piece by piece, so
+that each field is available as soon as it's complete, and a malformed
+response is detected before the generation finishes."""
+import json
+from typing import Any, Dict, List, Optional, Sequence, Tuple
+
+from agentscope.exception import (
+    JsonParsingError,
+    JsonTypeError,
+    TagNotFoundError,
+)
+from agentscope.models import ModelResponse
+
+
+class TagScanner:
+    """Scan the text for multiple tagged fields in a single pass. The text
+    can be fed in pieces (e.g. the deltas of a streaming response), and each
+    field is returned once its end tag arrives. Only the first occurrence of
+    each field is extracted, and the fields can appear in any order.
+
+    Note:
+        Only the text that may contain an unfinished tag is kept for the next
+        scan, so the text is never scanned from the beginning again.
+    """
+
+    def __init__(self, tags: Sequence[Tuple[str, str, str]]) -> None:
+        """Initialize the scanner.
+
+        Args:
+            tags (`Sequence[Tuple[str, str, str]]`):
+                The name, begin tag and end tag of each field.
+        """
+        self.tags = {
+            name: (tag_begin, tag_end) for name, tag_begin, tag_end in tags
+        }
+        self.contents: Dict[str, str] = {}
+        self.open_field: Optional[str] = None
+        # The fields whose end tags never arrive
+        self._unterminated: set = set()
+
+        self._chunks: List[str] = []
+        self._text: Optional[str] = ""
+        # The unscanned text, or the content of the open field
+        self._buffer = ""
+        # The position in the buffer to search the end tag from
+        self._searched = 0
+        self._max_begin_len = max(
+            (len(tag_begin) for tag_begin, _ in self.tags.values()),
+            default=1,
+        )
+
+    @property
+    def text(self) -> str:
+        """The text fed so far."""
+        if self._text is None:
+            self._text = "".join(self._chunks)
+        return self._text
+
+    @property
+    def partial(self) -> str:
+        """The content of the open field received so far, which may end with
+        a part of the end tag."""
+        return self._buffer if self.open_field is not None else ""
+
+    def feed(self, delta: str) -> List[Tuple[str, str]]:
+        """Feed a piece of text.
+
+        Args:
+            delta (`str`):
+                The newly generated text.
+
+        Returns:
+            `List[Tuple[str, str]]`:
+                The name and content of the fields completed by this piece.
+        """
+        self._chunks.append(delta)
+        self._text = None
+        self._buffer += delta
+        return self._scan()
+
+    def finish(self) -> List[Tuple[str, str]]:
+        """Finish the text. If the end tag of the open field never arrives,
+        the text after its begin tag is scanned again for the other fields,
+        so that a field missing its end tag doesn't hide the following ones.
+
+        Returns:
+            `List[Tuple[str, str]]`:
+                The name and content of the fields found after the begin tags
+                without end tags.
+        """
+        completed = []
+        while self.open_field is not None:
+            self._unterminated.add(self.open_field)
+            self.open_field = None
+            completed.extend(self._scan())
+        return completed
+
+    def _scan(self) -> List[Tuple[str, str]]:
+        """Scan the buffer for the fields completed."""
+        completed = []
+        while True:
+            if self.open_field is None:
+                found = self._find_begin_tag()
+                if found is None:
+                    # Keep the tail that may be a part of a begin tag
+                    keep = self._max_begin_len - 1
+                    self._buffer = self._buffer[-keep:] if keep > 0 else ""
+                    break
+                name, index = found
+                self.open_field = name
+                self._buffer = self._buffer[index + len(self.tags[name][0]) :]
+                self._searched = 0
+            else:
+                tag_end = self.tags[self.open_field][1]
+                index = self._buffer.find(tag_end, self._searched)
+                if index == -1:
+                    self._searched = max(
+                        0,
+                        len(self._buffer) - len(tag_end) + 1,
+                    )
+                    break
+                content = self._buffer[:index]
+                self.contents[self.open_field] = content
+                completed.append((self.open_field, content))
+                self._buffer = self._buffer[index + len(tag_end) :]
+                self.open_field = None
+        return completed
+
+    def _find_begin_tag(self) -> Optional[Tuple[str, int]]:
+        """Find the first begin tag of the pending fields in the buffer."""
+        found_name, found_index, found_len = None, -1, 0
+        for name, (tag_begin, _) in self.tags.items():
+            if name in self.contents or name in self._unterminated:
+                continue
+            index = self._buffer.find(tag_begin)
+            if index == -1:
+                continue
+            # Prefer the earlier one, and the longer one at the same position
+            if (
+                found_name is None
+                or index < found_index
+                or (index == found_index and len(tag_begin) > found_len)
+            ):
+                found_name, found_index, found_len = (
+                    name,
+                    index,
+                    len(tag_begin),
+                )
+        if found_name is None:
+            return None
+        return found_name, found_index
+
+    def missing_tags(self, name: str) -> Tuple[bool, bool]:
+        """Check which tags of a field are missing in the text fed so far.
+
+        Returns:
+            `Tuple[bool, bool]`:
+                If the begin tag and the end tag are missing, respectively.
+        """
+        if name in self.contents:
+            return False, False
+        if name == self.open_field or name in self._unterminated:
+            return False, True
+        return True, self.tags[name][1] not in self.text
+
+
+class MultiTaggedContentStream:
+    """The incremental version of `MultiTaggedContentParser.parse`, created
+    by `MultiTaggedContentParser.stream()`.
+
+    Example:
+
+        .. code-block:: python
+
+            stream = parser.stream()
+            for delta in deltas:
+                # Raises ResponseParsingError once the response is malformed,
+                # so that the generation can be aborted and retried
+                for name, value in stream.feed(delta).items():
+                    ...
+
+            response = stream.close()
+    """
+
+    def __init__(self, parser: Any) -> None:
+        """Initialize the stream with a `MultiTaggedContentParser`."""
+        self.parser = parser
+        self.parsed: Dict[str, Any] = {}
+        self._tagged_contents = {_.name: _ for _ in parser.tagged_contents}
+        self._scanner = TagScanner(
+            [(_.name, _.tag_begin, _.tag_end) for _ in parser.tagged_contents],
+        )
+
+    def feed(self, delta: str) -> Dict[str, Any]:
+        """Feed a piece of the response text.
+
+        Args:
+            delta (`str`):
+                The newly generated text.
+
+        Returns:
+            `Dict[str, Any]`: The fields completed by this piece.
+
+        Raises:
+            `JsonParsingError`: If a field required to be a JSON object
+            cannot be parsed.
+        """
+        new_fields = {}
+        for name, content in self._scanner.feed(delta):
+            value = self.parser.parse_content(
+                self._tagged_contents[name],
+                content,
+            )
+            self.parsed[name] = value
+            new_fields[name] = value
+        return new_fields
+
+    def close(self) -> ModelResponse:
+        """Finish the stream and check the missing fields.
+
+        Returns:
+            `ModelResponse`:
+                The whole response text in the text field, and the parsed
+                dictionary in the parsed field.
+
+        Raises:
+            `TagNotFoundError`: If the tags of a field that isn't allowed to
+            be missing are not found.
+        """
+        for name, content in self._scanner.finish():
+            self.parsed[name] = self.parser.parse_content(
+                self._tagged_contents[name],
+                content,
+            )
+
+        text = self._scanner.text
+        for tagged_content in self.parser.tagged_contents:
+            if tagged_content.name in self.parsed or (
+                self.parser.keys_allow_missing is not None
+                and tagged_content.name in self.parser.keys_allow_missing
+            ):
+                continue
+
+            missing_begin, missing_end = self._scanner.missing_tags(
+                tagged_content.name,
+            )
+            missing_tags = []
+            if missing_begin:
+                missing_tags.append(tagged_content.tag_begin)
+            if missing_end:
+                missing_tags.append(tagged_content.tag_end)
+            raise TagNotFoundError(
+                f"Missing "
+                f"tag{'' if len(missing_tags)==1 else 's'} "
+                f"{' and '.join(missing_tags)} in response: {text}",
+                raw_response=text,
+                missing_begin_tag=missing_begin,
+                missing_end_tag=missing_end,
+            )
+
+        # Keep the order of the declared fields
+        parsed = {
+            _.name: self.parsed[_.name]
+            for _ in self.parser.tagged_contents
+            if _.name in self.parsed
+        }
+        return ModelResponse(text=text, parsed=parsed)
+
+
+class MarkdownJsonDictStream:
+    """The incremental version of `MarkdownJsonDictParser.parse`, created by
+    `MarkdownJsonDictParser.stream()`. The top-level fields of the JSON
+    dictionary are returned by `feed` once their values are complete, and
+    the response is reported as malformed as soon as it isn't a JSON
+    dictionary, e.g. a field cannot be parsed, or the code block ends before
+    the dictionary is closed.
+
+    Note:
+        `close` parses the whole response by the parser again, so that the
+        missing tags are fixed, and the required keys and the Pydantic schema
+        are checked exactly as `MarkdownJsonDictParser.parse` does.
+    """
+
+    def __init__(self, parser: Any) -> None:
+        """Initialize the stream with a `MarkdownJsonDictParser`."""
+        self.parser = parser
+        self.parsed: Dict[str, Any] = {}
+        self._scanner = TagScanner(
+            [("json", parser.tag_begin, parser.tag_end)],
+        )
+
+        # The state of scanning the JSON content
+        self._pos = 0
+        self._depth = 0
+        self._in_string = False
+        self._escape = False
+        self._closed = False
+        self._member_start = 0
+
+    def feed(self, delta: str) -> Dict[str, Any]:
+        """Feed a piece of the response text.
+
+        Args:
+            delta (`str`):
+                The newly generated text.
+
+        Returns:
+            `Dict[str, Any]`: The top-level fields completed by this piece.
+
+        Raises:
+            `JsonTypeError`: If the content isn't a JSON dictionary.
+            `JsonParsingError`: If a field cannot be parsed, or the code block
+            ends before the dictionary is closed.
+        """
+        completed = self._scanner.feed(delta)
+        if len(completed) > 0:
+            content = completed[0][1]
+            new_fields = self._scan(content)
+            if not self._closed:
+                raise self._error(
+                    JsonParsingError,
+                    "The JSON dictionary is not closed before the end of the "
+                    "code block",
+                    content,
+                )
+            return new_fields
+
+        if self._scanner.open_field is not None:
+            return self._scan(self._scanner.partial)
+        return {}
+
+    def close(self) -> ModelResponse:
+        """Finish the stream and parse the whole response.
+
+        Returns:
+            `ModelResponse`:
+                The whole response text in the text field, and the parsed
+                dictionary in the parsed field.
+        """
+        return self.parser.parse(ModelResponse(text=self._scanner.text))
+
+    def _scan(self, content: str) -> Dict[str, Any]:
+        """Scan the new characters in the content of the code block, and
+        return the top-level fields completed."""
+        new_fields = {}
+        for index in range(self._pos, len(content)):
+            char = content[index]
+
+            if self._in_string:
+                self._scan_string(char)
+                continue
+
+            if self._depth == 0:
+                if self._closed or char.isspace():
+                    continue
+                if char != "{":
+                    raise self._error(
+                        JsonTypeError,
+                        "A JSON dictionary object is wanted",
+                        content,
+                    )
+                self._depth = 1
+                self._member_start = index + 1
+            elif char == '"':
+                self._in_string = True
+            elif char in "{[":
+                self._depth += 1
+            elif char in "}]":
+                self._depth -= 1
+                if self._depth == 0:
+                    self._closed = True
+                    new_fields.update(self._parse_member(content, index))
+            elif char == "," and self._depth == 1:
+                new_fields.update(self._parse_member(content, index))
+                self._member_start = index + 1
+
+        self._pos = len(content)
+        return new_fields
+
+    def _scan_string(self, char: str) -> None:
+        """Scan a character inside a JSON string."""
+        if self._escape:
+            self._escape = False
+        elif char == "\\":
+            self._escape = True
+        elif char == '"':
+            self._in_string = False
+
+    def _parse_member(self, content: str, end: int) -> Dict[str, Any]:
+        """Parse the top-level member ending at the given position."""
+        member = content[self._member_start : end]
+        if member.strip() == "":
+            return {}
+        try:
+            field = json.loads("{" + member + "}")
+        except json.decoder.JSONDecodeError as e:
+            raise self._error(
+                JsonParsingError,
+                f'An error "{e}" occurred when parsing the field {member}',
+                content,
+            ) from None
+        self.parsed.update(field)
+        return field
+
+    def _error(self, error_class: type, message: str, content: str) -> Any:
+        """Create the parsing error with the raw code block."""
+        raw_response = f"{self.parser.tag_begin}{content}"
+        return error_class(
+            f"{message} in the response: {raw_response}",
+            raw_response=raw_response,
+        )
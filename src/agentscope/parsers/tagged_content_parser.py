@@ -1,12 +1,15 @@
 # -*- coding: utf-8 -*-
 """The parser for tagged content in the model response."""
 import json
-from typing import Union, Sequence, Optional, List
+from typing import Union, Sequence, Optional, List, Any
 
-from agentscope.exception import JsonParsingError, TagNotFoundError
+from agentscope.exception import JsonParsingError
 from agentscope.models import ModelResponse
 from agentscope.parsers import ParserBase
+from agentscope.parsers.json_repair import repair_json
 from agentscope.parsers.parser_base import DictFilterMixin
+from agentscope.parsers.stream_parser import MultiTaggedContentStream
+from agentscope.utils.monitor import record_parse_tier
 
 
 class TaggedContent:
@@ -165,45 +168,55 @@ class MultiTaggedContentParser(ParserBase, DictFilterMixin):
         """Parse the response text by tags, and return a dict of their content
         in the parsed field of the model response object. If the tagged content
         requires to parse as a JSON object by `parse_json` equals to `True`, it
-        will be parsed as a JSON object by `json.loads`."""
-
-        tag_to_content = {}
-        for tagged_content in self.tagged_contents:
-            tag_begin = tagged_content.tag_begin
-            tag_end = tagged_content.tag_end
-
-            try:
-                extract_content = self._extract_first_content_by_tag(
-                    response,
-                    tag_begin,
-                    tag_end,
-                )
-
-                if tagged_content.parse_json:
-                    try:
-                        extract_content = json.loads(extract_content)
-                    except json.decoder.JSONDecodeError as e:
-                        raw_response = f"{tag_begin}{extract_content}{tag_end}"
-                        raise JsonParsingError(
-                            f"The content between "
-                            f"{tagged_content.tag_begin} and "
-                            f"{tagged_content.tag_end} should be a JSON "
-                            f'object. An error "{e}" occurred when parsing: '
-                            f"{raw_response}",
-                            raw_response=raw_response,
-                        ) from None
-
-                tag_to_content[tagged_content.name] = extract_content
-
-            except TagNotFoundError as e:
-                # if the key is allowed to be missing, skip the error
-                if (
-                    self.keys_allow_missing is not None
-                    and tagged_content.name in self.keys_allow_missing
-                ):
-                    continue
-
-                raise e from None
-
-        response.parsed = tag_to_content
+        will be parsed as a JSON object by `json.loads`.
+
+        All the tags are found in a single scan of the response text."""
+        stream = self.stream()
+        stream.feed(response.text)
+        response.parsed = stream.close().parsed
         return response
+
+    def stream(self) -> MultiTaggedContentStream:
+        """Create an incremental parser, which consumes the response text
+        piece by piece (e.g. the deltas of a streaming response), returns
+        each tagged content once its end tag arrives, and raises the parsing
+        error as soon as a tagged content is malformed."""
+        return MultiTaggedContentStream(self)
+
+    def parse_content(
+        self,
+        tagged_content: TaggedContent,
+        content: str,
+    ) -> Any:
+        """Parse the extracted content of a tagged content object, which is
+        loaded as a JSON object if `parse_json` is `True`."""
+        if not tagged_content.parse_json:
+            return content
+
+        try:
+            return json.loads(content)
+        except json.decoder.JSONDecodeError as e:
+            error = e
+
+        # Repair the small defects rather than regenerating the response.
+        # The content is complete since its end tag is found, so that the
+        # unclosed brackets are closed rather than regarded as truncated.
+        repaired_content, _ = repair_json(content)
+        try:
+            value = json.loads(repaired_content)
+            record_parse_tier("repaired")
+            return value
+        except json.decoder.JSONDecodeError:
+            pass
+
+        tag_begin = tagged_content.tag_begin
+        tag_end = tagged_content.tag_end
+        raw_response = f"{tag_begin}{content}{tag_end}"
+        raise JsonParsingError(
+            f"The content between "
+            f"{tag_begin} and "
+            f"{tag_end} should be a JSON "
+            f'object. An error "{error}" occurred when parsing: '
+            f"{raw_response}",
+            raw_response=raw_response,
+        ) from None
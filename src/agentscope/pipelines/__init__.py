@@ -7,6 +7,7 @@ from .pipeline import (
     SwitchPipeline,
     ForLoopPipeline,
     WhileLoopPipeline,
+    ParallelPipeline,
 )
 
 from .functional import (
@@ -15,6 +16,8 @@ from .functional import (
     switchpipeline,
     forlooppipeline,
     whilelooppipeline,
+    parallelpipeline,
+    gather,
 )
 
 __all__ = [
@@ -24,9 +27,12 @@ __all__ = [
     "SwitchPipeline",
     "ForLoopPipeline",
     "WhileLoopPipeline",
+    "ParallelPipeline",
     "sequentialpipeline",
     "ifelsepipeline",
     "switchpipeline",
     "forlooppipeline",
     "whilelooppipeline",
+    "parallelpipeline",
+    "gather",
 ]
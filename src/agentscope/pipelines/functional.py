@@ -1,14 +1,17 @@
 # -*- coding: utf-8 -*-
 """ Functional counterpart for Pipeline """
+from concurrent.futures import ThreadPoolExecutor
 from typing import (
     Callable,
     Sequence,
     Optional,
     Union,
     Any,
+    List,
     Mapping,
 )
 from ..agents.operator import Operator
+from ..message import PlaceholderMessage
 
 # A single Operator or a Sequence of Operators
 Operators = Union[Operator, Sequence[Operator]]
@@ -177,3 +180,83 @@ def whilelooppipeline(
         # check condition
         i += 1
     return x  # type: ignore[return-value]
+
+
+def gather(
+    msgs: Sequence[Any],
+    reduce_func: Optional[Callable[[List[Any]], Any]] = None,
+    max_workers: Optional[int] = None,
+) -> Any:
+    """Wait for the messages together and combine them. The placeholder
+    messages returned by the distributed agents are resolved concurrently,
+    instead of one by one when they are accessed.
+
+    Args:
+        msgs (`Sequence[Any]`):
+            The messages to gather, which may contain placeholder messages.
+        reduce_func (`Optional[Callable[[List[Any]], Any]]`, defaults to \
+        `None`):
+            A function to combine the messages, e.g. to count the votes.
+        max_workers (`Optional[int]`, defaults to `None`):
+            The maximum number of placeholder messages resolved at the same
+            time, defaults to the number of them.
+
+    Returns:
+        `Any`: The list of messages in the given order, or the result of
+        `reduce_func` on it.
+    """
+    msgs = list(msgs)
+    placeholders = [_ for _ in msgs if isinstance(_, PlaceholderMessage)]
+    if len(placeholders) == 1:
+        placeholders[0].update_value()
+    elif len(placeholders) > 1:
+        with ThreadPoolExecutor(
+            max_workers=max_workers or len(placeholders),
+        ) as executor:
+            list(executor.map(lambda _: _.update_value(), placeholders))
+
+    if reduce_func is not None:
+        return reduce_func(msgs)
+    return msgs
+
+
+def parallelpipeline(
+    operators: Sequence[Operators],
+    x: Optional[dict] = None,
+    reduce_func: Optional[Callable[[List[Any]], Any]] = None,
+    max_workers: Optional[int] = None,
+) -> Any:
+    """Functional version of ParallelPipeline.
+
+    Args:
+        operators (`Sequence[Operators]`):
+            Participating operators, each of which can be a single operator
+            or a sequence of operators executed sequentially.
+        x (`Optional[dict]`, defaults to `None`):
+            The input dictionary, which is shared by all the operators and
+            shouldn't be modified by them.
+        reduce_func (`Optional[Callable[[List[Any]], Any]]`, defaults to \
+        `None`):
+            A function to combine the outputs, e.g. to count the votes.
+        max_workers (`Optional[int]`, defaults to `None`):
+            The maximum number of operators executed at the same time,
+            defaults to the number of operators.
+
+    Returns:
+        `Any`: The list of outputs in the order of the operators, or the
+        result of `reduce_func` on it.
+    """
+    if len(operators) == 0:
+        raise ValueError("No operators provided.")
+
+    if len(operators) == 1:
+        msgs = [_operators(operators[0], x)]
+    else:
+        with ThreadPoolExecutor(
+            max_workers=max_workers or len(operators),
+            thread_name_prefix="parallelpipeline",
+        ) as executor:
+            futures = [executor.submit(_operators, _, x) for _ in operators]
+            msgs = [_.result() for _ in futures]
+
+    return gather(msgs, reduce_func=reduce_func, max_workers=max_workers)
@@ -16,6 +16,7 @@ from .functional import (
     switchpipeline,
     forlooppipeline,
     whilelooppipeline,
+    parallelpipeline,
 )
 from ..agents.operator import Operator
 
@@ -249,3 +250,49 @@ class SequentialPipeline(PipelineBase):
 
     def __call__(self, x: Optional[dict] = None) -> dict:
         return sequentialpipeline(operators=self.operators, x=x)
+
+
+class ParallelPipeline(PipelineBase):
+    r"""A template pipeline for sending the same input to multiple operators
+    concurrently and collecting their outputs, e.g. in a debate or a vote.
+
+    ParallelPipeline(operators, reduce_func) represents the following
+    workflow::
+
+        outputs = [operators[0](x), operators[1](x), ..., operators[n](x)]
+        x = reduce_func(outputs)
+
+    where the operators are executed in a thread pool, and the placeholder
+    messages of the distributed agents are resolved together.
+    """
+
+    def __init__(
+        self,
+        operators: Sequence[Operators],
+        reduce_func: Optional[Callable[[List[Any]], Any]] = None,
+        max_workers: Optional[int] = None,
+    ) -> None:
+        r"""Initialize a ParallelPipeline.
+
+        Args:
+            operators (`Sequence[Operators]`):
+                A Sequence of operators to be executed concurrently.
+            reduce_func (`Optional[Callable[[List[Any]], Any]]`, defaults \
+            to `None`):
+                A function to combine the outputs. The list of outputs in
+                the order of the operators is returned if not given.
+            max_workers (`Optional[int]`, defaults to `None`):
+                The maximum number of operators executed at the same time.
+        """
+        self.operators = operators
+        self.reduce_func = reduce_func
+        self.max_workers = max_workers
+        self.participants = list(self.operators)
+
+    def __call__(self, x: Optional[dict] = None) -> Any:
+        return parallelpipeline(
+            operators=self.operators,
+            x=x,
+            reduce_func=self.reduce_func,
+            max_workers=self.max_workers,
+        )
@@ -1,6 +1,11 @@
 # -*- coding: utf-8 -*-
 """The Abtest module to show how different system prompt performs"""
-from typing import List, Optional, Union, Sequence
+import json
+import os
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor, as_completed
+from typing import List, Optional, Union, Sequence, Generator
 from loguru import logger
 
 from agentscope.models import load_model_by_config_name
@@ -59,6 +64,74 @@ class _SystemPromptTestAgent(AgentBase):
         return msg
 
 
+class _RateLimiter:
+    """Limit the calls per minute to a model, which is shared by all the
+    comparers using the same model configuration in the process."""
+
+    _limiters: dict = {}
+    _limiters_lock = threading.Lock()
+
+    def __init__(self, calls_per_minute: float) -> None:
+        self.interval = 60.0 / calls_per_minute
+        self.next_time = time.monotonic()
+        self.lock = threading.Lock()
+
+    @classmethod
+    def get(
+        cls,
+        model_config_name: str,
+        calls_per_minute: float,
+    ) -> "_RateLimiter":
+        """Get the limiter of the model configuration."""
+        with cls._limiters_lock:
+            limiter = cls._limiters.get(model_config_name, None)
+            if limiter is None:
+                limiter = cls(calls_per_minute)
+                cls._limiters[model_config_name] = limiter
+            limiter.interval = 60.0 / calls_per_minute
+            return limiter
+
+    def acquire(self) -> None:
+        """Block until the next call is allowed."""
+        with self.lock:
+            now = time.monotonic()
+            wait = self.next_time - now
+            self.next_time = max(now, self.next_time) + self.interval
+        if wait > 0:
+            time.sleep(wait)
+
+
+def _load_checkpoint(checkpoint_path: Optional[str]) -> dict:
+    """Load the completed responses from the checkpoint file, indexed by the
+    pair of system prompt and query. A partially written last line, left by
+    an interrupted run, is removed from the file so that the following
+    records are appended cleanly."""
+    completed = {}
+    if checkpoint_path is None or not os.path.exists(checkpoint_path):
+        return completed
+    with open(checkpoint_path, "rb") as file:
+        lines = file.readlines()
+    offset = 0
+    for i, line in enumerate(lines):
+        if line.strip() != b"":
+            try:
+                record = json.loads(line)
+            except json.JSONDecodeError:
+                if i != len(lines) - 1:
+                    raise
+                logger.warning(
+                    f"Dropping the unfinished last line of the checkpoint "
+                    f"file {checkpoint_path}.",
+                )
+                os.truncate(checkpoint_path, offset)
+                break
+            completed[(record["system_prompt"], record["query"])] = record[
+                "response"
+            ]
+        offset += len(line)
+    return completed
+
+
 class SystemPromptComparer:
     """The Abtest module to compare how different system prompts perform with
     different queries or in a multi-turn dialog."""
@@ -83,7 +156,6 @@ class SystemPromptComparer:
         self.model = load_model_by_config_name(model_config_name)
         self.compared_system_prompts = compared_system_prompts
 
-        # TODO: use distributed agent to accelerate the process
         self.agents = [
             _SystemPromptTestAgent(
                 f"assistant-{index}",
@@ -93,26 +165,130 @@ class SystemPromptComparer:
             for index, sys_prompt in enumerate(self.compared_system_prompts)
         ]
 
-    def _compare_with_query(self, query: str) -> dict:
-        """Infer the query with the given system prompt."""
-        msg_query = Msg("user", query, "user")
-        msgs_result = [agent(msg_query) for agent in self.agents]
+    def _infer(self, system_prompt: str, query: str) -> str:
+        """Infer a single query with the given system prompt, without the
+        dialog history."""
+        prompt = self.model.format(
+            Msg("system", system_prompt, "system"),
+            Msg("user", query, "user"),
+        )
+        return self.model(prompt).text
 
-        results = []
-        for system_prompt, response_msg in zip(
-            self.compared_system_prompts,
-            msgs_result,
-        ):
-            results.append(
-                {
-                    "system_prompt": system_prompt,
-                    "response": response_msg.content,
-                },
+    def iter_compare_with_queries(
+        self,
+        queries: List[str],
+        max_workers: int = 4,
+        calls_per_minute: Optional[float] = None,
+        checkpoint_path: Optional[str] = None,
+    ) -> Generator[dict, None, None]:
+        """Compare different system prompts with a list of input queries
+        concurrently, and yield the result of each pair of system prompt and
+        query as soon as it completes. Each query is inferred independently,
+        without the history of the other queries.
+
+        Args:
+            queries (`List[str]`):
+                A list of input queries that will be used to compare different
+                system prompts.
+            max_workers (`int`, defaults to `4`):
+                The maximum number of concurrent model calls.
+            calls_per_minute (`Optional[float]`, defaults to `None`):
+                The rate limit of the model calls, which is shared by all the
+                comparers using the same model configuration.
+            checkpoint_path (`Optional[str]`, defaults to `None`):
+                The path of a JSON lines file to record the completed
+                results. If the file exists, the completed results in it are
+                yielded first and not inferred again, so that an interrupted
+                comparison can be resumed.
+
+        Yields:
+            `dict`: The result with keys `"query_index"`, `"query"`,
+            `"prompt_index"`, `"system_prompt"` and `"response"`. If the model
+            call fails, the error message is recorded in `"error"` instead,
+            and it's not written into the checkpoint.
+        """
+        completed = _load_checkpoint(checkpoint_path)
+
+        limiter = None
+        if calls_per_minute is not None:
+            limiter = _RateLimiter.get(
+                self.model_config_name,
+                calls_per_minute,
             )
-        return {
-            "query": query,
-            "results": results,
-        }
+
+        def _run(query_index: int, prompt_index: int) -> dict:
+            system_prompt = self.compared_system_prompts[prompt_index]
+            query = queries[query_index]
+            result = {
+                "query_index": query_index,
+                "query": query,
+                "prompt_index": prompt_index,
+                "system_prompt": system_prompt,
+            }
+            if limiter is not None:
+                limiter.acquire()
+            try:
+                result["response"] = self._infer(system_prompt, query)
+            except Exception as e:
+                logger.error(
+                    f"Fail to infer query {query_index} with system prompt "
+                    f"{prompt_index}: {e}",
+                )
+                result["error"] = str(e)
+            return result
+
+        pending = []
+        for query_index, query in enumerate(queries):
+            for prompt_index, system_prompt in enumerate(
+                self.compared_system_prompts,
+            ):
+                key = (system_prompt, query)
+                if key in completed:
+                    yield {
+                        "query_index": query_index,
+                        "query": query,
+                        "prompt_index": prompt_index,
+                        "system_prompt": system_prompt,
+                        "response": completed[key],
+                    }
+                else:
+                    pending.append((query_index, prompt_index))
+
+        if len(pending) == 0:
+            return
+
+        checkpoint_file = None
+        if checkpoint_path is not None:
+            checkpoint_file = open(  # pylint: disable=R1732
+                checkpoint_path,
+                "a",
+                encoding="utf-8",
+            )
+
+        executor = ThreadPoolExecutor(
+            max_workers=max(1, max_workers),
+            thread_name_prefix="prompt_comparer",
+        )
+        futures = [executor.submit(_run, *_) for _ in pending]
+        try:
+            for future in as_completed(futures):
+                result = future.result()
+                if checkpoint_file is not None and "error" not in result:
+                    record = {
+                        "system_prompt": result["system_prompt"],
+                        "query": result["query"],
+                        "response": result["response"],
+                    }
+                    checkpoint_file.write(
+                        json.dumps(record, ensure_ascii=False) + "\n",
+                    )
+                    checkpoint_file.flush()
+                yield result
+        finally:
+            # Cancel the pending calls if the generator is closed early
+            executor.shutdown(wait=True, cancel_futures=True)
+            if checkpoint_file is not None:
+                checkpoint_file.close()
 
     def _set_display_status(self, status: bool) -> None:
         """Set the display status of all agents."""
@@ -122,41 +298,67 @@ class SystemPromptComparer:
             else:
                 agent.disable_display()
 
-    def compare_with_queries(self, queries: List[str]) -> List[dict]:
-        """Compare different system prompts a list of input queries.
+    def compare_with_queries(
+        self,
+        queries: List[str],
+        max_workers: int = 4,
+        calls_per_minute: Optional[float] = None,
+        checkpoint_path: Optional[str] = None,
+    ) -> List[dict]:
+        """Compare different system prompts a list of input queries. The
+        pairs of system prompts and queries are inferred concurrently, see
+        `iter_compare_with_queries` for details.
 
         Args:
             queries (`List[str]`):
                 A list of input queries that will be used to compare different
                 system prompts.
+            max_workers (`int`, defaults to `4`):
+                The maximum number of concurrent model calls.
+            calls_per_minute (`Optional[float]`, defaults to `None`):
+                The rate limit of the model calls.
+            checkpoint_path (`Optional[str]`, defaults to `None`):
+                The path of a JSON lines file to record and resume the
+                completed results.
 
         Returns:
             `List[dict]`: A list of responses of the queries with different
             system prompts.
         """
+        query_results = [
+            {
+                "query": query,
+                "results": [None] * len(self.compared_system_prompts),
+            }
+            for query in queries
+        ]
 
-        self._set_display_status(False)
-
-        query_results = []
-        for index, query in enumerate(queries):
-            # Print the query
-            logger.info(f"## Query {index}:\n{query}")
-            res = self._compare_with_query(query)
-
-            for index_prompt, _ in enumerate(res["results"]):
-                logger.info(
-                    f"### System Prompt {index_prompt}\n"
-                    f"```\n"
-                    f"{_['system_prompt']}\n"
-                    f"```\n"
-                    f"\n"
-                    f"### Response\n"
-                    f"{_['response']}\n",
-                )
-
-            query_results.append(res)
+        for res in self.iter_compare_with_queries(
+            queries,
+            max_workers=max_workers,
+            calls_per_minute=calls_per_minute,
+            checkpoint_path=checkpoint_path,
+        ):
+            logger.info(
+                f"## Query {res['query_index']}:\n{res['query']}\n"
+                f"### System Prompt {res['prompt_index']}\n"
+                f"```\n"
+                f"{res['system_prompt']}\n"
+                f"```\n"
+                f"\n"
+                f"### Response\n"
+                f"{res.get('response', res.get('error'))}\n",
+            )
 
-        self._clear_memories()
+            result = {
+                "system_prompt": res["system_prompt"],
+                "response": res.get("response", None),
+            }
+            if "error" in res:
+                result["error"] = res["error"]
+            query_results[res["query_index"]]["results"][
+                res["prompt_index"]
+            ] = result
 
         return query_results
 
@@ -6,8 +6,8 @@ import random
 
 from typing import Any, List, Literal, Optional, Union
 
+import numpy as np
 from loguru import logger
-from tqdm import tqdm
 
 from agentscope.file_manager import file_manager
 from agentscope.message import Msg
@@ -15,8 +15,10 @@ from agentscope.models import (
     load_model_by_config_name,
     load_config_by_name,
     ModelResponse,
+    ModelWrapperBase,
+    EmbeddingBatcher,
 )
-from agentscope.prompt._prompt_utils import _find_top_k_embeddings
+from agentscope.prompt._prompt_utils import _EmbeddingIndex
 
 
 class _SentencePieceEmbeddingModel:
@@ -57,7 +59,9 @@ class _SentencePieceEmbeddingModel:
             logger.info("Finish loading the local embedding model.")
 
         embedding = self.model.encode(queries)
-        return ModelResponse(embedding=[embedding])
+        if isinstance(queries, str):
+            return ModelResponse(embedding=[embedding])
+        return ModelResponse(embedding=list(embedding))
 
 
 class SystemPromptGeneratorBase(ABC):
@@ -123,6 +127,7 @@ class SystemPromptGeneratorBase(ABC):
         # Used to cache the embeddings of the examples.
         self.embed_model_name = None
         self.example_embeddings = None
+        self.example_index = None
         self.local_embedding_model = local_embedding_model
         # Load embed model if needed
         if (
@@ -148,6 +153,7 @@ class SystemPromptGeneratorBase(ABC):
                 )
 
             self.example_embeddings = self._generate_embeddings()
+            self.example_index = _EmbeddingIndex(self.example_embeddings)
 
     def _get_example_prompt(self, examples: List[dict]) -> str:
         """Get the prompt examples"""
@@ -194,11 +200,8 @@ class SystemPromptGeneratorBase(ABC):
         # Get the human query embd using the embedding model
         human_query_embd = self.embed_model(user_prompt).embedding[0]
 
-        # TODO: use the retrieval service instead rather than achieving it
-        #  locally
-        selected_indices = _find_top_k_embeddings(
+        selected_indices = self.example_index.search(
             human_query_embd,
-            self.example_embeddings,
             self.example_num,
         )
 
@@ -211,29 +214,59 @@ class SystemPromptGeneratorBase(ABC):
             self.example_num,
         )
 
-    def _generate_embeddings(self) -> List:
-        """Generate embeddings for the examples."""
-        example_embeddings = []
-        for example in tqdm(self.example_list, desc="Generating embeddings"):
-            user_prompt = example["user_prompt"]
+    def _generate_embeddings(self) -> np.ndarray:
+        """Generate the embedding matrix of the examples. The whole matrix
+        is loaded from the embedding cache if it's cached, otherwise the
+        examples missing in the cache are embedded in batches."""
+        texts = [_["user_prompt"] for _ in self.example_list]
 
-            # Load cached embedding instead of generating them again
-            cached_embedding = file_manager.fetch_cached_text_embedding(
-                text=user_prompt,
+        matrix = file_manager.fetch_cached_embedding_matrix(
+            texts=texts,
+            embedding_model=self.embed_model_name,
+        )
+        if matrix is not None:
+            return matrix
+
+        # Load cached embedding instead of generating them again
+        embeddings = [
+            file_manager.fetch_cached_text_embedding(
+                text=_,
                 embedding_model=self.embed_model_name,
             )
-            if cached_embedding is None:
-                new_embedding = self.embed_model(user_prompt).embedding[0]
-                example_embeddings.append(new_embedding)
+            for _ in texts
+        ]
+        missing_indices = [i for i, _ in enumerate(embeddings) if _ is None]
+
+        if len(missing_indices) > 0:
+            logger.info(
+                f"Generating embeddings for {len(missing_indices)} examples.",
+            )
+            new_embeddings = self._embed([texts[_] for _ in missing_indices])
+            for index, embedding in zip(missing_indices, new_embeddings):
+                embeddings[index] = embedding
                 # Cache the embedding
                 file_manager.cache_text_embedding(
-                    text=user_prompt,
-                    embedding=new_embedding,
+                    text=texts[index],
+                    embedding=embedding,
                     embedding_model=self.embed_model_name,
                 )
-            else:
-                example_embeddings.append(cached_embedding)
-        return example_embeddings
+
+        matrix = np.asarray(embeddings, dtype=np.float32)
+        file_manager.cache_embedding_matrix(
+            texts=texts,
+            matrix=matrix,
+            embedding_model=self.embed_model_name,
+        )
+        return matrix
+
+    def _embed(self, texts: List[str]) -> List:
+        """Embed the texts in batches."""
+        if isinstance(self.embed_model, ModelWrapperBase):
+            # Split the texts by the batch size limit of the provider
+            return EmbeddingBatcher.get_batcher(self.embed_model)(
+                texts,
+            ).embedding
+        return self.embed_model(texts).embedding
 
     def generate(self, user_input: str) -> str:
         """Generate (optimized) system prompt according to the user input,
@@ -1,12 +1,68 @@
 # -*- coding: utf-8 -*-
 """Utility functions for prompt optimization."""
 import json
-from typing import List
+from typing import List, Sequence, Union
 
 from pathlib import Path
 import numpy as np
 
-from scipy.spatial.distance import cdist
+
+def _top_k_indices(scores: np.ndarray, k: int) -> List[int]:
+    """Get the indices of the top k scores in descending order. Only the top
+    k scores are sorted after being selected by `argpartition`."""
+    k = min(k, len(scores))
+    if k <= 0:
+        return []
+    if k < len(scores):
+        indices = np.argpartition(-scores, k - 1)[:k]
+    else:
+        indices = np.arange(len(scores))
+    return indices[np.argsort(-scores[indices], kind="stable")].tolist()
+
+
+class _EmbeddingIndex:
+    """An in-memory index of embeddings, stored as a float32 matrix with
+    normalized rows, so that a query is searched by a single matrix-vector
+    product."""
+
+    def __init__(
+        self,
+        embeddings: Union[np.ndarray, Sequence[Sequence[float]]],
+    ) -> None:
+        """Build the index.
+
+        Args:
+            embeddings (`Union[np.ndarray, Sequence[Sequence[float]]]`):
+                The embeddings to be searched.
+        """
+        matrix = np.asarray(embeddings, dtype=np.float32)
+        norms = np.linalg.norm(matrix, axis=1, keepdims=True)
+        self.matrix = matrix / np.maximum(norms, 1e-12)
+
+    def __len__(self) -> int:
+        return len(self.matrix)
+
+    def search(
+        self,
+        query_embedding: Union[np.ndarray, Sequence[float]],
+        k: int,
+    ) -> List[int]:
+        """Search the top k embeddings by cosine similarity.
+
+        Args:
+            query_embedding (`Union[np.ndarray, Sequence[float]]`):
+                The query to be searched.
+            k (`int`):
+                The number of embeddings to be returned.
+
+        Returns:
+            `List[int]`:
+                The indices of the top k embeddings, in descending order of
+                similarity.
+        """
+        query = np.asarray(query_embedding, dtype=np.float32).ravel()
+        query = query / max(float(np.linalg.norm(query)), 1e-12)
+        return _top_k_indices(self.matrix @ query, k)
 
 
 def _find_top_k_embeddings(
@@ -28,17 +84,7 @@ def _find_top_k_embeddings(
         `List`:
             the list of indices of the top k embeddings.
     """
-    # Compute cosine similarity between the query and the list of embeddings.
-    # cdist returns the distance of 2-dimension arrays,
-    # so we subtract from 1 to get similarity.
-    # Cosine distance is defined as 1.0 minus the cosine similarity.
-
-    similarities = (
-        1 - cdist([query_embedding], list_embeddings, "cosine").flatten()
-    )
-
-    # Get the top k indices sorted by similarity (in descending order).
-    return list(np.argsort(similarities)[::-1][:k])
+    return _EmbeddingIndex(list_embeddings).search(query_embedding, k)
 
 
 def _read_json_same_dir(file_name: str) -> dict:
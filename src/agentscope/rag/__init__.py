@@ -3,9 +3,15 @@
 from .knowledge import Knowledge
 from .llama_index_knowledge import LlamaIndexKnowledge
 from .knowledge_bank import KnowledgeBank
+from .mmap_vector_store import MmapVectorStore
+from .bm25_index import BM25Index
+from .reranker import Reranker
 
 __all__ = [
     "Knowledge",
     "LlamaIndexKnowledge",
     "KnowledgeBank",
+    "MmapVectorStore",
+    "BM25Index",
+    "Reranker",
 ]
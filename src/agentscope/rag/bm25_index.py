@@ -0,0 +1,334 @@
+# -*- coding: utf-8 -*-
+"""
+A sparse inverted index scoring the chunks by BM25, which answers keyword
+and identifier lookups without embedding the query. The identifiers in
+code, e.g. `get_user_name` or `getUserName`, are indexed both as a whole
+and by their parts.
+"""
+import json
+import math
+import os
+import re
+import threading
+from collections import Counter
+from typing import List, Optional, Sequence, Tuple
+
+import numpy as np
+from loguru import logger
+
+_INDEX_FILE = "bm25_index.json"
+
+# words, identifiers and numbers, and each CJK character as a token
+_TOKEN_PATTERN = re.compile(r"[A-Za-z0-9_]+|[\u4e00-\u9fff]")
+_IDENTIFIER_PART_PATTERN = re.compile(
+    r"[A-Z]+(?=[A-Z][a-z])|[A-Z]?[a-z]+|[A-Z]+|[0-9]+",
+)
+
+
+def tokenize(text: str) -> List[str]:
+    """
+    Split the text into lowercase tokens. An identifier joined by
+    underscores or in camel case is kept as a token, followed by its parts.
+
+    Args:
+        text (str): the text to be tokenized.
+    """
+    tokens = []
+    for token in _TOKEN_PATTERN.findall(text):
+        tokens.append(token.lower())
+        parts = _IDENTIFIER_PART_PATTERN.findall(token)
+        if len(parts) > 1:
+            tokens.extend(_.lower() for _ in parts)
+    return tokens
+
+
+class BM25Index:
+    """
+    An inverted index of the chunks of a knowledge, scored by Okapi BM25.
+    The persisted index is loaded lazily on the first access, and the
+    changes are kept in memory until `persist` rewrites the file, where the
+    deleted chunks are dropped.
+
+    Example:
+
+        .. code-block:: python
+
+            index = BM25Index("./rag_storage/my_knowledge")
+            index.add(["node1"], ["doc1"], ["def get_user_name(): ..."])
+            ids, scores = index.query("get_user_name", top_k=5)
+    """
+
+    def __init__(
+        self,
+        persist_dir: str,
+        k1: float = 1.2,
+        b: float = 0.75,
+    ) -> None:
+        """
+        Initialize the index without reading the file.
+
+        Args:
+            persist_dir (str):
+                The directory of the persisted index.
+            k1 (float):
+                The saturation of the term frequency.
+            b (float):
+                The normalization by the length of the chunk.
+        """
+        self.persist_dir = persist_dir
+        self.k1 = k1
+        self.b = b
+
+        self._lock = threading.Lock()
+        self._loaded = False
+        self._dirty = False
+        self._ids: List[str] = []
+        self._ref_doc_ids: List[Optional[str]] = []
+        self._lengths: List[int] = []
+        self._alive: List[bool] = []
+        self._rows: dict = {}
+        self._ref_doc_rows: dict = {}
+        self._total_length = 0
+        # the rows containing each term and the term frequencies in them
+        self._postings: dict = {}
+        # the postings as numpy arrays, converted on query
+        self._arrays: dict = {}
+        # the lengths and the alive mask of the rows as numpy arrays
+        self._row_arrays: Optional[Tuple[np.ndarray, np.ndarray]] = None
+
+    @staticmethod
+    def exists(persist_dir: str) -> bool:
+        """Whether the index is persisted in the directory."""
+        return os.path.exists(os.path.join(persist_dir, _INDEX_FILE))
+
+    def __len__(self) -> int:
+        with self._lock:
+            self._load()
+            return len(self._rows)
+
+    def _load(self) -> None:
+        """Load the persisted index if not loaded yet."""
+        if self._loaded:
+            return
+        self._loaded = True
+        if not self.exists(self.persist_dir):
+            return
+        with open(
+            os.path.join(self.persist_dir, _INDEX_FILE),
+            "r",
+            encoding="utf-8",
+        ) as f:
+            data = json.load(f)
+        self._ids = data["ids"]
+        self._ref_doc_ids = data["ref_doc_ids"]
+        self._lengths = data["lengths"]
+        self._alive = [True] * len(self._ids)
+        self._total_length = sum(self._lengths)
+        self._postings = {
+            term: (rows, tfs) for term, (rows, tfs) in data["postings"].items()
+        }
+        for row, (node_id, ref_doc_id) in enumerate(
+            zip(self._ids, self._ref_doc_ids),
+        ):
+            self._rows[node_id] = row
+            self._ref_doc_rows.setdefault(ref_doc_id, []).append(row)
+        logger.info(
+            f"bm25 index loaded from {self.persist_dir} "
+            f"with {len(self._ids)} chunks",
+        )
+
+    def add(
+        self,
+        ids: Sequence[str],
+        ref_doc_ids: Sequence[Optional[str]],
+        texts: Sequence[str],
+    ) -> None:
+        """
+        Add the chunks, replacing the existing ones with the same ids.
+
+        Args:
+            ids (Sequence[str]): the ids of the nodes.
+            ref_doc_ids (Sequence[Optional[str]]): the ids of the documents
+                of the nodes.
+            texts (Sequence[str]): the texts of the nodes.
+        """
+        with self._lock:
+            self._load()
+            for node_id, ref_doc_id, text in zip(ids, ref_doc_ids, texts):
+                if node_id in self._rows:
+                    self._delete_row(self._rows[node_id])
+                tokens = tokenize(text)
+                row = len(self._ids)
+                self._ids.append(node_id)
+                self._ref_doc_ids.append(ref_doc_id)
+                self._lengths.append(len(tokens))
+                self._alive.append(True)
+                self._total_length += len(tokens)
+                self._rows[node_id] = row
+                self._ref_doc_rows.setdefault(ref_doc_id, []).append(row)
+                for term, tf in Counter(tokens).items():
+                    rows, tfs = self._postings.setdefault(term, ([], []))
+                    rows.append(row)
+                    tfs.append(tf)
+                    self._arrays.pop(term, None)
+            self._row_arrays = None
+            self._dirty = True
+
+    def delete_ref_doc(self, ref_doc_id: str) -> None:
+        """
+        Delete the chunks of a document.
+
+        Args:
+            ref_doc_id (str): the id of the document.
+        """
+        with self._lock:
+            self._load()
+            for row in self._ref_doc_rows.pop(ref_doc_id, []):
+                self._delete_row(row)
+            self._row_arrays = None
+            self._dirty = True
+
+    def _delete_row(self, row: int) -> None:
+        """Mark a row as deleted, which is dropped when persisting."""
+        if not self._alive[row]:
+            return
+        self._alive[row] = False
+        self._total_length -= self._lengths[row]
+        if self._rows.get(self._ids[row]) == row:
+            del self._rows[self._ids[row]]
+
+    def query(
+        self,
+        query: str,
+        top_k: int,
+        normalize: bool = False,
+    ) -> Tuple[List[str], List[float]]:
+        """
+        Get the chunks with the highest BM25 scores for the query.
+
+        Args:
+            query (str): the query.
+            top_k (int): the number of chunks to return.
+            normalize (bool): whether to divide the scores by the sum of
+                the highest score of each query term among the chunks, so
+                that they're in [0, 1], and a chunk matching every term as
+                well as the best matching chunk of that term scores 1.
+
+        Returns:
+            Tuple[List[str], List[float]]: the ids of the nodes and their
+            scores in descending order, excluding the ones not matching
+            any term of the query.
+        """
+        terms = set(tokenize(query))
+        with self._lock:
+            self._load()
+            n_docs = len(self._rows)
+            if n_docs == 0 or top_k <= 0:
+                return [], []
+            if self._row_arrays is None:
+                self._row_arrays = (
+                    np.asarray(self._lengths, dtype=np.float32),
+                    np.asarray(self._alive, dtype=bool),
+                )
+            lengths, alive = self._row_arrays
+            avg_length = max(self._total_length / n_docs, 1.0)
+            norms = self.k1 * (1 - self.b + self.b * lengths / avg_length)
+            scores = np.zeros(len(self._ids), dtype=np.float32)
+            max_score = 0.0
+            for term in terms:
+                if term not in self._postings:
+                    continue
+                if term not in self._arrays:
+                    rows, tfs = self._postings[term]
+                    self._arrays[term] = (
+                        np.asarray(rows, dtype=np.int64),
+                        np.asarray(tfs, dtype=np.float32),
+                    )
+                rows, tfs = self._arrays[term]
+                # the deleted rows are kept until persisting
+                df = int(np.count_nonzero(alive[rows]))
+                if df == 0:
+                    continue
+                idf = math.log(1 + (n_docs - df + 0.5) / (df + 0.5))
+                term_scores = idf * tfs * (self.k1 + 1) / (tfs + norms[rows])
+                scores[rows] += term_scores
+                max_score += float(term_scores[alive[rows]].max())
+            scores[~alive] = 0
+            if normalize and max_score > 0:
+                scores /= max_score
+            ids = self._ids
+
+        matched = np.flatnonzero(scores > 0)
+        if len(matched) > top_k:
+            top = np.argpartition(-scores[matched], top_k - 1)[:top_k]
+            matched = matched[top]
+        matched = matched[np.argsort(-scores[matched], kind="stable")]
+        return (
+            [ids[_] for _ in matched],
+            scores[matched].astype(float).tolist(),
+        )
+
+    def persist(self, persist_dir: Optional[str] = None) -> None:
+        """
+        Rewrite the file with the deleted chunks dropped. Nothing is written
+        if the index is unchanged since it's persisted.
+
+        Args:
+            persist_dir (Optional[str]): the directory to persist, defaults
+                to the directory of the index.
+        """
+        persist_dir = persist_dir or self.persist_dir
+        with self._lock:
+            self._load()
+            if (
+                not self._dirty
+                and os.path.abspath(persist_dir)
+                == os.path.abspath(self.persist_dir)
+                and self.exists(persist_dir)
+            ):
+                return
+            if not all(self._alive):
+                self._compact()
+            data = {
+                "ids": self._ids,
+                "ref_doc_ids": self._ref_doc_ids,
+                "lengths": self._lengths,
+                "postings": self._postings,
+            }
+            os.makedirs(persist_dir, exist_ok=True)
+            path = os.path.join(persist_dir, _INDEX_FILE)
+            with open(path + ".tmp", "w", encoding="utf-8") as f:
+                json.dump(data, f)
+            os.replace(path + ".tmp", path)
+            self.persist_dir = persist_dir
+            self._dirty = False
+        logger.info(
+            f"bm25 index persisted to {persist_dir} "
+            f"with {len(self._ids)} chunks",
+        )
+
+    def _compact(self) -> None:
+        """Drop the deleted rows and renumber the rest."""
+        alive = [row for row, _ in enumerate(self._alive) if _]
+        new_rows = {row: i for i, row in enumerate(alive)}
+        postings = {}
+        for term, (rows, tfs) in self._postings.items():
+            kept = [
+                (new_rows[row], tf)
+                for row, tf in zip(rows, tfs)
+                if row in new_rows
+            ]
+            if kept:
+                postings[term] = ([_[0] for _ in kept], [_[1] for _ in kept])
+        self._ids = [self._ids[_] for _ in alive]
+        self._ref_doc_ids = [self._ref_doc_ids[_] for _ in alive]
+        self._lengths = [self._lengths[_] for _ in alive]
+        self._alive = [True] * len(alive)
+        self._postings, self._arrays = postings, {}
+        self._row_arrays = None
+        self._rows, self._ref_doc_rows = {}, {}
+        for row, (node_id, ref_doc_id) in enumerate(
+            zip(self._ids, self._ref_doc_ids),
+        ):
+            self._rows[node_id] = row
+            self._ref_doc_rows.setdefault(ref_doc_id, []).append(row)
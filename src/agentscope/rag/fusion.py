@@ -0,0 +1,139 @@
+# -*- coding: utf-8 -*-
+"""
+Fusion of the ranked results retrieved from multiple sources, e.g. several
+knowledge, into a single ranking, with the near-identical chunks merged.
+"""
+import re
+from typing import Any, Callable, List, Optional, Sequence, Tuple
+
+from agentscope.constants import (
+    DEFAULT_DEDUP_THRESHOLD,
+    DEFAULT_RRF_K,
+)
+
+
+def fuse_results(
+    ranked_lists: Sequence[Sequence[Any]],
+    get_text: Callable[[Any], str],
+    get_score: Optional[Callable[[Any], Optional[float]]] = None,
+    method: str = "rrf",
+    rrf_k: int = DEFAULT_RRF_K,
+    dedup_threshold: Optional[float] = DEFAULT_DEDUP_THRESHOLD,
+    weights: Optional[Sequence[float]] = None,
+) -> List[Tuple[Any, float]]:
+    """
+    Fuse the ranked results of multiple sources. The near-identical results
+    are merged into the first one of them, so a chunk retrieved by several
+    sources gathers their contributions.
+
+    Args:
+        ranked_lists (`Sequence[Sequence[Any]]`):
+            The results of each source, in descending order of relevance.
+        get_text (`Callable[[Any], str]`):
+            The function to get the text of a result.
+        get_score (`Optional[Callable[[Any], Optional[float]]]`, defaults to
+        `None`):
+            The function to get the score of a result, which is required by
+            the "score" and "weighted" methods.
+        method (`str`, defaults to `"rrf"`):
+            "rrf" for reciprocal rank fusion, i.e., a result scores
+            `1 / (rrf_k + rank)` in each source, which doesn't depend on the
+            scales of the scores; "score" to rank the results by their
+            highest scores, which requires the scores of the sources to be
+            comparable, e.g. from the same embedding model; "weighted" to
+            sum the scores min-max normalized in each source, e.g. to
+            combine the BM25 and the similarity scores.
+        rrf_k (`int`, defaults to `60`):
+            The constant of reciprocal rank fusion, where a larger value
+            makes the lower ranks weigh more.
+        dedup_threshold (`Optional[float]`, defaults to `0.9`):
+            The Jaccard similarity of the words, above which two results are
+            considered near-identical. None to only merge the identical
+            results.
+        weights (`Optional[Sequence[float]]`, defaults to `None`):
+            The weights of the sources in the "rrf" and "weighted" methods,
+            defaults to 1 for each.
+
+    Returns:
+        `List[Tuple[Any, float]]`: The fused results and their scores, in
+        descending order of the scores.
+    """
+    if method not in ("rrf", "score", "weighted"):
+        raise ValueError(f"Unsupported fusion method {method}.")
+    if method != "rrf" and get_score is None:
+        raise ValueError(f"The {method} fusion requires get_score.")
+    if weights is None:
+        weights = [1.0] * len(ranked_lists)
+
+    # the merged results, their word sets and fused scores
+    results: List[Any] = []
+    words: List[frozenset] = []
+    scores: List[float] = []
+    exact: dict = {}
+    for ranked, weight in zip(ranked_lists, weights):
+        if method == "rrf":
+            source_scores = [
+                weight / (rrf_k + rank + 1) for rank in range(len(ranked))
+            ]
+        else:
+            source_scores = [get_score(_) for _ in ranked]
+            source_scores = [
+                float("-inf") if _ is None else _ for _ in source_scores
+            ]
+            if method == "weighted":
+                source_scores = [
+                    weight * _ for _ in _min_max_normalize(source_scores)
+                ]
+        for item, score in zip(ranked, source_scores):
+            text = _normalize(get_text(item))
+            index = exact.get(text)
+            if index is None and dedup_threshold is not None:
+                index = _find_near_duplicate(
+                    frozenset(text.split()),
+                    words,
+                    dedup_threshold,
+                )
+            if index is None:
+                exact[text] = len(results)
+                results.append(item)
+                words.append(frozenset(text.split()))
+                scores.append(score)
+            elif method != "score":
+                scores[index] += score
+            elif score > scores[index]:
+                scores[index] = score
+
+    order = sorted(range(len(results)), key=lambda _: -scores[_])
+    return [(results[_], scores[_]) for _ in order]
+
+
+def _min_max_normalize(scores: List[float]) -> List[float]:
+    """Scale the scores into [0, 1], where the missing scores are 0."""
+    valid = [_ for _ in scores if _ != float("-inf")]
+    if len(valid) == 0:
+        return [0.0] * len(scores)
+    low, high = min(valid), max(valid)
+    return [
+        0.0
+        if _ == float("-inf")
+        else (1.0 if high == low else (_ - low) / (high - low))
+        for _ in scores
+    ]
+
+
+def _normalize(text: str) -> str:
+    """Lowercase the text and collapse the whitespaces."""
+    return re.sub(r"\s+", " ", text).strip().lower()
+
+
+def _find_near_duplicate(
+    text_words: frozenset,
+    words: List[frozenset],
+    threshold: float,
+) -> Optional[int]:
+    """Find the first result whose words are similar to the given ones."""
+    for index, other in enumerate(words):
+        union = len(text_words | other)
+        if union > 0 and len(text_words & other) / union >= threshold:
+            return index
+    return None
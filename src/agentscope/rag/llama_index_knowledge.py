@@ -1,15 +1,22 @@
 # -*- coding: utf-8 -*-
+# pylint: disable=too-many-lines
 """
 This module is an integration of the Llama index RAG
 into AgentScope package
 """
 
+import hashlib
+import inspect
 import os.path
+import threading
+import time
+from concurrent.futures import ThreadPoolExecutor
 from typing import Any, Optional, List, Union
 from loguru import logger
 
 try:
     import llama_index
+    from tqdm import tqdm
     from llama_index.core.base.base_retriever import BaseRetriever
     from llama_index.core.base.embeddings.base import (
         BaseEmbedding,
@@ -25,11 +32,16 @@ try:
         load_index_from_storage,
     )
     from llama_index.core.schema import (
+        BaseNode,
         Document,
+        MetadataMode,
+        NodeWithScore,
+        QueryBundle,
         TransformComponent,
     )
 except ImportError:
     llama_index = None
+    tqdm = None
     BaseRetriever = None
     BaseEmbedding = None
     Embedding = None
@@ -39,17 +51,30 @@ except ImportError:
     StorageContext = None
     load_index_from_storage = None
     PrivateAttr = None
+    BaseNode = None
     Document = None
+    MetadataMode = None
+    NodeWithScore = None
+    QueryBundle = None
     TransformComponent = None
 
 from agentscope.file_manager import file_manager
-from agentscope.models import ModelWrapperBase
+from agentscope.models import ModelWrapperBase, EmbeddingBatcher
 from agentscope.constants import (
     DEFAULT_TOP_K,
     DEFAULT_CHUNK_SIZE,
     DEFAULT_CHUNK_OVERLAP,
+    DEFAULT_EMBED_CONCURRENCY,
+    DEFAULT_DOCS_PER_WORKER,
 )
+from agentscope.rag.bm25_index import BM25Index
+from agentscope.rag.fusion import fuse_results
 from agentscope.rag.knowledge import Knowledge
+from agentscope.rag.reranker import Reranker
+from agentscope.rag.mmap_vector_store import (
+    MmapEmbeddingStore,
+    MmapVectorStore,
+)
 
 
 try:
@@ -65,7 +90,7 @@ try:
         def __init__(
             self,
             emb_model: ModelWrapperBase,
-            embed_batch_size: int = 1,
+            embed_batch_size: Optional[int] = None,
         ) -> None:
             """
             Dummy wrapper to convert a ModelWrapperBase to llama Index
@@ -74,14 +99,18 @@ try:
             Args:
                 emb_model (ModelWrapperBase):
                     embedding model in ModelWrapperBase
-                embed_batch_size (int):
-                    batch size, defaults to 1
+                embed_batch_size (Optional[int]):
+                    the number of texts embedded in one call, defaults to
+                    the max batch size of the embedding model
             """
+            # coalesce the embedding requests from different threads and
+            # knowledge into provider-sized batches
+            batcher = EmbeddingBatcher.get_batcher(emb_model)
             super().__init__(
                 model_name="Temporary_embedding_wrapper",
-                embed_batch_size=embed_batch_size,
+                embed_batch_size=embed_batch_size or batcher.max_batch_size,
             )
-            self._emb_model_wrapper = emb_model
+            self._emb_model_wrapper = batcher
 
         def _get_query_embedding(self, query: str) -> List[float]:
             """
@@ -99,10 +128,8 @@ try:
             Args:
                  texts ( List[str]): texts to be embedded
             """
-            results = [
-                list(self._emb_model_wrapper(t).embedding[0]) for t in texts
-            ]
-            return results
+            embeddings = self._emb_model_wrapper(texts).embedding
+            return [list(_) for _ in embeddings]
 
         def _get_text_embedding(self, text: str) -> Embedding:
             """
@@ -154,6 +181,9 @@ class LlamaIndexKnowledge(Knowledge):
         persist_root: Optional[str] = None,
         overwrite_index: Optional[bool] = False,
         showprogress: Optional[bool] = True,
+        num_workers: Optional[int] = None,
+        embed_batch_size: Optional[int] = None,
+        embed_concurrency: int = DEFAULT_EMBED_CONCURRENCY,
         **kwargs: Any,
     ) -> None:
         """
@@ -187,6 +217,26 @@ class LlamaIndexKnowledge(Knowledge):
                 Whether to overwrite the index while refreshing
             showprogress (Optional[bool]):
                 Whether to show the indexing progress
+            num_workers (Optional[int]):
+                The maximum number of processes to load and split the
+                documents, defaults to the number of CPUs. A process is
+                used for every `DEFAULT_DOCS_PER_WORKER` files or documents
+                at least, so a small knowledge is processed in one process.
+            embed_batch_size (Optional[int]):
+                The number of chunks embedded in one call, defaults to the
+                max batch size of the embedding model. Only used when
+                emb_model is a ModelWrapperBase.
+            embed_concurrency (int):
+                The maximum number of embedding batches in flight.
+
+        Notes:
+            The "bm25" field of knowledge_config keeps a BM25 index of the
+            chunks alongside the vector index, e.g., {"mode": "hybrid",
+            "fusion": "weighted", "weights": [0.7, 0.3], "k1": 1.2,
+            "b": 0.75}, or True for the defaults. The "mode" is the default
+            mode of retrieve, which is "dense", "sparse" or "hybrid", and
+            "fusion" and "weights" (dense first) are how the hybrid mode
+            fuses the results, see `fuse_results`.
         """
         super().__init__(
             knowledge_id=knowledge_id,
@@ -208,10 +258,21 @@ class LlamaIndexKnowledge(Knowledge):
         self.emb_model = emb_model
         self.overwrite_index = overwrite_index
         self.showprogress = showprogress
+        self.num_workers = num_workers
+        self.embed_concurrency = max(1, embed_concurrency)
+        # the counts and seconds of the stages of the last ingestion
+        self.ingestion_metrics: dict = {}
         self.index = None
+        # the retrievers of the index by similarity_top_k
+        self._retrievers: dict = {}
+        self._retrievers_lock = threading.Lock()
+        self._init_bm25()
         # ensure the emb_model is compatible with LlamaIndex
         if isinstance(emb_model, ModelWrapperBase):
-            self.emb_model = _EmbeddingModel(emb_model)
+            self.emb_model = _EmbeddingModel(
+                emb_model,
+                embed_batch_size=embed_batch_size,
+            )
         elif isinstance(self.emb_model, BaseEmbedding):
             pass
         else:
@@ -221,6 +282,28 @@ class LlamaIndexKnowledge(Knowledge):
         # then we can initialize the RAG
         self._init_rag()
 
+    def _init_bm25(self) -> None:
+        """
+        Initialize the BM25 index and the retrieval mode by the "bm25"
+        field of knowledge_config.
+        """
+        config = self.knowledge_config.get("bm25")
+        self.bm25_index = None
+        self.retrieval_mode = "dense"
+        self.hybrid_fusion = "rrf"
+        self.hybrid_weights = None
+        if not config:
+            return
+        config = {} if config is True else dict(config)
+        self.retrieval_mode = config.pop("mode", "hybrid")
+        self.hybrid_fusion = config.pop("fusion", self.hybrid_fusion)
+        self.hybrid_weights = config.pop("weights", None)
+        if self.retrieval_mode not in ("dense", "sparse", "hybrid"):
+            raise ValueError(
+                f"Unsupported retrieval mode {self.retrieval_mode}.",
+            )
+        self.bm25_index = BM25Index(self.persist_dir, **config)
+
     def _init_rag(self, **kwargs: Any) -> None:
         """
         Initialize the RAG. This includes:
@@ -251,16 +334,35 @@ class LlamaIndexKnowledge(Knowledge):
         """
         Load the persisted index from persist_dir.
         """
+        vector_store = self._get_vector_store()
+        if vector_store is not None and not MmapEmbeddingStore.exists(
+            self.persist_dir,
+        ):
+            logger.warning(
+                f"the index in {self.persist_dir} is persisted with the "
+                f"default vector store, which is used instead.",
+            )
+            vector_store = None
         # load the storage_context
         storage_context = StorageContext.from_defaults(
             persist_dir=self.persist_dir,
+            vector_store=vector_store,
         )
         # construct index from
         self.index = load_index_from_storage(
             storage_context=storage_context,
             embed_model=self.emb_model,
         )
+        self._retrievers = {}
         logger.info(f"index loaded from {self.persist_dir}")
+        if self.bm25_index is not None and not BM25Index.exists(
+            self.persist_dir,
+        ):
+            logger.info(f"building bm25 index for {self.persist_dir}")
+            self._add_nodes_to_bm25(
+                list(self.index.docstore.docs.values()),
+            )
+            self.bm25_index.persist()
 
     def _data_to_index(self) -> None:
         """
@@ -268,35 +370,111 @@ class LlamaIndexKnowledge(Knowledge):
             * load the data to documents by using information from configs
             * set the transformations associated with documents
             * convert the documents to nodes
+            * embed the nodes of all configs concurrently in batches
             * convert the nodes to index
 
         Notes:
             As each selected file type may need to use a different loader
             and transformations, knowledge_config is a list of configs.
         """
+        self.ingestion_metrics = {}
         nodes = []
+        documents = []
         # load data to documents and set transformations
         # using information in knowledge_config
         for config in self.knowledge_config.get("data_processing"):
-            documents = self._data_to_docs(config=config)
+            documents_config = self._data_to_docs(config=config)
             transformations = self._set_transformations(config=config).get(
                 "transformations",
             )
             nodes_docs = self._docs_to_nodes(
-                documents=documents,
+                documents=documents_config,
                 transformations=transformations,
             )
             nodes = nodes + nodes_docs
+            documents = documents + documents_config
+        self._embed_nodes(nodes)
         # convert nodes to index
         self.index = VectorStoreIndex(
             nodes=nodes,
             embed_model=self.emb_model,
+            storage_context=StorageContext.from_defaults(
+                vector_store=self._get_vector_store(),
+            ),
         )
+        self._retrievers = {}
+        # record the document hashes, so that refreshing the index skips
+        # the unchanged documents
+        for doc in documents:
+            self.index.docstore.set_document_hash(doc.doc_id, doc.hash)
         logger.info("index calculation completed.")
+        self._add_nodes_to_bm25(nodes)
         # persist the calculated index
-        self.index.storage_context.persist(persist_dir=self.persist_dir)
+        self._persist_index()
         logger.info("index persisted.")
 
+    def _get_vector_store(self) -> Optional[MmapVectorStore]:
+        """
+        Get the vector store set by the "vector_store" field of
+        knowledge_config, e.g., {"type": "mmap", "dtype": "float16",
+        "nlist": 1024, "nprobe": 16}. The other fields are the arguments of
+        the vector store.
+
+        Returns:
+            Optional[MmapVectorStore]: the vector store, or None to use the
+            default SimpleVectorStore of llama-index.
+        """
+        config = dict(self.knowledge_config.get("vector_store") or {})
+        store_type = config.pop("type", "simple")
+        if store_type == "simple":
+            return None
+        if store_type == "mmap":
+            return MmapVectorStore(persist_dir=self.persist_dir, **config)
+        raise ValueError(f"Unsupported vector store type {store_type}.")
+
+    def _add_nodes_to_bm25(self, nodes: List[BaseNode]) -> None:
+        """
+        Add the nodes to the BM25 index if it's enabled.
+
+        Args:
+            nodes (List[BaseNode]): the nodes to be added.
+        """
+        if self.bm25_index is None:
+            return
+        start = time.perf_counter()
+        self.bm25_index.add(
+            [node.node_id for node in nodes],
+            [node.ref_doc_id for node in nodes],
+            [
+                node.get_content(metadata_mode=MetadataMode.NONE)
+                for node in nodes
+            ],
+        )
+        self._add_metrics(bm25_seconds=time.perf_counter() - start)
+
+    def _delete_ref_doc(self, doc_id: str) -> None:
+        """
+        Delete a document from the index, and from the BM25 index if it's
+        enabled.
+
+        Args:
+            doc_id (str): the id of the document.
+        """
+        self.index.delete_ref_doc(
+            ref_doc_id=doc_id,
+            delete_from_docstore=True,
+        )
+        if self.bm25_index is not None:
+            self.bm25_index.delete_ref_doc(doc_id)
+
+    def _persist_index(self) -> None:
+        """
+        Persist the index, and the BM25 index if it's enabled.
+        """
+        self.index.storage_context.persist(persist_dir=self.persist_dir)
+        if self.bm25_index is not None:
+            self.bm25_index.persist(self.persist_dir)
+
     def _data_to_docs(
         self,
         query: Optional[str] = None,
@@ -323,13 +501,31 @@ class LlamaIndexKnowledge(Knowledge):
         loader = self._set_loader(config=config).get("loader")
         # let the doc_id be the filename for each document
         loader.filename_as_id = True
+        start = time.perf_counter()
         if query is None:
-            documents = loader.load_data()
+            # load the files in multiple processes if the loader supports,
+            # e.g. SimpleDirectoryReader
+            num_workers = self._get_num_workers(
+                len(getattr(loader, "input_files", None) or []),
+            )
+            if (
+                num_workers > 1
+                and "num_workers"
+                in inspect.signature(loader.load_data).parameters
+            ):
+                documents = loader.load_data(num_workers=num_workers)
+            else:
+                documents = loader.load_data()
         else:
             # this is for querying a database,
             # does not work for loading a document directory
             documents = loader.load_data(query)
-        logger.info(f"loaded {len(documents)} documents")
+        duration = time.perf_counter() - start
+        self._add_metrics(documents=len(documents), load_seconds=duration)
+        logger.info(
+            f"loaded {len(documents)} documents in {duration:.2f}s "
+            f"({len(documents) / max(duration, 1e-6):.1f} docs/s)",
+        )
         return documents
 
     def _docs_to_nodes(
@@ -349,22 +545,96 @@ class LlamaIndexKnowledge(Knowledge):
                 process documents (e.g., split the documents into smaller
                 chunks)
         Return:
-            Any: return the index of the processed document
+            Any: return the nodes of the processed document, which are not
+            embedded yet
         """
         # nodes, or called chunks, is a presentation of the documents
         # we build nodes by using the IngestionPipeline
-        # for each document with corresponding transformations
+        # for each document with corresponding transformations.
+        # The embedding is excluded from the pipeline, so that the
+        # documents can be split in multiple processes, and the nodes are
+        # embedded by _embed_nodes concurrently in batches
         pipeline = IngestionPipeline(
-            transformations=transformations,
+            transformations=[
+                _ for _ in transformations or [] if _ is not self.emb_model
+            ],
         )
+        start = time.perf_counter()
         # stack up the nodes from the pipline
         nodes = pipeline.run(
             documents=documents,
             show_progress=self.showprogress,
+            num_workers=self._get_num_workers(len(documents)),
         )
-        logger.info("nodes generated.")
+        duration = time.perf_counter() - start
+        self._add_metrics(nodes=len(nodes), split_seconds=duration)
+        logger.info(f"{len(nodes)} nodes generated in {duration:.2f}s.")
         return nodes
 
+    def _embed_nodes(self, nodes: List[BaseNode]) -> None:
+        """
+        Embed the nodes without embeddings in place. The nodes are embedded
+        in batches of the embed_batch_size of the embedding model, with up
+        to embed_concurrency batches in flight.
+
+        Args:
+            nodes (List[BaseNode]): the nodes to be embedded.
+        """
+        nodes = [_ for _ in nodes if _.embedding is None]
+        if len(nodes) == 0:
+            return
+        batch_size = self.emb_model.embed_batch_size
+        batches = [
+            nodes[i : i + batch_size] for i in range(0, len(nodes), batch_size)
+        ]
+
+        def embed_batch(batch: List[BaseNode]) -> int:
+            texts = [
+                node.get_content(metadata_mode=MetadataMode.EMBED)
+                for node in batch
+            ]
+            embeddings = self.emb_model.get_text_embedding_batch(texts)
+            for node, embedding in zip(batch, embeddings):
+                node.embedding = embedding
+            return len(batch)
+
+        start = time.perf_counter()
+        with tqdm(
+            total=len(nodes),
+            desc="Generating embeddings",
+            disable=not self.showprogress,
+        ) as progress_bar, ThreadPoolExecutor(
+            max_workers=min(self.embed_concurrency, len(batches)),
+        ) as executor:
+            for n_embedded in executor.map(embed_batch, batches):
+                progress_bar.update(n_embedded)
+        duration = time.perf_counter() - start
+        self._add_metrics(embedded_nodes=len(nodes), embed_seconds=duration)
+        logger.info(
+            f"embedded {len(nodes)} nodes in {duration:.2f}s "
+            f"({len(nodes) / max(duration, 1e-6):.1f} nodes/s)",
+        )
+
+    def _get_num_workers(self, n_docs: int) -> int:
+        """
+        Get the number of processes to load or split the documents, so that
+        each process handles enough documents to pay off its start-up.
+
+        Args:
+            n_docs (int): the number of files or documents.
+        """
+        num_workers = self.num_workers or os.cpu_count() or 1
+        return max(1, min(num_workers, n_docs // DEFAULT_DOCS_PER_WORKER))
+
+    def _add_metrics(self, **metrics: float) -> None:
+        """
+        Accumulate the metrics of the ingestion stages.
+        """
+        for key, value in metrics.items():
+            self.ingestion_metrics[key] = (
+                self.ingestion_metrics.get(key, 0) + value
+            )
+
     def _set_loader(self, config: dict) -> Any:
         """
         Set the loader as needed, or just use the default setting.
@@ -433,7 +703,8 @@ class LlamaIndexKnowledge(Knowledge):
         **kwargs: Any,
     ) -> BaseRetriever:
         """
-        Set the retriever as needed, or just use the default setting.
+        Set the retriever as needed, or just use the default setting. The
+        retrievers without extra arguments are cached by similarity_top_k.
 
         Args:
             retriever (Optional[BaseRetriever]): passing a retriever in
@@ -441,24 +712,58 @@ class LlamaIndexKnowledge(Knowledge):
             rag_config (dict): rag configuration, including similarity top k
             index.
         """
+        similarity_top_k = similarity_top_k or DEFAULT_TOP_K
+        if len(kwargs) == 0:
+            with self._retrievers_lock:
+                retriever = self._retrievers.get(similarity_top_k)
+            if retriever is not None:
+                return retriever
         # set the retriever
-        logger.info(
-            f"similarity_top_k" f"={similarity_top_k or DEFAULT_TOP_K}",
-        )
+        logger.info(f"similarity_top_k={similarity_top_k}")
         retriever = self.index.as_retriever(
             embed_model=self.emb_model,
-            similarity_top_k=similarity_top_k or DEFAULT_TOP_K,
+            similarity_top_k=similarity_top_k,
             **kwargs,
         )
+        if len(kwargs) == 0:
+            with self._retrievers_lock:
+                self._retrievers[similarity_top_k] = retriever
         logger.info("retriever is ready.")
         return retriever
 
+    @property
+    def query_embedding_key(self) -> Any:
+        """
+        The key of the embedding model, so that the knowledge with the same
+        key can share the embedding of a query. None if the knowledge
+        retrieves by BM25 only, which doesn't need the embedding.
+        """
+        if self.retrieval_mode == "sparse":
+            return None
+        if isinstance(self.emb_model, _EmbeddingModel):
+            # the wrappers with the same config share the same batcher
+            # pylint: disable=protected-access
+            return self.emb_model._emb_model_wrapper
+        return self.emb_model
+
+    def embed_query(self, query: str) -> List[float]:
+        """
+        Embed the query by the embedding model of the knowledge.
+
+        Args:
+            query (str): the query to be embedded.
+        """
+        return self.emb_model.get_query_embedding(str(query))
+
     def retrieve(
         self,
         query: str,
         similarity_top_k: int = None,
         to_list_strs: bool = False,
         retriever: Optional[BaseRetriever] = None,
+        query_embedding: Optional[List[float]] = None,
+        mode: Optional[str] = None,
+        reranker: Optional[Reranker] = None,
         **kwargs: Any,
     ) -> list[Any]:
         """
@@ -476,15 +781,73 @@ class LlamaIndexKnowledge(Knowledge):
                 if False, return NodeWithScore
             retriever (BaseRetriever):
                 for advanced usage, user can pass their own retriever.
+            query_embedding (Optional[List[float]]):
+                the embedding of the query by embed_query, so that a query
+                shared by several knowledge is embedded only once.
+            mode (Optional[str]):
+                "dense" to retrieve by the embeddings, "sparse" by the BM25
+                index without embedding the query, or "hybrid" to fuse the
+                results of both. Defaults to the mode in knowledge_config.
+            reranker (Optional[Reranker]):
+                if given, the candidates are over-retrieved and reranked,
+                and the most relevant similarity_top_k (or the top_n of the
+                reranker) of them within its token budget are kept.
         Return:
             list[Any]: list of str or NodeWithScore
 
         More advanced query processing can refer to
         https://docs.llamaindex.ai/en/stable/examples/query_transformations/query_transform_cookbook.html
         """
-        if retriever is None:
-            retriever = self._get_retriever(similarity_top_k)
-        retrieved = retriever.retrieve(str(query))
+        if reranker is not None:
+            top_k = similarity_top_k or DEFAULT_TOP_K
+            candidates = self.retrieve(
+                query,
+                reranker.n_candidates(top_k),
+                retriever=retriever,
+                query_embedding=query_embedding,
+                mode=mode,
+                **kwargs,
+            )
+            reranked, _ = reranker.rerank(
+                str(query),
+                candidates,
+                top_n=reranker.top_n or top_k,
+            )
+            retrieved = [node for node, _ in reranked]
+            if to_list_strs:
+                return [node.get_text() for node in retrieved]
+            return retrieved
+
+        mode = self._check_mode(mode)
+        retrieved = []
+        if mode != "sparse":
+            if retriever is None:
+                retriever = self._get_retriever(similarity_top_k)
+            if query_embedding is not None:
+                retrieved = retriever.retrieve(
+                    QueryBundle(
+                        query_str=str(query),
+                        embedding=query_embedding,
+                    ),
+                )
+            else:
+                retrieved = retriever.retrieve(str(query))
+        if mode != "dense":
+            top_k = similarity_top_k or DEFAULT_TOP_K
+            sparse = self._retrieve_sparse(str(query), top_k)
+            if mode == "sparse":
+                retrieved = sparse
+            else:
+                # fuse by the node ids, and keep the scores of the nodes
+                fused = fuse_results(
+                    [retrieved, sparse],
+                    get_text=lambda _: _.node.node_id,
+                    get_score=lambda _: _.score,
+                    method=self.hybrid_fusion,
+                    dedup_threshold=None,
+                    weights=self.hybrid_weights,
+                )
+                retrieved = [node for node, _ in fused[:top_k]]
         if to_list_strs:
             results = []
             for node in retrieved:
@@ -492,76 +855,182 @@ class LlamaIndexKnowledge(Knowledge):
             return results
         return retrieved
 
+    def _check_mode(self, mode: Optional[str]) -> str:
+        """
+        Check the retrieval mode is supported by the knowledge.
+
+        Args:
+            mode (Optional[str]): the mode, defaults to retrieval_mode.
+        """
+        mode = mode or self.retrieval_mode
+        if mode not in ("dense", "sparse", "hybrid"):
+            raise ValueError(f"Unsupported retrieval mode {mode}.")
+        if mode != "dense" and self.bm25_index is None:
+            raise ValueError(
+                f"The {mode} retrieval requires the bm25 index enabled by "
+                f"knowledge_config.",
+            )
+        return mode
+
+    def _retrieve_sparse(self, query: str, top_k: int) -> list:
+        """
+        Retrieve the nodes with the highest BM25 scores.
+
+        Args:
+            query (str): the query.
+            top_k (int): the number of nodes to retrieve.
+
+        Returns:
+            list: the NodeWithScore scored by BM25, which are normalized
+            into [0, 1] to be comparable with the similarity scores.
+        """
+        ids, scores = self.bm25_index.query(query, top_k, normalize=True)
+        nodes = self.index.docstore.get_nodes(ids)
+        return [
+            NodeWithScore(node=node, score=score)
+            for node, score in zip(nodes, scores)
+        ]
+
     def refresh_index(self) -> None:
         """
-        Refresh the index when needed.
+        Refresh the index incrementally when needed. The documents are
+        tracked by their content hashes, so the unchanged documents are
+        skipped. If `overwrite_index` is enabled, the changed documents are
+        re-indexed with only their changed chunks re-embedded, and the
+        documents no longer loaded are deleted from the index. The index is
+        persisted once, and only if it is changed.
         """
+        self.ingestion_metrics = {}
+        loaded_doc_ids = set()
+        changed = False
         for config in self.knowledge_config.get("data_processing"):
             documents = self._data_to_docs(config=config)
+            loaded_doc_ids.update(doc.doc_id for doc in documents)
             # store and indexing for each file type
             transformations = self._set_transformations(config=config).get(
                 "transformations",
             )
-            self._insert_docs_to_index(
+            changed |= self._insert_docs_to_index(
                 documents=documents,
                 transformations=transformations,
+                persist=False,
             )
+        if self.overwrite_index:
+            for doc_id in list(self.index.ref_doc_info.keys()):
+                if doc_id not in loaded_doc_ids:
+                    self._delete_ref_doc(doc_id)
+                    changed = True
+                    logger.info(f"docs deleted from index, doc_id={doc_id}")
+        if changed:
+            self._persist_index()
+            logger.info("index persisted.")
+        else:
+            logger.info("index is up to date.")
 
     def _insert_docs_to_index(
         self,
         documents: List[Document],
         transformations: TransformComponent,
-    ) -> None:
+        persist: bool = True,
+    ) -> bool:
         """
         Add documents to the index. Given a list of documents, we first test if
         the doc_id is already in the index. If not, we add the doc to the
-        list. If yes, and the over-write flag is enabled,
-        we delete the old doc and add the new doc to the list.
+        list. If yes, the content hash of the doc is changed, and the
+        over-write flag is enabled, we delete the old doc and add the new doc
+        to the list.
         Lastly, we generate nodes for all documents on the list, and insert
-        the nodes to the index.
+        the nodes to the index. The nodes whose content is the same as an
+        old node of the doc reuse its embedding, so that only the changed
+        chunks are embedded.
 
         Args:
             documents (List[Document]): list of documents to be added.
             transformations (TransformComponent): transformations that
             convert the documents into nodes.
+            persist (bool): whether to persist the index if it's changed.
+
+        Returns:
+            bool: whether the index is changed.
         """
-        # this is the pipline that generate the nodes
-        pipeline = IngestionPipeline(
-            transformations=transformations,
-        )
+        ref_doc_info = self.index.ref_doc_info
+        docstore = self.index.docstore
         # we need to generate nodes from this list of documents
         insert_docs_list = []
+        old_embeddings = {}
         for doc in documents:
-            if doc.doc_id not in self.index.ref_doc_info.keys():
+            if doc.doc_id not in ref_doc_info:
                 # if the doc_id is not in the index, we add it to the list
                 insert_docs_list.append(doc)
                 logger.info(
                     f"add new documents to index, " f"doc_id={doc.doc_id}",
                 )
-            else:
-                if self.overwrite_index:
-                    # if we enable overwrite index, we delete the old doc
-                    self.index.delete_ref_doc(
-                        ref_doc_id=doc.doc_id,
-                        delete_from_docstore=True,
-                    )
-                    # then add the same doc to the list
-                    insert_docs_list.append(doc)
-                    logger.info(
-                        f"replace document in index, " f"doc_id={doc.doc_id}",
-                    )
+            elif docstore.get_document_hash(doc.doc_id) == doc.hash:
+                # the doc is unchanged since it was indexed
+                continue
+            elif self.overwrite_index:
+                old_embeddings.update(
+                    self._get_node_embeddings(ref_doc_info[doc.doc_id]),
+                )
+                # if we enable overwrite index, we delete the old doc
+                self._delete_ref_doc(doc.doc_id)
+                # then add the same doc to the list
+                insert_docs_list.append(doc)
+                logger.info(
+                    f"replace document in index, " f"doc_id={doc.doc_id}",
+                )
         logger.info("documents scan completed.")
+        if len(insert_docs_list) == 0:
+            return False
+
         # we generate nodes for documents on the list
-        nodes = pipeline.run(
+        nodes = self._docs_to_nodes(
             documents=insert_docs_list,
-            show_progress=True,
+            transformations=transformations,
+        )
+        n_reused = 0
+        for node in nodes:
+            key = _node_content_hash(node)
+            if node.embedding is None and key in old_embeddings:
+                node.embedding = old_embeddings[key]
+                n_reused += 1
+        logger.info(
+            f"{len(nodes)} nodes generated, {n_reused} of them reuse the "
+            f"embeddings of unchanged chunks.",
         )
-        logger.info("nodes generated.")
-        # insert the new nodes to index
+        # embed the changed chunks and insert the new nodes to index
+        self._embed_nodes(nodes)
         self.index.insert_nodes(nodes=nodes)
+        self._add_nodes_to_bm25(nodes)
+        for doc in insert_docs_list:
+            docstore.set_document_hash(doc.doc_id, doc.hash)
         logger.info("nodes inserted to index.")
         # persist the updated index
-        self.index.storage_context.persist(persist_dir=self.persist_dir)
+        if persist:
+            self._persist_index()
+        return True
+
+    def _get_node_embeddings(self, ref_doc_info: Any) -> dict:
+        """
+        Get the embeddings of the nodes of an indexed document, keyed by the
+        content hashes of the nodes.
+
+        Args:
+            ref_doc_info (RefDocInfo): the info of the indexed document.
+
+        Returns:
+            dict: the embeddings keyed by the content hashes, which is empty
+            if the vector store doesn't support getting the embeddings.
+        """
+        embeddings = {}
+        try:
+            for node in self.index.docstore.get_nodes(ref_doc_info.node_ids):
+                embeddings[
+                    _node_content_hash(node)
+                ] = self.index.vector_store.get(node.node_id)
+        except (NotImplementedError, AttributeError, KeyError, ValueError):
+            return {}
+        return embeddings
 
     def _delete_docs_from_index(
         self,
@@ -576,11 +1045,15 @@ class LlamaIndexKnowledge(Knowledge):
         doc_id_list = [doc.doc_id for doc in documents]
         for key in self.index.ref_doc_info.keys():
             if key in doc_id_list:
-                self.index.delete_ref_doc(
-                    ref_doc_id=key,
-                    delete_from_docstore=True,
-                )
+                self._delete_ref_doc(key)
                 logger.info(f"docs deleted from index, doc_id={key}")
         # persist the updated index
-        self.index.storage_context.persist(persist_dir=self.persist_dir)
+        self._persist_index()
         logger.info("nodes delete completed.")
+
+
+def _node_content_hash(node: BaseNode) -> str:
+    """The hash of the content of a node used for embedding, which excludes
+    the metadata not embedded (e.g. the modification date of the file)."""
+    content = node.get_content(metadata_mode=MetadataMode.EMBED)
+    return hashlib.sha256(content.encode("utf-8")).hexdigest()
@@ -0,0 +1,660 @@
+# -*- coding: utf-8 -*-
+"""
+A vector store keeping the embeddings in a binary matrix file, which is
+memory-mapped on demand instead of being parsed from JSON into Python lists.
+Only the pages of the rows that are scored are read, so a knowledge starts
+without loading its embeddings, and an optional IVF (inverted file) index
+limits a query to the rows in the clusters nearest to it.
+"""
+import json
+import os
+import threading
+import uuid
+from typing import Any, List, Optional, Sequence, Tuple
+
+import numpy as np
+from loguru import logger
+
+try:
+    from llama_index.core.bridge.pydantic import PrivateAttr
+    from llama_index.core.schema import BaseNode
+    from llama_index.core.vector_stores.types import (
+        BasePydanticVectorStore,
+        VectorStoreQuery,
+        VectorStoreQueryResult,
+    )
+except ImportError:
+    PrivateAttr = None
+    BaseNode = None
+    BasePydanticVectorStore = None
+    VectorStoreQuery = None
+    VectorStoreQueryResult = None
+
+_VECTORS_FILE = "mmap_vectors.npy"
+_NORMS_FILE = "mmap_norms.npy"
+_IDS_FILE = "mmap_ids.json"
+_IVF_FILE = "mmap_ivf.npz"
+_DATA_FILES = (_VECTORS_FILE, _NORMS_FILE, _IVF_FILE)
+
+# the number of rows scored at a time in a full scan, which bounds the
+# memory used by a query
+_SCAN_CHUNK_ROWS = 65536
+# the number of rows sampled per cluster to train the IVF index
+_IVF_SAMPLES_PER_LIST = 64
+_IVF_TRAIN_ITERS = 10
+
+
+class MmapEmbeddingStore:
+    """
+    The embeddings of the nodes in a memory-mapped float32 or float16
+    matrix, with the node ids and the ids of their documents. The persisted
+    files are loaded lazily on the first access, and the changes are kept
+    in memory until `persist` rewrites the files.
+
+    Example:
+
+        .. code-block:: python
+
+            store = MmapEmbeddingStore("./rag_storage/my_knowledge")
+            store.add(["node1"], ["doc1"], [[0.1, 0.2, 0.3]])
+            store.persist()
+            ids, similarities = store.query([0.1, 0.2, 0.3], top_k=5)
+    """
+
+    def __init__(
+        self,
+        persist_dir: str,
+        dtype: str = "float32",
+        nlist: Optional[int] = None,
+        nprobe: int = 8,
+    ) -> None:
+        """
+        Initialize the store without reading the files.
+
+        Args:
+            persist_dir (str):
+                The directory of the persisted files.
+            dtype (str):
+                The type of the persisted embeddings, "float32" or
+                "float16" which halves the size with a small loss of
+                precision. The type of existing files takes precedence.
+            nlist (Optional[int]):
+                The number of clusters of the IVF index built when
+                persisting, defaults to None, i.e., the queries scan all
+                the embeddings.
+            nprobe (int):
+                The number of nearest clusters scanned by a query when the
+                IVF index is built.
+        """
+        if dtype not in ("float32", "float16"):
+            raise ValueError(f"Unsupported dtype {dtype}.")
+        self.persist_dir = persist_dir
+        self.dtype = np.dtype(dtype)
+        self.nlist = nlist
+        self.nprobe = max(1, nprobe)
+
+        self._lock = threading.Lock()
+        self._loaded = False
+        self._dirty = False
+        # the persisted embeddings, where the first rows are memory-mapped
+        # and the rows added afterwards are kept in memory
+        self._vectors: Optional[np.ndarray] = None
+        self._norms: Optional[np.ndarray] = None
+        self._pending: List[np.ndarray] = []
+        self._ids: List[str] = []
+        self._ref_doc_ids: List[Optional[str]] = []
+        self._rows: dict = {}
+        self._ref_doc_rows: dict = {}
+        self._deleted: set = set()
+        # the IVF index, i.e., the centroids, the rows sorted by cluster and
+        # the offsets of the clusters in the sorted rows
+        self._ivf: Optional[Tuple[np.ndarray, np.ndarray, np.ndarray]] = None
+
+    @staticmethod
+    def exists(persist_dir: str) -> bool:
+        """Whether the store is persisted in the directory."""
+        return os.path.exists(os.path.join(persist_dir, _IDS_FILE))
+
+    @property
+    def n_persisted(self) -> int:
+        """The number of memory-mapped rows, including the deleted ones."""
+        return 0 if self._vectors is None else len(self._vectors)
+
+    def _path(
+        self,
+        name: str,
+        version: Optional[str],
+        persist_dir: Optional[str] = None,
+    ) -> str:
+        """The path of a data file of the version, e.g.
+        "mmap_vectors.<version>.npy". The files persisted before the
+        versions were introduced have no version in their names."""
+        if version is not None:
+            stem, ext = os.path.splitext(name)
+            name = f"{stem}.{version}{ext}"
+        return os.path.join(persist_dir or self.persist_dir, name)
+
+    def __len__(self) -> int:
+        with self._lock:
+            self._load()
+            return len(self._rows)
+
+    def _load(self) -> None:
+        """Load the persisted files if not loaded yet. The embeddings are
+        memory-mapped, so only the ids and the norms are read."""
+        if self._loaded:
+            return
+        self._loaded = True
+        if not self.exists(self.persist_dir):
+            return
+        with open(
+            os.path.join(self.persist_dir, _IDS_FILE),
+            "r",
+            encoding="utf-8",
+        ) as f:
+            meta = json.load(f)
+        self._ids = meta["ids"]
+        self._ref_doc_ids = meta["ref_doc_ids"]
+        self.dtype = np.dtype(meta["dtype"])
+        version = meta.get("version")
+        if len(self._ids) > 0:
+            self._vectors = np.load(
+                self._path(_VECTORS_FILE, version),
+                mmap_mode="r",
+            )
+            self._norms = np.load(self._path(_NORMS_FILE, version))
+            if not len(self._ids) == len(self._vectors) == len(self._norms):
+                raise ValueError(
+                    f"The mmap vector store in {self.persist_dir} is "
+                    f"inconsistent: {len(self._ids)} ids, "
+                    f"{len(self._vectors)} embeddings and "
+                    f"{len(self._norms)} norms.",
+                )
+        ivf_path = self._path(_IVF_FILE, version)
+        if os.path.exists(ivf_path):
+            with np.load(ivf_path) as ivf:
+                self._ivf = (ivf["centroids"], ivf["order"], ivf["offsets"])
+        for row, (node_id, ref_doc_id) in enumerate(
+            zip(self._ids, self._ref_doc_ids),
+        ):
+            self._rows[node_id] = row
+            self._ref_doc_rows.setdefault(ref_doc_id, []).append(row)
+        logger.info(
+            f"mmap vector store loaded from {self.persist_dir} "
+            f"with {len(self._ids)} embeddings",
+        )
+
+    def add(
+        self,
+        ids: Sequence[str],
+        ref_doc_ids: Sequence[Optional[str]],
+        embeddings: Sequence[Sequence[float]],
+    ) -> None:
+        """
+        Add the embeddings, replacing the existing ones with the same ids.
+
+        Args:
+            ids (Sequence[str]): the ids of the nodes.
+            ref_doc_ids (Sequence[Optional[str]]): the ids of the documents
+                of the nodes.
+            embeddings (Sequence[Sequence[float]]): the embeddings.
+        """
+        with self._lock:
+            self._load()
+            for node_id, ref_doc_id, embedding in zip(
+                ids,
+                ref_doc_ids,
+                embeddings,
+            ):
+                if node_id in self._rows:
+                    self._deleted.add(self._rows[node_id])
+                row = len(self._ids)
+                self._pending.append(np.asarray(embedding, dtype=np.float32))
+                self._ids.append(node_id)
+                self._ref_doc_ids.append(ref_doc_id)
+                self._rows[node_id] = row
+                self._ref_doc_rows.setdefault(ref_doc_id, []).append(row)
+            self._dirty = True
+
+    def delete_ref_doc(self, ref_doc_id: str) -> None:
+        """
+        Delete the embeddings of the nodes of a document.
+
+        Args:
+            ref_doc_id (str): the id of the document.
+        """
+        with self._lock:
+            self._load()
+            for row in self._ref_doc_rows.pop(ref_doc_id, []):
+                if self._rows.get(self._ids[row]) == row:
+                    del self._rows[self._ids[row]]
+                self._deleted.add(row)
+                self._dirty = True
+
+    def get(self, node_id: str) -> List[float]:
+        """
+        Get the embedding of a node.
+
+        Args:
+            node_id (str): the id of the node.
+        """
+        with self._lock:
+            self._load()
+            row = self._rows[node_id]
+            if row < self.n_persisted:
+                return self._vectors[row].astype(np.float32).tolist()
+            return self._pending[row - self.n_persisted].tolist()
+
+    def query(
+        self,
+        query_embedding: Sequence[float],
+        top_k: int,
+        node_ids: Optional[Sequence[str]] = None,
+    ) -> Tuple[List[str], List[float]]:
+        """
+        Get the nodes most similar to the query by cosine similarity.
+
+        Args:
+            query_embedding (Sequence[float]): the embedding of the query.
+            top_k (int): the number of nodes to return.
+            node_ids (Optional[Sequence[str]]): if given, only these nodes
+                are scored.
+
+        Returns:
+            Tuple[List[str], List[float]]: the ids of the nodes and their
+            similarities, in descending order of the similarities.
+        """
+        query = np.asarray(query_embedding, dtype=np.float32)
+        query_norm = float(np.linalg.norm(query))
+        if query_norm == 0 or top_k <= 0:
+            return [], []
+        query = query / query_norm
+
+        # take a snapshot, so that the scoring is done without the lock
+        with self._lock:
+            self._load()
+            vectors, norms, ivf = self._vectors, self._norms, self._ivf
+            n_persisted = self.n_persisted
+            pending = list(self._pending)
+            deleted = np.fromiter(self._deleted, dtype=np.int64)
+            ids = self._ids
+            candidates = None
+            if node_ids is not None:
+                candidates = np.array(
+                    sorted(self._rows[_] for _ in node_ids if _ in self._rows),
+                    dtype=np.int64,
+                )
+
+        if candidates is not None:
+            persisted = candidates[candidates < n_persisted]
+            pending_rows = candidates[candidates >= n_persisted]
+        else:
+            persisted = None
+            if ivf is not None and vectors is not None:
+                persisted = _probe_ivf(ivf, query, self.nprobe)
+            pending_rows = np.arange(n_persisted, n_persisted + len(pending))
+
+        rows, scores = [], []
+        if vectors is not None:
+            rows, scores = _score_persisted(vectors, norms, persisted, query)
+        if len(pending_rows) > 0:
+            matrix = np.stack([pending[_ - n_persisted] for _ in pending_rows])
+            rows.append(pending_rows)
+            scores.append(
+                _cosine(matrix, np.linalg.norm(matrix, axis=1), query),
+            )
+        if len(rows) == 0:
+            return [], []
+
+        rows = np.concatenate(rows)
+        scores = np.concatenate(scores)
+        if len(deleted) > 0:
+            alive = ~np.isin(rows, deleted)
+            rows, scores = rows[alive], scores[alive]
+        if len(rows) > top_k:
+            top = np.argpartition(-scores, top_k - 1)[:top_k]
+            rows, scores = rows[top], scores[top]
+        order = np.argsort(-scores, kind="stable")
+        return (
+            [ids[_] for _ in rows[order]],
+            scores[order].astype(float).tolist(),
+        )
+
+    def persist(self, persist_dir: Optional[str] = None) -> None:
+        """
+        Rewrite the files with the deleted embeddings dropped and the added
+        ones appended, and rebuild the IVF index if enabled. Nothing is
+        written if the store is unchanged since it's persisted.
+
+        Args:
+            persist_dir (Optional[str]): the directory to persist, defaults
+                to the directory of the store.
+        """
+        persist_dir = persist_dir or self.persist_dir
+        with self._lock:
+            self._load()
+            if (
+                not self._dirty
+                and os.path.abspath(persist_dir)
+                == os.path.abspath(self.persist_dir)
+                and self.exists(persist_dir)
+            ):
+                return
+            os.makedirs(persist_dir, exist_ok=True)
+            self._write(persist_dir)
+            # reopen the rewritten files lazily
+            self.persist_dir = persist_dir
+            self._loaded = False
+            self._dirty = False
+            self._vectors, self._norms, self._ivf = None, None, None
+            self._pending = []
+            self._ids, self._ref_doc_ids = [], []
+            self._rows, self._ref_doc_rows = {}, {}
+            self._deleted = set()
+
+    def _write(self, persist_dir: str) -> None:
+        """Write the alive embeddings to a new version of the files of the
+        directory. The ids file is replaced last to switch to the new
+        version atomically, so that an interrupted write leaves the old
+        version intact, and then the files of the old versions are
+        removed."""
+        n_persisted = self.n_persisted
+        alive = np.array(sorted(self._rows.values()), dtype=np.int64)
+        kept = alive[alive < n_persisted]
+        added = alive[alive >= n_persisted]
+        if self._vectors is not None:
+            dim = self._vectors.shape[1]
+        elif len(self._pending) > 0:
+            dim = len(self._pending[0])
+        else:
+            dim = 0
+
+        # write to new files, as the old files may be mapped
+        version = uuid.uuid4().hex[:12]
+        ivf = None
+        if len(alive) > 0:
+            vectors_path = self._path(_VECTORS_FILE, version, persist_dir)
+            out = np.lib.format.open_memmap(
+                vectors_path,
+                mode="w+",
+                dtype=self.dtype,
+                shape=(len(alive), dim),
+            )
+            for start in range(0, len(kept), _SCAN_CHUNK_ROWS):
+                chunk = kept[start : start + _SCAN_CHUNK_ROWS]
+                out[start : start + len(chunk)] = self._vectors[chunk]
+            for i, row in enumerate(added):
+                out[len(kept) + i] = self._pending[row - n_persisted]
+            out.flush()
+            # the norms of the stored (possibly float16) embeddings
+            norms = np.concatenate(
+                [
+                    np.linalg.norm(
+                        out[start : start + _SCAN_CHUNK_ROWS].astype(
+                            np.float32,
+                        ),
+                        axis=1,
+                    )
+                    for start in range(0, len(alive), _SCAN_CHUNK_ROWS)
+                ],
+            )
+            if self.nlist and len(alive) >= self.nlist * 4:
+                ivf = _build_ivf(out, norms, self.nlist)
+            del out
+            with open(vectors_path, "rb") as f:
+                os.fsync(f.fileno())
+            with open(
+                self._path(_NORMS_FILE, version, persist_dir),
+                "wb",
+            ) as f:
+                np.save(f, norms)
+                f.flush()
+                os.fsync(f.fileno())
+
+        if ivf is not None:
+            with open(self._path(_IVF_FILE, version, persist_dir), "wb") as f:
+                np.savez(
+                    f,
+                    centroids=ivf[0],
+                    order=ivf[1],
+                    offsets=ivf[2],
+                )
+                f.flush()
+                os.fsync(f.fileno())
+
+        # the ids are written last, as they switch to the new version
+        meta = {
+            "dtype": self.dtype.name,
+            "version": version,
+            "ids": [self._ids[_] for _ in alive],
+            "ref_doc_ids": [self._ref_doc_ids[_] for _ in alive],
+        }
+        ids_path = os.path.join(persist_dir, _IDS_FILE)
+        with open(ids_path + ".tmp", "w", encoding="utf-8") as f:
+            json.dump(meta, f)
+            f.flush()
+            os.fsync(f.fileno())
+        os.replace(ids_path + ".tmp", ids_path)
+        _remove_old_versions(persist_dir, version)
+        logger.info(
+            f"mmap vector store persisted to {persist_dir} "
+            f"with {len(alive)} embeddings",
+        )
+
+
+def _remove_old_versions(persist_dir: str, version: str) -> None:
+    """Remove the data files other than the ones of the version, including
+    the ones left by the interrupted writes."""
+    current = set()
+    for name in _DATA_FILES:
+        stem, ext = os.path.splitext(name)
+        current.add(f"{stem}.{version}{ext}")
+    for name in os.listdir(persist_dir):
+        if name in current or not any(
+            name.startswith(os.path.splitext(_)[0])
+            and name.endswith(os.path.splitext(_)[1])
+            for _ in _DATA_FILES
+        ):
+            continue
+        try:
+            os.remove(os.path.join(persist_dir, name))
+        except OSError as e:
+            # e.g. the file is still mapped on Windows
+            logger.warning(f"Fail to remove the old file {name}: {e}")
+
+
+def _cosine(
+    matrix: np.ndarray,
+    norms: np.ndarray,
+    query: np.ndarray,
+) -> np.ndarray:
+    """The cosine similarities between the rows and the normalized query."""
+    scores = matrix.astype(np.float32) @ query
+    return scores / np.where(norms > 0, norms, 1.0)
+
+
+def _score_persisted(
+    vectors: np.ndarray,
+    norms: np.ndarray,
+    rows: Optional[np.ndarray],
+    query: np.ndarray,
+) -> Tuple[list, list]:
+    """Score the given memory-mapped rows, or all of them chunk by chunk
+    if `rows` is None.
+
+    Returns:
+        Tuple[list, list]: the arrays of the scored rows and their scores.
+    """
+    if rows is not None:
+        if len(rows) == 0:
+            return [], []
+        return [rows], [_cosine(vectors[rows], norms[rows], query)]
+    all_rows, scores = [], []
+    for start in range(0, len(vectors), _SCAN_CHUNK_ROWS):
+        end = min(start + _SCAN_CHUNK_ROWS, len(vectors))
+        all_rows.append(np.arange(start, end))
+        scores.append(_cosine(vectors[start:end], norms[start:end], query))
+    return all_rows, scores
+
+
+def _probe_ivf(
+    ivf: Tuple[np.ndarray, np.ndarray, np.ndarray],
+    query: np.ndarray,
+    nprobe: int,
+) -> np.ndarray:
+    """The sorted rows in the clusters nearest to the normalized query."""
+    centroids, order, offsets = ivf
+    nearest = np.argsort(-(centroids @ query))[:nprobe]
+    rows = np.concatenate(
+        [order[offsets[_] : offsets[_ + 1]] for _ in nearest],
+    )
+    # read the rows in the order of the file
+    return np.sort(rows)
+
+
+def _build_ivf(
+    vectors: np.ndarray,
+    norms: np.ndarray,
+    nlist: int,
+) -> Tuple[np.ndarray, np.ndarray, np.ndarray]:
+    """
+    Cluster the normalized embeddings by spherical k-means trained on a
+    sample, and sort the rows by their clusters.
+
+    Returns:
+        Tuple[np.ndarray, np.ndarray, np.ndarray]: the centroids, the rows
+        sorted by cluster and the offsets of the clusters in the rows.
+    """
+    rng = np.random.default_rng(0)
+    n_rows = len(vectors)
+    n_samples = min(n_rows, nlist * _IVF_SAMPLES_PER_LIST)
+    sample_rows = np.sort(rng.choice(n_rows, n_samples, replace=False))
+    sample = _normalize(vectors[sample_rows], norms[sample_rows])
+    centroids = sample[rng.choice(n_samples, nlist, replace=False)]
+    for _ in range(_IVF_TRAIN_ITERS):
+        labels = np.argmax(sample @ centroids.T, axis=1)
+        sums = np.zeros_like(centroids)
+        np.add.at(sums, labels, sample)
+        counts = np.bincount(labels, minlength=nlist)
+        # re-seed the empty clusters with random samples
+        empty = counts == 0
+        sums[empty] = sample[rng.choice(n_samples, int(empty.sum()))]
+        centroids = _normalize(sums, np.linalg.norm(sums, axis=1))
+
+    labels = np.concatenate(
+        [
+            np.argmax(
+                _normalize(
+                    vectors[start : start + _SCAN_CHUNK_ROWS],
+                    norms[start : start + _SCAN_CHUNK_ROWS],
+                )
+                @ centroids.T,
+                axis=1,
+            )
+            for start in range(0, n_rows, _SCAN_CHUNK_ROWS)
+        ],
+    )
+    order = np.argsort(labels, kind="stable")
+    offsets = np.searchsorted(labels[order], np.arange(nlist + 1))
+    return centroids.astype(np.float32), order, offsets
+
+
+def _normalize(matrix: np.ndarray, norms: np.ndarray) -> np.ndarray:
+    """Normalize the rows of the matrix by their norms."""
+    norms = np.where(norms > 0, norms, 1.0)
+    return matrix.astype(np.float32) / norms[:, None]
+
+
+try:
+
+    class MmapVectorStore(BasePydanticVectorStore):
+        # pylint: disable=unused-argument
+        """
+        The llama-index vector store backed by `MmapEmbeddingStore`. The
+        texts of the nodes are kept in the docstore of the index, and the
+        queries are scored by cosine similarity.
+        """
+
+        stores_text: bool = False
+        _store: MmapEmbeddingStore = PrivateAttr()
+
+        def __init__(
+            self,
+            persist_dir: str,
+            dtype: str = "float32",
+            nlist: Optional[int] = None,
+            nprobe: int = 8,
+        ) -> None:
+            """
+            Initialize the vector store, see `MmapEmbeddingStore` for the
+            arguments.
+            """
+            super().__init__()
+            self._store = MmapEmbeddingStore(
+                persist_dir=persist_dir,
+                dtype=dtype,
+                nlist=nlist,
+                nprobe=nprobe,
+            )
+
+        @classmethod
+        def class_name(cls) -> str:
+            """The name of the class."""
+            return "MmapVectorStore"
+
+        @property
+        def client(self) -> MmapEmbeddingStore:
+            """The underlying embedding store."""
+            return self._store
+
+        def add(self, nodes: List[BaseNode], **add_kwargs: Any) -> List[str]:
+            """Add the embeddings of the nodes."""
+            self._store.add(
+                [node.node_id for node in nodes],
+                [node.ref_doc_id for node in nodes],
+                [node.get_embedding() for node in nodes],
+            )
+            return [node.node_id for node in nodes]
+
+        def delete(self, ref_doc_id: str, **delete_kwargs: Any) -> None:
+            """Delete the embeddings of the nodes of a document."""
+            self._store.delete_ref_doc(ref_doc_id)
+
+        def get(self, text_id: str) -> List[float]:
+            """Get the embedding of a node."""
+            return self._store.get(text_id)
+
+        def query(
+            self,
+            query: VectorStoreQuery,
+            **kwargs: Any,
+        ) -> VectorStoreQueryResult:
+            """Get the nodes most similar to the query."""
+            if query.filters is not None:
+                raise ValueError(
+                    "Metadata filters are not supported by MmapVectorStore.",
+                )
+            ids, similarities = self._store.query(
+                query.query_embedding,
+                query.similarity_top_k,
+                node_ids=query.node_ids,
+            )
+            return VectorStoreQueryResult(similarities=similarities, ids=ids)
+
+        def persist(self, persist_path: str, fs: Any = None) -> None:
+            """Persist to the directory of the given path, which is the
+            path of the vector store file given by the storage context."""
+            self._store.persist(os.path.dirname(persist_path))
+
+except Exception:
+
+    class MmapVectorStore:  # type: ignore[no-redef]
+        """
+        A dummy vector store for passing tests when llama-index is not
+        installed
+        """
+
+        def __init__(self, *args: Any, **kwargs: Any) -> None:
+            raise ImportError(
+                "MmapVectorStore requires llama-index installed.",
+            )
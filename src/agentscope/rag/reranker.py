@@ -0,0 +1,313 @@
+# -*- coding: utf-8 -*-
+"""
+Rerank the retrieved chunks by their relevance to the query, so that a few
+precise chunks are put into the prompt instead of raising the top k of the
+retrieval. The candidates are over-retrieved, scored by a cross-encoder or
+a model in batches, and kept in a token budget.
+"""
+import hashlib
+import json
+import re
+import threading
+from collections import OrderedDict
+from typing import Any, Callable, List, Optional, Sequence, Tuple, Union
+
+from loguru import logger
+
+from agentscope.constants import (
+    DEFAULT_RERANK_BATCH_SIZE,
+    DEFAULT_RERANK_CACHE_SIZE,
+    DEFAULT_RERANK_OVER_RETRIEVE,
+)
+from agentscope.message import Msg
+from agentscope.models import ModelWrapperBase
+from agentscope.utils.token_utils import count_text_tokens
+
+_SCORE_PROMPT = (
+    "Rate how relevant each passage is to the query, from 0 (irrelevant) "
+    "to 10 (answers the query). Respond with only a JSON list of the "
+    "scores of the passages in order, e.g. [3, 10, 0]."
+)
+
+
+class _CrossEncoderScorer:
+    """Score the (query, text) pairs by a local cross-encoder of the
+    sentence_transformers library, which runs on CPU by default.
+
+    Note:
+        To download the model, you need to be accessible to the huggingface.
+    """
+
+    def __init__(self, model_name_or_path: str, device: str = "cpu") -> None:
+        """
+        Args:
+            model_name_or_path (`str`):
+                The name or path of the cross-encoder, e.g.
+                "cross-encoder/ms-marco-MiniLM-L-6-v2".
+            device (`str`, defaults to `"cpu"`):
+                The device to run the model.
+        """
+        self.model = None
+        self.model_name_or_path = model_name_or_path
+        self.device = device
+        self._lock = threading.Lock()
+
+    def __call__(self, query: str, texts: List[str]) -> List[float]:
+        # Lazy loading the model
+        with self._lock:
+            if self.model is None:
+                try:
+                    from sentence_transformers import CrossEncoder
+                except ImportError as e:
+                    raise ImportError(
+                        "The sentence-transformers library is required. "
+                        "Install it with `pip install sentence-transformers`.",
+                    ) from e
+
+                logger.info(
+                    f"Loading local cross-encoder: {self.model_name_or_path}",
+                )
+                self.model = CrossEncoder(
+                    self.model_name_or_path,
+                    device=self.device,
+                )
+        scores = self.model.predict(
+            [(query, text) for text in texts],
+            batch_size=len(texts),
+            show_progress_bar=False,
+        )
+        return [float(_) for _ in scores]
+
+
+class _ChatModelScorer:
+    """Score the texts by asking a chat model to rate them, where the texts
+    of a batch are rated in one call."""
+
+    def __init__(self, model: ModelWrapperBase) -> None:
+        self.model = model
+
+    def __call__(self, query: str, texts: List[str]) -> List[float]:
+        passages = "\n\n".join(
+            f"[{i + 1}] {text}" for i, text in enumerate(texts)
+        )
+        prompt = self.model.format(
+            Msg("system", _SCORE_PROMPT, role="system"),
+            Msg("user", f"Query: {query}\n\n{passages}", role="user"),
+        )
+        response = self.model(prompt).text
+        match = re.search(r"\[[^\[\]]*\]", response)
+        try:
+            scores = [float(_) for _ in json.loads(match.group(0))]
+        except (AttributeError, TypeError, ValueError) as e:
+            raise ValueError(
+                f"Fail to parse the scores from response: {response}",
+            ) from e
+        if len(scores) != len(texts):
+            raise ValueError(
+                f"Expect {len(texts)} scores, got {len(scores)}: {response}",
+            )
+        return scores
+
+
+class Reranker:
+    """
+    Rerank the retrieved chunks by a cross-encoder or a model, and keep the
+    most relevant ones in a token budget. The uncached (query, chunk) pairs
+    are scored in batches, and the scores are cached, so that the chunks
+    retrieved again for the same query (e.g. in a multi-turn conversation
+    with the recent memory as the query) are not scored twice.
+
+    Example:
+
+        .. code-block:: python
+
+            reranker = Reranker(
+                "cross-encoder/ms-marco-MiniLM-L-6-v2",
+                top_n=3,
+                max_tokens=1000,
+            )
+            nodes = knowledge.retrieve(query, 3, reranker=reranker)
+    """
+
+    def __init__(
+        self,
+        model: Union[
+            str,
+            ModelWrapperBase,
+            Callable[[str, List[str]], List[float]],
+        ],
+        top_n: Optional[int] = None,
+        max_tokens: Optional[int] = None,
+        over_retrieve: int = DEFAULT_RERANK_OVER_RETRIEVE,
+        batch_size: int = DEFAULT_RERANK_BATCH_SIZE,
+        cache_size: int = DEFAULT_RERANK_CACHE_SIZE,
+        model_name: Optional[str] = None,
+    ) -> None:
+        """
+        Initialize the reranker.
+
+        Args:
+            model (`Union[str, ModelWrapperBase, Callable]`):
+                The name or path of a local cross-encoder of the
+                sentence_transformers library; a chat model wrapper, which
+                rates the chunks of a batch in one call; or a function
+                taking the query and a list of texts and returning their
+                scores.
+            top_n (`Optional[int]`, defaults to `None`):
+                The maximum number of chunks kept, defaults to the top k of
+                the retrieval.
+            max_tokens (`Optional[int]`, defaults to `None`):
+                The maximum number of tokens of the chunks kept, no limit
+                if not given.
+            over_retrieve (`int`, defaults to `4`):
+                The number of candidates to retrieve for reranking, as a
+                multiple of the number of chunks kept.
+            batch_size (`int`, defaults to `32`):
+                The maximum number of chunks scored in one call.
+            cache_size (`int`, defaults to `4096`):
+                The maximum number of the cached scores.
+            model_name (`Optional[str]`, defaults to `None`):
+                The name of the model whose tokenizer counts the tokens of
+                the chunks, see `count_text_tokens`.
+        """
+        if isinstance(model, str):
+            self.scorer = _CrossEncoderScorer(model)
+        elif isinstance(model, ModelWrapperBase):
+            self.scorer = _ChatModelScorer(model)
+        elif callable(model):
+            self.scorer = model
+        else:
+            raise TypeError(f"Unsupported reranking model {type(model)}.")
+        self.top_n = top_n
+        self.max_tokens = max_tokens
+        self.over_retrieve = max(1, over_retrieve)
+        self.batch_size = max(1, batch_size)
+        self.cache_size = cache_size
+        self.model_name = model_name
+
+        self._cache: OrderedDict = OrderedDict()
+        self._cache_lock = threading.Lock()
+
+    def n_candidates(self, top_k: int) -> int:
+        """The number of candidates to retrieve for keeping top_k chunks."""
+        return top_k * self.over_retrieve
+
+    def score(self, query: str, texts: Sequence[str]) -> List[float]:
+        """
+        Score the texts by their relevance to the query, where only the
+        uncached texts are sent to the model in batches.
+
+        Args:
+            query (`str`): the query.
+            texts (`Sequence[str]`): the texts to be scored.
+
+        Returns:
+            `List[float]`: the scores of the texts, higher is more relevant.
+        """
+        keys = [_cache_key(query, text) for text in texts]
+        scores: List[Optional[float]] = [None] * len(texts)
+        missing: dict = {}
+        with self._cache_lock:
+            for i, key in enumerate(keys):
+                if key in self._cache:
+                    self._cache.move_to_end(key)
+                    scores[i] = self._cache[key]
+                else:
+                    missing.setdefault(key, []).append(i)
+
+        pending = list(missing.items())
+        for start in range(0, len(pending), self.batch_size):
+            batch = pending[start : start + self.batch_size]
+            batch_scores = self.scorer(
+                query,
+                [texts[indices[0]] for _, indices in batch],
+            )
+            with self._cache_lock:
+                for (key, indices), score in zip(batch, batch_scores):
+                    for i in indices:
+                        scores[i] = score
+                    self._cache[key] = score
+                while len(self._cache) > self.cache_size:
+                    self._cache.popitem(last=False)
+        return scores
+
+    def rerank(
+        self,
+        query: str,
+        candidates: Sequence[Any],
+        get_text: Callable[[Any], str] = lambda _: _.get_content(),
+        top_n: Optional[int] = None,
+        max_tokens: Optional[int] = None,
+    ) -> Tuple[List[Tuple[Any, float]], dict]:
+        """
+        Rerank the candidates and keep the most relevant ones within
+        top_n and the token budget. The chunks not fitting in the budget
+        are skipped, so that the smaller ones ranked after them may fit.
+        If the model fails, the candidates are kept in their original
+        order.
+
+        Args:
+            query (`str`):
+                The query.
+            candidates (`Sequence[Any]`):
+                The retrieved candidates, e.g. NodeWithScore.
+            get_text (`Callable[[Any], str]`):
+                The function to get the text of a candidate.
+            top_n (`Optional[int]`, defaults to `None`):
+                The maximum number of candidates kept, defaults to the top_n
+                of the reranker, or all.
+            max_tokens (`Optional[int]`, defaults to `None`):
+                The token budget, defaults to the max_tokens of the
+                reranker.
+
+        Returns:
+            `Tuple[List[Tuple[Any, float]], dict]`: the candidates kept and
+            their relevance scores in descending order, and a report of the
+            numbers of the candidates and the kept ones and their tokens,
+            where "saved_tokens" is the prompt tokens saved by reranking
+            compared with using the first top_n candidates in the retrieval
+            order ("baseline_tokens"), which may be negative.
+        """
+        top_n = top_n or self.top_n or len(candidates)
+        max_tokens = max_tokens or self.max_tokens
+        texts = [get_text(_) for _ in candidates]
+        try:
+            scores = self.score(query, texts)
+            order = sorted(range(len(texts)), key=lambda _: -scores[_])
+        except Exception as e:
+            logger.warning(f"Fail to rerank, keep the original order: {e}")
+            scores = [float("nan")] * len(texts)
+            order = list(range(len(texts)))
+
+        tokens = [count_text_tokens(_, self.model_name) for _ in texts]
+        kept = []
+        kept_tokens = 0
+        for i in order:
+            if len(kept) >= top_n:
+                break
+            if max_tokens is not None and kept_tokens + tokens[i] > max_tokens:
+                continue
+            kept.append(i)
+            kept_tokens += tokens[i]
+
+        # Without reranking, the first top_n candidates would be used
+        baseline_tokens = sum(tokens[:top_n])
+        report = {
+            "candidates": len(texts),
+            "kept": len(kept),
+            "candidate_tokens": sum(tokens),
+            "baseline_tokens": baseline_tokens,
+            "kept_tokens": kept_tokens,
+            "saved_tokens": baseline_tokens - kept_tokens,
+        }
+        logger.info(
+            f"reranked {report['candidates']} chunks, kept {report['kept']} "
+            f"with {kept_tokens} tokens, saved {report['saved_tokens']} "
+            f"prompt tokens",
+        )
+        return [(candidates[i], scores[i]) for i in kept], report
+
+
+def _cache_key(query: str, text: str) -> bytes:
+    """The key of the score of a (query, text) pair."""
+    return hashlib.sha1(f"{query}\0{text}".encode("utf-8")).digest()
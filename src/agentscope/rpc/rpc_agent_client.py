@@ -3,6 +3,7 @@
 
 import threading
 import base64
+import json
 from typing import Optional
 from loguru import logger
 
@@ -80,6 +81,37 @@ class RpcAgentClient:
                 f"Fail to create agent with id [{self.agent_id}]: {e}",
             )
 
+    def create_agents(self, agent_configs: dict) -> list:
+        """Create new agents in the server of this client in bulk.
+
+        Args:
+            agent_configs (`dict`): the configurations of the agents keyed
+            by their agent ids.
+
+        Returns:
+            `list`: the ids of the agents created successfully.
+        """
+        try:
+            agent_ids = json.loads(
+                self.call_func(
+                    "_create_agents",
+                    base64.b64encode(dill.dumps(agent_configs)).decode(
+                        "utf-8",
+                    ),
+                ),
+            )
+        except Exception as e:
+            logger.error(
+                f"Fail to create {len(agent_configs)} agents in "
+                f"[{self.host}:{self.port}]: {e}",
+            )
+            return []
+        if len(agent_ids) < len(agent_configs):
+            created = set(agent_ids)
+            failed = [_ for _ in agent_configs if _ not in created]
+            logger.error(f"Fail to create agents with ids {failed}")
+        return agent_ids
+
     def delete_agent(self) -> None:
         """
         Delete the agent created by this client.
@@ -2,9 +2,13 @@
 """Import all server related modules in the package."""
 from .launcher import RpcAgentServerLauncher, as_server
 from .servicer import AgentServerServicer
+from .server_pool import configure_server_pool
+from .server_template import configure_server_template
 
 __all__ = [
     "RpcAgentServerLauncher",
     "AgentServerServicer",
     "as_server",
+    "configure_server_pool",
+    "configure_server_template",
 ]
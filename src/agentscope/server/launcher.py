@@ -26,6 +26,11 @@ except ImportError as import_error:
     )
 import agentscope
 from agentscope.server.servicer import AgentServerServicer
+from agentscope.server.server_template import (
+    AgentServerTemplate,
+    ForkedServer,
+    get_server_template,
+)
 from agentscope.agents.agent import AgentBase
 from agentscope.utils.tools import check_port, generate_id_from_seed
 
@@ -308,7 +313,40 @@ class RpcAgentServerLauncher:
         )
 
     def _launch_in_sub(self) -> None:
-        """Launch an agent server in sub-process."""
+        """Launch an agent server in sub-process, which is forked from the
+        server template if it's enabled."""
+        template = get_server_template()
+        if template is not None:
+            try:
+                self._launch_from_template(template)
+                return
+            except Exception as e:
+                logger.warning(
+                    f"Fail to launch agent server from the template, "
+                    f"start a new process instead: {e}",
+                )
+        self._launch_in_process()
+
+    def _launch_from_template(self, template: AgentServerTemplate) -> None:
+        """Fork an agent server from the server template."""
+        self.port = template.launch(
+            host=self.host,
+            port=self.port,
+            server_id=self.server_id,
+            max_pool_size=self.max_pool_size,
+            max_timeout_seconds=self.max_timeout_seconds,
+            local_mode=self.local_mode,
+            studio_url=self.studio_url,
+            custom_agents=self.custom_agents,
+        )
+        self.server = ForkedServer(template, self.server_id)
+        self.stop_event = self.server
+        logger.info(
+            f"Launch agent server at [{self.host}:{self.port}] success",
+        )
+
+    def _launch_in_process(self) -> None:
+        """Launch an agent server in a new sub-process."""
         from agentscope._init import _INIT_SETTINGS
 
         self.stop_event = Event()
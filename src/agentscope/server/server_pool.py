@@ -0,0 +1,177 @@
+# -*- coding: utf-8 -*-
+"""A pool of agent servers shared by the distributed agents launched without
+host and port, so that many agents are packed into a bounded number of
+server processes instead of one process per agent."""
+import atexit
+import json
+import os
+import threading
+from typing import Optional
+
+from loguru import logger
+
+from agentscope.server.launcher import RpcAgentServerLauncher
+
+
+class _PooledServer:
+    """An agent server in the pool and the number of agents placed on it."""
+
+    def __init__(self, key: tuple, launcher: RpcAgentServerLauncher) -> None:
+        self.key = key
+        self.launcher = launcher
+        self.load = 0
+        self.ready = threading.Event()
+        self.error: Optional[BaseException] = None
+
+
+class AgentServerPool:
+    """A pool of local agent servers. An agent is placed on the least loaded
+    server with the same settings, and a new server is launched only if all
+    the servers are in use and the pool is not full. A server is shut down
+    once all the agents placed on it are stopped."""
+
+    def __init__(self, num_servers: int) -> None:
+        """Init the pool.
+
+        Args:
+            num_servers (`int`):
+                The maximum number of servers with the same settings.
+        """
+        self.num_servers = num_servers
+        self._servers: list = []
+        self._lock = threading.Lock()
+
+    def acquire(
+        self,
+        host: str = "localhost",
+        max_pool_size: int = 8192,
+        max_timeout_seconds: int = 1800,
+        local_mode: bool = True,
+        studio_url: str = None,
+        custom_agents: list = None,
+    ) -> RpcAgentServerLauncher:
+        """Place an agent on a server of the pool.
+
+        Returns:
+            `RpcAgentServerLauncher`: The launcher of the launched server,
+            which should be released by `release` when the agent is stopped.
+        """
+        from agentscope._init import _INIT_SETTINGS
+
+        # The servers are initialized with the settings of `agentscope.init`
+        key = (
+            host,
+            max_pool_size,
+            max_timeout_seconds,
+            local_mode,
+            studio_url,
+            json.dumps(_INIT_SETTINGS, sort_keys=True, default=str),
+        )
+        with self._lock:
+            servers = [_ for _ in self._servers if _.key == key]
+            server = min(servers, key=lambda _: _.load, default=None)
+            to_launch = server is None or (
+                server.load > 0 and len(servers) < self.num_servers
+            )
+            if to_launch:
+                server = _PooledServer(
+                    key,
+                    RpcAgentServerLauncher(
+                        host=host,
+                        max_pool_size=max_pool_size,
+                        max_timeout_seconds=max_timeout_seconds,
+                        local_mode=local_mode,
+                        custom_agents=custom_agents,
+                        studio_url=studio_url,
+                    ),
+                )
+                self._servers.append(server)
+            server.load += 1
+
+        # Launch the server outside the lock, so that the agents placed on
+        # other servers are not blocked
+        if to_launch:
+            try:
+                server.launcher.launch()
+            except BaseException as e:
+                server.error = e
+                with self._lock:
+                    self._servers.remove(server)
+                raise
+            finally:
+                server.ready.set()
+        else:
+            server.ready.wait()
+            if server.error is not None:
+                raise RuntimeError(
+                    "Fail to launch the shared agent server",
+                ) from server.error
+        return server.launcher
+
+    def release(self, launcher: RpcAgentServerLauncher) -> None:
+        """Release an agent placed on the server, and shut down the server if
+        no agent is placed on it."""
+        with self._lock:
+            server = next(
+                (_ for _ in self._servers if _.launcher is launcher),
+                None,
+            )
+            if server is None:
+                return
+            server.load -= 1
+            if server.load > 0:
+                return
+            self._servers.remove(server)
+        launcher.shutdown()
+
+    def shutdown(self) -> None:
+        """Shut down all the servers in the pool."""
+        with self._lock:
+            servers, self._servers = self._servers, []
+        for server in servers:
+            try:
+                server.launcher.shutdown()
+            except Exception as e:
+                logger.warning(f"Fail to shut down the agent server: {e}")
+
+
+_server_pool: Optional[AgentServerPool] = AgentServerPool(
+    num_servers=os.cpu_count() or 1,
+)
+# The pools replaced by `configure_server_pool`, whose servers may still
+# serve their agents
+_replaced_pools: list = []
+
+
+def get_server_pool() -> Optional[AgentServerPool]:
+    """Get the shared pool of agent servers, or `None` if it's disabled."""
+    return _server_pool
+
+
+def configure_server_pool(num_servers: Optional[int] = None) -> None:
+    """Configure the pool of agent servers shared by the distributed agents
+    launched without host and port. The existing servers keep serving their
+    agents.
+
+    Args:
+        num_servers (`Optional[int]`, defaults to `None`):
+            The maximum number of server processes, which defaults to the
+            number of CPUs. Set to 0 to launch a server for each agent.
+    """
+    global _server_pool
+    if _server_pool is not None:
+        _replaced_pools.append(_server_pool)
+    if num_servers is None:
+        num_servers = os.cpu_count() or 1
+    if num_servers <= 0:
+        _server_pool = None
+    else:
+        _server_pool = AgentServerPool(num_servers=num_servers)
+
+
+@atexit.register
+def _shutdown_server_pool() -> None:
+    """Shut down the servers before the process exits."""
+    for pool in [_server_pool] + _replaced_pools:
+        if pool is not None:
+            pool.shutdown()
@@ -0,0 +1,406 @@
+# -*- coding: utf-8 -*-
+"""A warm template process from which the local agent servers are forked.
+The template has initialized agentscope and imported the heavy dependencies
+once, so a new server starts without re-initializing them, and the servers
+share the read-only memory of the template copy-on-write."""
+import atexit
+import importlib
+import json
+import multiprocessing
+import os
+import sys
+import threading
+import time
+from multiprocessing import Pipe, Process
+from typing import Any, Optional, Sequence
+
+from loguru import logger
+
+try:
+    import dill
+except ImportError as import_error:
+    from agentscope.utils.tools import ImportErrorReporter
+
+    dill = ImportErrorReporter(import_error, "distribute")
+
+from agentscope.constants import _DEFAULT_SERVER_LAUNCH_TIMEOUT
+
+
+def _run_server_template(
+    init_settings: dict,
+    preload_modules: Sequence[str],
+    pipe: Any,
+) -> None:
+    """The entry of the template process, which forks an agent server for
+    each launch request received from the pipe.
+
+    Args:
+        init_settings (`dict`):
+            Init settings for `init_process`.
+        preload_modules (`Sequence[str]`):
+            The modules imported before forking the servers.
+        pipe (`Connection`):
+            The pipe to receive the requests and send the replies.
+    """
+    from agentscope._init import init_process
+    from agentscope.constants import _DEFAULT_LOG_LEVEL
+    from agentscope.logging import add_console_sink
+
+    # The enqueued log handlers inherited from the launching process are
+    # consumed by its threads, which are not forked, so the sinks are added
+    # again in the template
+    logger.remove()
+    if init_settings:
+        init_process(**init_settings)
+    if hasattr(logger, "chat"):
+        # `setup_logger` only adds the console sink once in a process
+        add_console_sink(
+            init_settings.get("logger_level", _DEFAULT_LOG_LEVEL),
+        )
+    else:
+        logger.add(sys.stderr)
+    for module in preload_modules:
+        try:
+            importlib.import_module(module)
+        except ImportError as e:
+            logger.warning(f"Fail to preload module [{module}]: {e}")
+    _TemplateLoop(pipe).run()
+
+
+class _TemplateLoop:
+    """The request loop in the template process. Each request is a tuple of
+    the request id, the command and its args, and is replied with the
+    request id, the result and the error."""
+
+    def __init__(self, pipe: Any) -> None:
+        self.pipe = pipe
+        self.fork_ctx = multiprocessing.get_context("fork")
+        self.servers: dict = {}
+        self.send_lock = threading.Lock()
+
+    def reply(self, request_id: int, result: Any, error: str = None) -> None:
+        """Send the reply of a request."""
+        with self.send_lock:
+            self.pipe.send((request_id, result, error))
+
+    def run(self) -> None:
+        """Handle the requests until the pipe is closed, then stop the
+        servers forked from the template."""
+        self.reply(0, "ready")
+        while True:
+            try:
+                request_id, command, args = self.pipe.recv()
+            except (EOFError, OSError):
+                break
+            if command == "close":
+                break
+            if command == "join":
+                # Joining may block, so it's waited in another thread
+                threading.Thread(
+                    target=self._join,
+                    args=(request_id, *args),
+                    daemon=True,
+                ).start()
+                continue
+            try:
+                handler = getattr(self, f"_{command}", None)
+                if handler is None:
+                    raise ValueError(f"Unsupported command [{command}]")
+                self.reply(request_id, handler(*args))
+            except Exception as e:
+                self.reply(request_id, None, f"{type(e).__name__}: {e}")
+
+        for _, stop_event in list(self.servers.values()):
+            stop_event.set()
+        for process, _ in list(self.servers.values()):
+            process.join(15)
+            if process.is_alive():
+                process.kill()
+
+    def _launch(self, kwargs: bytes, timeout: float) -> int:
+        """Fork an agent server and return its port. The server is killed
+        if it doesn't start within the timeout."""
+        from agentscope.server.launcher import _setup_agent_server
+
+        kwargs = dill.loads(kwargs)
+        stop_event = self.fork_ctx.Event()
+        start_event = self.fork_ctx.Event()
+        parent_con, child_con = self.fork_ctx.Pipe()
+        process = self.fork_ctx.Process(
+            target=_setup_agent_server,
+            kwargs={
+                **kwargs,
+                "start_event": start_event,
+                "stop_event": stop_event,
+                "pipe": child_con,
+            },
+        )
+        deadline = time.monotonic() + timeout
+        process.start()
+        child_con.close()
+        try:
+            if not parent_con.poll(timeout):
+                raise TimeoutError(
+                    f"The agent server doesn't start in {timeout} seconds",
+                )
+            port = parent_con.recv()
+            if not start_event.wait(max(0.0, deadline - time.monotonic())):
+                raise TimeoutError(
+                    f"The agent server doesn't start in {timeout} seconds",
+                )
+        except BaseException:
+            process.kill()
+            process.join()
+            raise
+        finally:
+            parent_con.close()
+        self.servers[kwargs["server_id"]] = (process, stop_event)
+        return port
+
+    def _join(
+        self,
+        request_id: int,
+        server_id: str,
+        timeout: Optional[float],
+    ) -> None:
+        """Wait until the server exits."""
+        if server_id in self.servers:
+            self.servers[server_id][0].join(timeout)
+        self.reply(request_id, None)
+
+    def _stop(self, server_id: str) -> None:
+        """Notify the server to stop."""
+        if server_id in self.servers:
+            self.servers[server_id][1].set()
+
+    def _is_alive(self, server_id: str) -> bool:
+        """Whether the server is running, and forget it if not."""
+        process = self.servers.get(server_id, (None,))[0]
+        if process is not None and process.is_alive():
+            return True
+        self.servers.pop(server_id, None)
+        return False
+
+    def _kill(self, server_id: str) -> None:
+        """Kill the server."""
+        if server_id in self.servers:
+            self.servers[server_id][0].kill()
+
+
+class AgentServerTemplate:
+    """The handle of a template process in the launching process. The
+    requests can be sent from multiple threads, and the replies are
+    dispatched by a background thread."""
+
+    def __init__(
+        self,
+        init_settings: dict,
+        preload_modules: Sequence[str] = (),
+    ) -> None:
+        """Start the template process.
+
+        Args:
+            init_settings (`dict`):
+                Init settings for `init_process` in the template.
+            preload_modules (`Sequence[str]`, defaults to `()`):
+                The modules imported in the template before forking the
+                servers.
+        """
+        self._con, child_con = Pipe()
+        self.process = Process(
+            target=_run_server_template,
+            kwargs={
+                "init_settings": init_settings,
+                "preload_modules": list(preload_modules),
+                "pipe": child_con,
+            },
+        )
+        self.process.start()
+        child_con.close()
+        self._con.recv()
+
+        self._lock = threading.Lock()
+        self._request_id = 0
+        self._waiters: dict = {}
+        self._closed = False
+        threading.Thread(target=self._dispatch, daemon=True).start()
+
+    def _dispatch(self) -> None:
+        """Dispatch the replies of the template to the waiting requests."""
+        while True:
+            try:
+                request_id, result, error = self._con.recv()
+            except (EOFError, OSError):
+                break
+            with self._lock:
+                waiter = self._waiters.pop(request_id, None)
+            if waiter is not None:
+                waiter[1:] = [result, error]
+                waiter[0].set()
+        # Fail the remaining requests once the template exits
+        with self._lock:
+            self._closed = True
+            waiters, self._waiters = self._waiters, {}
+        for waiter in waiters.values():
+            waiter[1:] = [None, "The server template has exited"]
+            waiter[0].set()
+
+    def request(
+        self,
+        command: str,
+        *args: Any,
+        timeout: Optional[float] = None,
+    ) -> Any:
+        """Send a request to the template and wait for its reply, or raise
+        a `TimeoutError` if it isn't replied within the timeout."""
+        waiter = [threading.Event(), None, None]
+        with self._lock:
+            if self._closed:
+                raise RuntimeError("The server template has exited")
+            self._request_id += 1
+            request_id = self._request_id
+            self._waiters[request_id] = waiter
+            self._con.send((request_id, command, args))
+        if not waiter[0].wait(timeout):
+            with self._lock:
+                self._waiters.pop(request_id, None)
+            raise TimeoutError(
+                f"The server template doesn't reply to [{command}] in "
+                f"{timeout} seconds",
+            )
+        if waiter[2] is not None:
+            raise RuntimeError(waiter[2])
+        return waiter[1]
+
+    def launch(
+        self,
+        timeout: float = _DEFAULT_SERVER_LAUNCH_TIMEOUT,
+        **kwargs: Any,
+    ) -> int:
+        """Fork an agent server from the template.
+
+        Args:
+            timeout (`float`, defaults to `60`):
+                The seconds to wait for the server to start, after which the
+                server is killed. The reply of the template is waited twice
+                as long, leaving time for the launches queued before it.
+
+        Returns:
+            `int`: The port of the server.
+        """
+        return self.request(
+            "launch",
+            dill.dumps({**kwargs, "init_settings": None}),
+            timeout,
+            timeout=2 * timeout,
+        )
+
+    def close(self) -> None:
+        """Stop the servers forked from the template and the template."""
+        with self._lock:
+            if self._closed:
+                return
+            self._closed = True
+            self._con.send((0, "close", ()))
+        self.process.join()
+
+
+class ForkedServer:
+    """The handle of an agent server forked from a template, which works as
+    the server process and its stop event of `RpcAgentServerLauncher`."""
+
+    def __init__(self, template: AgentServerTemplate, server_id: str) -> None:
+        self.template = template
+        self.server_id = server_id
+
+    def set(self) -> None:
+        """Notify the server to stop."""
+        self.template.request("stop", self.server_id)
+
+    def join(self, timeout: Optional[float] = None) -> None:
+        """Wait until the server exits."""
+        self.template.request("join", self.server_id, timeout)
+
+    def is_alive(self) -> bool:
+        """Whether the server is still running."""
+        return self.template.request("is_alive", self.server_id)
+
+    def kill(self) -> None:
+        """Kill the server."""
+        self.template.request("kill", self.server_id)
+
+
+_template_enabled = "fork" in multiprocessing.get_all_start_methods()
+_preload_modules: list = []
+_templates: dict = {}
+# The templates replaced by `configure_server_template`, whose servers may
+# still be running
+_replaced_templates: list = []
+_templates_lock = threading.Lock()
+
+
+def get_server_template() -> Optional[AgentServerTemplate]:
+    """Get the template for the current init settings, which is started on
+    the first call. Return `None` if the template is disabled."""
+    from agentscope._init import _INIT_SETTINGS
+
+    if not _template_enabled:
+        return None
+    key = json.dumps(_INIT_SETTINGS, sort_keys=True, default=str)
+    with _templates_lock:
+        if key not in _templates:
+            _templates[key] = AgentServerTemplate(
+                init_settings=dict(_INIT_SETTINGS),
+                preload_modules=_preload_modules,
+            )
+        return _templates[key]
+
+
+def configure_server_template(
+    enable: bool = True,
+    preload_modules: Optional[Sequence[str]] = None,
+) -> None:
+    """Configure the template process from which the local agent servers
+    are forked. The servers already launched keep running.
+
+    Args:
+        enable (`bool`, defaults to `True`):
+            Whether to fork the agent servers from a template. It's only
+            supported on the platforms with `fork`, otherwise each server is
+            started as a new process.
+        preload_modules (`Optional[Sequence[str]]`, defaults to `None`):
+            The heavy modules to import in the template, e.g.
+            `["llama_index.core", "tiktoken"]`, so that the servers don't
+            import them again.
+    """
+    global _template_enabled, _preload_modules
+    with _templates_lock:
+        _replaced_templates.extend(_templates.values())
+        _templates.clear()
+        _template_enabled = (
+            enable and "fork" in multiprocessing.get_all_start_methods()
+        )
+        _preload_modules = list(preload_modules or [])
+
+
+def _reset_after_fork() -> None:
+    """The templates belong to the parent process, so a forked process
+    starts its own templates if needed."""
+    global _templates, _replaced_templates, _templates_lock
+    _templates = {}
+    _replaced_templates = []
+    _templates_lock = threading.Lock()
+
+
+if hasattr(os, "register_at_fork"):
+    os.register_at_fork(after_in_child=_reset_after_fork)
+
+
+@atexit.register
+def _close_server_templates() -> None:
+    """Close the templates before the process exits."""
+    for template in list(_templates.values()) + _replaced_templates:
+        try:
+            template.close()
+        except Exception as e:
+            logger.warning(f"Fail to close the server template: {e}")
@@ -6,7 +6,6 @@ import json
 import traceback
 from concurrent import futures
 from loguru import logger
-import requests
 
 try:
     import dill
@@ -28,6 +27,7 @@ except ImportError as import_error:
 
 from .._runtime import _runtime
 from ..studio._client import _studio_client
+from ..utils.http_session import get_http_session
 from ..agents.agent import AgentBase
 from ..exception import StudioRegisterError
 from ..rpc.rpc_agent_pb2_grpc import RpcAgentServicer
@@ -46,7 +46,7 @@ def _register_to_studio(
 ) -> None:
     """Register a server to studio."""
     url = f"{studio_url}/api/servers/register"
-    resp = requests.post(
+    resp = get_http_session().post(
         url,
         json={"server_id": server_id, "host": host, "port": port},
         timeout=10,  # todo: configurable timeout
@@ -150,18 +150,68 @@ class AgentServerServicer(RpcAgentServicer):
                         "kwargs": {args in dict type to init the agent}
                     }
 
+                and an optional `agent_class` field with the agent class,
+                which is registered if the class name is not found.
         """
         with self.agent_id_lock:
             if agent_id not in self.agent_pool:
-                agent_class_name = agent_configs["class_name"]
-                agent_instance = AgentBase.get_agent_class(agent_class_name)(
-                    *agent_configs["args"],
-                    **agent_configs["kwargs"],
+                self.agent_pool[agent_id] = self._new_agent(
+                    agent_id,
+                    agent_configs,
                 )
-                agent_instance._agent_id = agent_id  # pylint: disable=W0212
-                self.agent_pool[agent_id] = agent_instance
                 logger.info(f"create agent instance [{agent_id}]")
 
+    def check_and_generate_agents(self, agent_configs: dict) -> list:
+        """
+        Create new agent instances in bulk for the agent ids that don't
+        exist. The agents are initialized without holding the lock, and
+        added to the pool at once.
+
+        Args:
+            agent_configs (`dict`): the configurations of the agents keyed
+                by their agent ids, in the format of `agent_configs` in
+                `check_and_generate_agent`.
+
+        Returns:
+            `list`: the ids of the agents created or already existing.
+        """
+        with self.agent_id_lock:
+            new_ids = [_ for _ in agent_configs if _ not in self.agent_pool]
+        agents = {}
+        for agent_id in new_ids:
+            try:
+                agents[agent_id] = self._new_agent(
+                    agent_id,
+                    agent_configs[agent_id],
+                )
+            except Exception:
+                logger.error(
+                    f"Fail to create agent [{agent_id}]:\n"
+                    f"{traceback.format_exc()}",
+                )
+        with self.agent_id_lock:
+            for agent_id, agent in agents.items():
+                self.agent_pool.setdefault(agent_id, agent)
+            agent_ids = [_ for _ in agent_configs if _ in self.agent_pool]
+        logger.info(f"create {len(agents)} agent instances")
+        return agent_ids
+
+    def _new_agent(self, agent_id: str, agent_configs: dict) -> AgentBase:
+        """Initialize an agent instance by its configuration."""
+        agent_class_name = agent_configs["class_name"]
+        agent_class = agent_configs.get("agent_class", None)
+        if agent_class is not None:
+            try:
+                AgentBase.get_agent_class(agent_class_name)
+            except ValueError:
+                AgentBase.register_agent_class(agent_class)
+        agent_instance = AgentBase.get_agent_class(agent_class_name)(
+            *agent_configs["args"],
+            **agent_configs["kwargs"],
+        )
+        agent_instance._agent_id = agent_id  # pylint: disable=W0212
+        return agent_instance
+
     def check_and_delete_agent(self, agent_id: str) -> None:
         """
         Check whether the agent exists, and delete the agent instance
@@ -182,7 +232,11 @@ class AgentServerServicer(RpcAgentServicer):
     ) -> RpcMsg:
         """Call the specific servicer function."""
         if hasattr(self, request.target_func):
-            if request.target_func not in ["_create_agent", "_get"]:
+            if request.target_func not in [
+                "_create_agent",
+                "_create_agents",
+                "_get",
+            ]:
                 if not self.agent_exists(request.agent_id):
                     return context.abort(
                         grpc.StatusCode.INVALID_ARGUMENT,
@@ -270,6 +324,38 @@ class AgentServerServicer(RpcAgentServicer):
         self.agent_pool[request.agent_id].observe(msgs)
         return RpcMsg()
 
+    def _observe_batch(self, request: RpcMsg) -> RpcMsg:
+        """Let multiple agents in this server observe the same input, so
+        that a broadcast costs one request per server instead of one per
+        agent.
+
+        Args:
+            request (`RpcMsg`):
+                The agent ids and the serialized input, with json format::
+
+                {
+                    'agent_ids': List[str],
+                    'value': str
+                }
+
+        Returns:
+            `RpcMsg`: Empty RpcMsg.
+        """
+        batch = json.loads(request.value)
+        msgs = deserialize(batch["value"])
+        for msg in msgs:
+            if isinstance(msg, PlaceholderMessage):
+                msg.update_value()
+        for agent_id in batch["agent_ids"]:
+            agent = self.agent_pool.get(agent_id, None)
+            if agent is None:
+                logger.warning(
+                    f"Agent [{agent_id}] not exists, skip its observation.",
+                )
+                continue
+            agent.observe(msgs)
+        return RpcMsg()
+
     def _create_agent(self, request: RpcMsg) -> RpcMsg:
         """Create a new agent instance with the given agent_id.
 
@@ -286,29 +372,64 @@ class AgentServerServicer(RpcAgentServicer):
         )
         return RpcMsg()
 
+    def _create_agents(self, request: RpcMsg) -> RpcMsg:
+        """Create new agent instances in bulk, so that a large number of
+        agents costs one request instead of one per agent.
+
+        Args:
+            request (RpcMsg): request message whose `value` field is the
+            base64 encoded dill dump of the agent configurations keyed by
+            the agent ids.
+
+        Returns:
+            `RpcMsg`: The `value` field contains the json list of the
+            created agent ids.
+        """
+        agent_ids = self.check_and_generate_agents(
+            dill.loads(base64.b64decode(request.value)),
+        )
+        return RpcMsg(value=json.dumps(agent_ids))
+
     def _clone_agent(self, request: RpcMsg) -> RpcMsg:
-        """Clone a new agent instance from the origin instance.
+        """Clone new agent instances from the origin instance.
 
         Args:
             request (RpcMsg): The `agent_id` field is the agent_id of the
-            agent to be cloned.
+            agent to be cloned, and the optional `value` field is the
+            number of instances to clone, with json format::
+
+            {
+                'num_instances': int
+            }
 
         Returns:
             `RpcMsg`: The `value` field contains the agent_id of generated
-            agent.
+            agent, or the json list of the agent_ids if `num_instances` is
+            given.
         """
         agent_id = request.agent_id
         with self.agent_id_lock:
             if agent_id not in self.agent_pool:
                 raise ValueError(f"Agent [{agent_id}] not exists")
             ori_agent = self.agent_pool[agent_id]
-        new_agent = ori_agent.__class__(
-            *ori_agent._init_settings["args"],  # pylint: disable=W0212
-            **ori_agent._init_settings["kwargs"],  # pylint: disable=W0212
-        )
+        num_instances = 1
+        if request.value:
+            num_instances = json.loads(request.value)["num_instances"]
+        new_agents = [
+            ori_agent.__class__(
+                *ori_agent._init_settings["args"],  # pylint: disable=W0212
+                **ori_agent._init_settings["kwargs"],  # pylint: disable=W0212
+            )
+            for _ in range(num_instances)
+        ]
         with self.agent_id_lock:
-            self.agent_pool[new_agent.agent_id] = new_agent
-        return RpcMsg(value=new_agent.agent_id)  # type: ignore[arg-type]
+            for new_agent in new_agents:
+                self.agent_pool[new_agent.agent_id] = new_agent
+        if not request.value:
+            return RpcMsg(
+                value=new_agents[0].agent_id,  # type: ignore[arg-type]
+            )
+        return RpcMsg(value=json.dumps([_.agent_id for _ in new_agents]))
 
     def _delete_agent(self, request: RpcMsg) -> RpcMsg:
         """Delete the agent instance of the specific agent_id.
@@ -3,6 +3,7 @@
 from loguru import logger
 
 from .execute_code.exec_python import execute_python_code
+from .execute_code.sandbox_pool import configure_sandbox_pool
 from .execute_code.exec_shell import execute_shell_command
 from .file.common import (
     create_file,
@@ -19,6 +20,7 @@ from .file.json import read_json_file, write_json_file
 from .sql_query.mysql import query_mysql
 from .sql_query.sqlite import query_sqlite
 from .sql_query.mongodb import query_mongodb
+from .sql_query.connection_pool import configure_sql_connection_pool
 from .web.search import bing_search, google_search
 from .web.arxiv import arxiv_search
 from .web.dblp import (
@@ -35,10 +37,19 @@ from .service_response import ServiceResponse
 from .service_toolkit import ServiceToolkit
 from .service_toolkit import ServiceFactory
 from .retrieval.similarity import cos_sim
-from .text_processing.summarization import summarization
+from .text_processing.summarization import (
+    summarization,
+    configure_summary_cache,
+    clear_summary_cache,
+)
 from .retrieval.retrieval_from_list import retrieve_from_list
 from .service_status import ServiceExecStatus
-from .web.web_digest import digest_webpage, load_web, parse_html_to_text
+from .web.web_digest import (
+    digest_webpage,
+    load_web,
+    load_webs,
+    parse_html_to_text,
+)
 from .web.download import download_from_url
 
 
@@ -54,6 +65,7 @@ __all__ = [
     "ServiceToolkit",
     "get_help",
     "execute_python_code",
+    "configure_sandbox_pool",
     "execute_shell_command",
     "create_file",
     "delete_file",
@@ -73,11 +85,15 @@ __all__ = [
     "query_mysql",
     "query_sqlite",
     "query_mongodb",
+    "configure_sql_connection_pool",
     "cos_sim",
     "summarization",
+    "configure_summary_cache",
+    "clear_summary_cache",
     "retrieve_from_list",
     "digest_webpage",
     "load_web",
+    "load_webs",
     "parse_html_to_text",
     "download_from_url",
     "dblp_search_publications",
@@ -28,6 +28,10 @@ except (ModuleNotFoundError, ImportError):
     resource = None
 
 from agentscope.utils.common import create_tempdir, timer
+from agentscope.service.execute_code.sandbox_pool import (
+    get_docker_pool,
+    get_python_pool,
+)
 from agentscope.service.service_status import ServiceExecStatus
 from agentscope.service.service_response import ServiceResponse
 from agentscope.constants import (
@@ -87,6 +91,11 @@ def execute_python_code(
         matplotlib plots are currently not supported. This limitation stems
         from the non-interactive nature of the execution environment.
 
+        The code is executed in a pool of warm processes or containers,
+        which are started in advance and replaced after each execution by
+        default. Use `configure_sandbox_pool` to reuse them across
+        executions, or to disable the pool.
+
         The argument `timeout` is not available in Windows OS, since the
         since `signal.setitimer` is only available in Unix.
 
@@ -190,6 +199,12 @@ def _execute_python_code_sys(
         "containerized environment.",
     )
 
+    pool = get_python_pool(sys_python_guard, maximum_memory_bytes)
+    if pool is not None:
+        with pool.worker() as worker:
+            output, error, status = worker.run(code, timeout)
+        return _to_service_response(output, error, status)
+
     manager = multiprocessing.Manager()
     shared_list = manager.list()
 
@@ -207,6 +222,15 @@ def _execute_python_code_sys(
     if p.is_alive():
         p.kill()
     output, error, status = shared_list[0], shared_list[1], shared_list[2]
+    return _to_service_response(output, error, status)
+
+
+def _to_service_response(
+    output: str,
+    error: str,
+    status: bool,
+) -> ServiceResponse:
+    """Wrap the result of the execution into a ServiceResponse."""
     if status:
         return ServiceResponse(
             status=ServiceExecStatus.SUCCESS,
@@ -279,21 +303,10 @@ def _execute_python_code_docker(
                 )
                 docker_command = docker_command.strip("& ")
 
-                container = client.containers.run(
-                    image=image_name,
-                    command=docker_command,
-                    volumes={os.getcwd(): {"bind": "/app", "mode": "rw"}},
-                    working_dir="/app",
-                    detach=True,
-                )
-                wait_response = container.wait()
-                docker_out = container.logs(stdout=True, stderr=False).decode(
-                    "utf-8",
+                exit_code, docker_out, docker_err = run_in_container(
+                    docker_command,
                 )
-                docker_err = container.logs(stdout=False, stderr=True).decode(
-                    "utf-8",
-                )
-                is_success = wait_response.get("StatusCode", None) == 0
+                is_success = exit_code == 0
                 # Check for ImportError or ModuleNotFoundError in stderr
                 if (
                     "ImportError" not in docker_err
@@ -320,6 +333,27 @@ def _execute_python_code_docker(
 
         return docker_out, docker_err, is_success
 
+    def run_in_container(command: str) -> Tuple:
+        """Run the command in a warm container from the pool, or in a new
+        container if the pool is disabled."""
+        pool = get_docker_pool(client, run_args)
+        if pool is not None:
+            with pool.worker() as worker:
+                return worker.run(command)
+
+        container = client.containers.run(
+            command=command,
+            volumes={os.getcwd(): {"bind": "/app", "mode": "rw"}},
+            working_dir="/app",
+            **run_args,
+        )
+        wait_response = container.wait()
+        return (
+            wait_response.get("StatusCode", None),
+            container.logs(stdout=True, stderr=False).decode("utf-8"),
+            container.logs(stdout=False, stderr=True).decode("utf-8"),
+        )
+
     client = docker.from_env()  # Initialize Docker client
 
     # Step 1. Pull images & enter images
@@ -445,3 +479,8 @@ def sys_python_guard(maximum_memory_bytes: Optional[int] = None) -> None:
     ]
     for module_name in sys_modules_to_disable:
         sys.modules[module_name] = None
+
+
+# Executing code changes the working directory and the global state of the
+# process, so it shouldn't run concurrently with other tool functions
+execute_python_code.parallel_safe = False
@@ -55,3 +55,8 @@ def execute_shell_command(command: str) -> ServiceResponse:
             status=ServiceExecStatus.ERROR,
             content=str(e),
         )
+
+
+# Shell commands may depend on the side effects of the other tool functions,
+# so they shouldn't run concurrently with them
+execute_shell_command.parallel_safe = False
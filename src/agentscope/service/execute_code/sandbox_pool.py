@@ -0,0 +1,409 @@
+# -*- coding: utf-8 -*-
+"""Pools of warm sandboxes to execute python code, so that the process or
+the container is not started for each execution."""
+import atexit
+import builtins
+import contextlib
+import io
+import multiprocessing
+import shutil
+import sys
+import tempfile
+import threading
+import os
+import queue
+import traceback
+from typing import Any, Callable, Generator, Optional, Tuple, Union
+
+from loguru import logger
+
+from agentscope.utils.common import timer
+
+# The time to wait for the result besides the timeout of the code, before
+# the sandbox process is regarded as stuck
+_GRACE_SECONDS = 5
+
+_pool_size = 2
+_max_runs = 1
+_pools: dict = {}
+_pools_lock = threading.Lock()
+
+
+def configure_sandbox_pool(pool_size: int = 2, max_runs: int = 1) -> None:
+    """Configure the pools of sandboxes used by `execute_python_code`. The
+    existing sandboxes are closed.
+
+    Args:
+        pool_size (`int`, defaults to `2`):
+            The maximum number of warm sandboxes in each pool. The executions
+            wait in a queue when all sandboxes are busy. Set to 0 to start a
+            new process or container for each execution.
+        max_runs (`int`, defaults to `1`):
+            The number of executions after which a sandbox is replaced by a
+            new one. By default, each execution gets a fresh sandbox that
+            was started and guarded in advance. A larger value reuses the
+            sandboxes across executions, which is faster but only isolates
+            the executions partly: a python sandbox is replaced once the
+            code changes the builtins, `os.environ`, `sys.path`,
+            `sys.modules` or the recursion limit, or leaves threads running,
+            while other changes (e.g. patched attributes of the modules,
+            the random state and the open files) are kept.
+    """
+    global _pool_size, _max_runs
+    _pool_size = pool_size
+    _max_runs = max_runs
+    close_sandbox_pools()
+
+
+def close_sandbox_pools() -> None:
+    """Close all the sandboxes in the pools."""
+    with _pools_lock:
+        pools = list(_pools.values())
+        _pools.clear()
+    for pool in pools:
+        pool.close()
+
+
+def _get_pool(key: Any, factory: Callable[[], Any]) -> Optional["_Pool"]:
+    """Get the pool of the key, or `None` if the pool is disabled. The
+    workers of a new pool are started in the caller's thread."""
+    if _pool_size <= 0:
+        return None
+    with _pools_lock:
+        pool = _pools.get(key)
+        is_new = pool is None
+        if is_new:
+            pool = _Pool(factory, _pool_size, _max_runs)
+            _pools[key] = pool
+    if is_new:
+        # Start the workers in advance
+        for _ in range(pool.size):
+            pool.start_worker()
+    return pool
+
+
+class _Pool:
+    """A pool of sandbox workers. A worker is replaced by a new one after
+    `max_runs` executions or when it's contaminated, so that the pool stays
+    warm.
+
+    Note:
+        The workers are started in the thread of the caller, like the
+        sandbox processes started without the pool, so that the timeout of
+        the code is enforced in the same way.
+    """
+
+    def __init__(
+        self,
+        factory: Callable[[], Any],
+        size: int,
+        max_runs: int,
+    ) -> None:
+        self.factory = factory
+        self.size = size
+        self.max_runs = max_runs
+        self.closed = False
+        self._idle: queue.Queue = queue.Queue()
+        self._n_workers = 0
+        self._lock = threading.Lock()
+
+    def start_worker(self) -> None:
+        """Start a worker in the current thread to fill a free slot."""
+        with self._lock:
+            if self.closed or self._n_workers >= self.size:
+                return
+            self._n_workers += 1
+        try:
+            worker = self.factory()
+        except Exception as e:
+            logger.error(f"Fail to start a sandbox: {e}")
+            with self._lock:
+                self._n_workers -= 1
+            # Wake up a waiting execution to start the worker itself
+            self._idle.put(None)
+            return
+        if self.closed:
+            worker.close()
+        else:
+            self._idle.put(worker)
+
+    @contextlib.contextmanager
+    def worker(self) -> Generator[Any, None, None]:
+        """Acquire a worker, which is released or replaced after use. The
+        worker is replaced if the `contaminated` attribute is set."""
+        worker = None
+        while worker is None:
+            try:
+                worker = self._idle.get_nowait()
+            except queue.Empty:
+                with self._lock:
+                    has_slot = self._n_workers < self.size
+                    if has_slot:
+                        self._n_workers += 1
+                if has_slot:
+                    try:
+                        worker = self.factory()
+                    except Exception:
+                        with self._lock:
+                            self._n_workers -= 1
+                        raise
+                else:
+                    worker = self._idle.get()
+
+        worker.contaminated = False
+        try:
+            yield worker
+        except BaseException:
+            worker.contaminated = True
+            raise
+        finally:
+            worker.runs += 1
+            if (
+                worker.contaminated
+                or worker.runs >= self.max_runs
+                or self.closed
+            ):
+                worker.close()
+                with self._lock:
+                    self._n_workers -= 1
+                if not self.closed:
+                    self.start_worker()
+            else:
+                self._idle.put(worker)
+
+    def close(self) -> None:
+        """Close the idle workers, and the busy ones once released."""
+        self.closed = True
+        while True:
+            try:
+                worker = self._idle.get_nowait()
+            except queue.Empty:
+                break
+            if worker is not None:
+                worker.close()
+
+
+def _process_state() -> tuple:
+    """The state of the process shared by the executions, i.e. the
+    identities of the builtins, the environment variables, the module search
+    path, the loaded modules and the recursion limit, to check whether the
+    code has modified them."""
+    return (
+        {k: id(v) for k, v in vars(builtins).items()},
+        dict(os.environ),
+        list(sys.path),
+        {k: id(v) for k, v in sys.modules.items()},
+        sys.getrecursionlimit(),
+    )
+
+
+def _python_worker_loop(
+    conn: Any,
+    guard: Callable[[Optional[int]], None],
+    maximum_memory_bytes: Optional[int],
+) -> None:
+    """The main loop of the sandbox process, which executes the received
+    code in a new namespace and the given working directory."""
+    chdir = os.chdir
+    guard(maximum_memory_bytes)
+    initial_state = _process_state()
+
+    while True:
+        try:
+            task = conn.recv()
+        except (EOFError, KeyboardInterrupt):
+            return
+        if task is None:
+            return
+
+        code, timeout, workdir = task
+        chdir(workdir)
+        is_success = False
+        output_buffer, error_buffer = io.StringIO(), io.StringIO()
+        with contextlib.redirect_stdout(
+            output_buffer,
+        ), contextlib.redirect_stderr(error_buffer):
+            try:
+                with timer(timeout):
+                    exec(code, {"__name__": "__main__"})
+                is_success = True
+            except BaseException:  # pylint: disable=broad-except
+                # Including SystemExit raised by `sys.exit()`
+                error_buffer.write(traceback.format_exc())
+
+        # A failed execution may leave the process in an unknown state
+        contaminated = (
+            not is_success
+            or _process_state() != initial_state
+            or threading.active_count() > 1
+        )
+        conn.send(
+            (
+                output_buffer.getvalue(),
+                error_buffer.getvalue(),
+                is_success,
+                contaminated,
+            ),
+        )
+
+
+class _PythonWorker:
+    """A pre-forked process to execute python code, which is guarded once
+    when started."""
+
+    def __init__(
+        self,
+        guard: Callable[[Optional[int]], None],
+        maximum_memory_bytes: Optional[int] = None,
+    ) -> None:
+        self.conn, child_conn = multiprocessing.Pipe()
+        self.process = multiprocessing.Process(
+            target=_python_worker_loop,
+            args=(child_conn, guard, maximum_memory_bytes),
+            daemon=True,
+        )
+        self.process.start()
+        child_conn.close()
+        self.runs = 0
+        self.contaminated = False
+
+    def run(
+        self,
+        code: str,
+        timeout: Optional[Union[int, float]] = None,
+    ) -> Tuple[str, str, bool]:
+        """Execute the code in a new temporary directory.
+
+        Returns:
+            `Tuple[str, str, bool]`: The output, the error and whether the
+            execution succeeds.
+        """
+        workdir = tempfile.mkdtemp()
+        try:
+            self.conn.send((code, timeout, workdir))
+            wait = None if timeout is None else timeout + _GRACE_SECONDS
+            if not self.conn.poll(wait):
+                self.contaminated = True
+                return "", "TimeoutError: timed out\n", False
+            try:
+                output, error, is_success, contaminated = self.conn.recv()
+            except EOFError:
+                self.contaminated = True
+                self.process.join(1)
+                return (
+                    "",
+                    "The sandbox process exited unexpectedly with code "
+                    f"{self.process.exitcode}.\n",
+                    False,
+                )
+            self.contaminated = contaminated
+            return output, error, is_success
+        finally:
+            shutil.rmtree(workdir, ignore_errors=True)
+
+    def close(self) -> None:
+        """Stop the process."""
+        if self.process.is_alive() and not self.contaminated:
+            try:
+                self.conn.send(None)
+                self.process.join(1)
+            except (BrokenPipeError, OSError):
+                pass
+        if self.process.is_alive():
+            self.process.kill()
+            self.process.join()
+        self.conn.close()
+
+
+class _DockerWorker:
+    """A warm container to execute commands, which mounts the working
+    directory at `/app`."""
+
+    def __init__(
+        self,
+        client: Any,
+        run_args: dict,
+        workdir: str,
+    ) -> None:
+        run_args = {
+            **run_args,
+            "command": "sleep infinity",
+            "volumes": {workdir: {"bind": "/app", "mode": "rw"}},
+            "working_dir": "/app",
+            "detach": True,
+        }
+        self.container = client.containers.run(**run_args)
+        self.runs = 0
+        self.contaminated = False
+
+    def run(self, command: str) -> Tuple[int, str, str]:
+        """Execute the shell command in the container.
+
+        Returns:
+            `Tuple[int, str, str]`: The exit code, the stdout and the stderr.
+        """
+        result = self.container.exec_run(
+            ["sh", "-c", command],
+            workdir="/app",
+            demux=True,
+        )
+        stdout, stderr = result.output
+        # The failed command may leave the container in an unknown state
+        self.contaminated = result.exit_code != 0
+        return (
+            result.exit_code,
+            (stdout or b"").decode("utf-8"),
+            (stderr or b"").decode("utf-8"),
+        )
+
+    def close(self) -> None:
+        """Remove the container."""
+        try:
+            self.container.remove(force=True)
+        except Exception as e:
+            logger.warning(f"Fail to remove the sandbox container: {e}")
+
+
+def get_python_pool(
+    guard: Callable[[Optional[int]], None],
+    maximum_memory_bytes: Optional[int] = None,
+) -> Optional[_Pool]:
+    """Get the pool of sandbox processes with the memory limit, or `None`
+    if the pool is disabled.
+
+    Args:
+        guard (`Callable[[Optional[int]], None]`):
+            The function to disable the destructive functions and set the
+            memory limit in the sandbox process.
+        maximum_memory_bytes (`Optional[int]`, defaults to `None`):
+            The memory limit of the sandbox process.
+    """
+    return _get_pool(
+        ("python", maximum_memory_bytes),
+        lambda: _PythonWorker(guard, maximum_memory_bytes),
+    )
+
+
+def get_docker_pool(
+    client: Any,
+    run_args: dict,
+) -> Optional[_Pool]:
+    """Get the pool of sandbox containers started with the arguments, which
+    mount the current working directory, or `None` if the pool is disabled.
+
+    Args:
+        client (`Any`):
+            The docker client.
+        run_args (`dict`):
+            The arguments to run a container without the pool, e.g. the
+            image, the network and the memory limit, so that the warm
+            containers are restricted in the same way.
+    """
+    workdir = os.getcwd()
+    return _get_pool(
+        ("docker", tuple(sorted(run_args.items())), workdir),
+        lambda: _DockerWorker(client, run_args, workdir),
+    )
+
+
+atexit.register(close_sandbox_pools)
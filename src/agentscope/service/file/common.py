@@ -272,3 +272,14 @@ def get_current_directory() -> ServiceResponse:
             status=ServiceExecStatus.ERROR,
             content=error_message,
         )
+
+
+# The following functions modify the file system, and the later calls
+# may depend on the earlier ones, so they shouldn't run concurrently with
+# other tool functions
+create_file.parallel_safe = False
+delete_file.parallel_safe = False
+move_file.parallel_safe = False
+create_directory.parallel_safe = False
+delete_directory.parallel_safe = False
+move_directory.parallel_safe = False
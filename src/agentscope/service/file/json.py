@@ -73,3 +73,8 @@ def write_json_file(
             status=ServiceExecStatus.ERROR,
             content=error_message,
         )
+
+
+# Writing files may conflict with the other tool functions, so it shouldn't
+# run concurrently with them
+write_json_file.parallel_safe = False
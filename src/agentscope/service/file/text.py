@@ -60,3 +60,8 @@ def write_text_file(
             content="FileExistsError: The file already exists.",
         )
     return write_file(content, file_path)
+
+
+# Writing files may conflict with the other tool functions, so it shouldn't
+# run concurrently with them
+write_text_file.parallel_safe = False
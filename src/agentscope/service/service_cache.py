@@ -0,0 +1,190 @@
+# -*- coding: utf-8 -*-
+"""The cache of the execution results of the service functions that are
+pure or declare a time to live, which is shared across iterations and
+agents."""
+import hashlib
+import json
+import threading
+import time
+from collections import OrderedDict
+from concurrent.futures import Future, Executor
+from typing import Any, Callable, Optional
+
+from .service_response import ServiceResponse
+from .service_status import ServiceExecStatus
+
+_DEFAULT_CACHE_MAX_SIZE = 1024
+
+
+def _canonicalize(obj: Any) -> str:
+    """Canonicalize the arguments into a string, so that the same arguments
+    in different key orders are mapped into the same cache key."""
+    return json.dumps(
+        obj,
+        sort_keys=True,
+        ensure_ascii=False,
+        separators=(",", ":"),
+        default=repr,
+    )
+
+
+class ServiceResultCache:
+    """A thread-safe LRU cache of the execution results of service functions.
+    The pending calls are also recorded, so that identical calls issued at
+    the same time (e.g. by different agents, or by speculative
+    pre-execution) are executed only once.
+
+    Note:
+        Only successful results are kept. Failed calls are evicted once
+        they finish, so that they can be retried.
+    """
+
+    def __init__(self, max_size: int = _DEFAULT_CACHE_MAX_SIZE) -> None:
+        """Initialize the cache.
+
+        Args:
+            max_size (`int`, defaults to `1024`):
+                The maximum number of cached results.
+        """
+        self.max_size = max_size
+        # The cache key -> (the future of the result, the expiration time)
+        self._entries: OrderedDict = OrderedDict()
+        self._lock = threading.Lock()
+        self.hits = 0
+        self.misses = 0
+
+    @staticmethod
+    def get_key(name: str, arguments: dict, presets: dict = None) -> str:
+        """Get the cache key of a function call. The preset arguments are
+        hashed, so that the secrets among them (e.g. API keys) are not kept
+        in plain text.
+
+        Args:
+            name (`str`):
+                The identity of the service function, e.g. its qualified
+                name.
+            arguments (`dict`):
+                The arguments provided by the agent.
+            presets (`dict`, defaults to `None`):
+                The arguments preset by the developer when adding the service
+                function into the toolkit.
+        """
+        presets_hash = hashlib.sha256(
+            _canonicalize(presets or {}).encode("utf-8"),
+        ).hexdigest()
+        return _canonicalize([name, arguments, presets_hash])
+
+    def _lookup(self, key: str) -> Optional[Future]:
+        """Get the valid entry of the key, should be called with lock."""
+        if key not in self._entries:
+            return None
+        future, expire_at = self._entries[key]
+        if expire_at is not None and time.monotonic() > expire_at:
+            del self._entries[key]
+            return None
+        self._entries.move_to_end(key)
+        return future
+
+    def _insert(self, key: str, ttl: Optional[float]) -> Future:
+        """Insert a pending entry, should be called with lock."""
+        future: Future = Future()
+        expire_at = None if ttl is None else time.monotonic() + ttl
+        self._entries[key] = (future, expire_at)
+        while len(self._entries) > self.max_size:
+            self._entries.popitem(last=False)
+        return future
+
+    def _resolve(
+        self,
+        key: str,
+        future: Future,
+        func: Callable[[], ServiceResponse],
+    ) -> None:
+        """Execute the function and resolve the pending entry."""
+        try:
+            result = func()
+        except Exception as e:
+            result = ServiceResponse(
+                status=ServiceExecStatus.ERROR,
+                content=str(e),
+            )
+
+        if result.status != ServiceExecStatus.SUCCESS:
+            with self._lock:
+                if self._entries.get(key, (None,))[0] is future:
+                    del self._entries[key]
+        future.set_result(result)
+
+    def get_or_call(
+        self,
+        key: str,
+        func: Callable[[], ServiceResponse],
+        ttl: Optional[float] = None,
+    ) -> ServiceResponse:
+        """Return the cached result, or call the function in the current
+        thread and cache its result.
+
+        Args:
+            key (`str`):
+                The cache key obtained by `get_key`.
+            func (`Callable[[], ServiceResponse]`):
+                The function call to be executed if missed.
+            ttl (`Optional[float]`, defaults to `None`):
+                The time to live (in seconds) of the result, `None` means
+                the result never expires.
+        """
+        with self._lock:
+            future = self._lookup(key)
+            if future is None:
+                self.misses += 1
+                future = self._insert(key, ttl)
+                owner = True
+            else:
+                self.hits += 1
+                owner = False
+
+        if owner:
+            self._resolve(key, future, func)
+        return future.result()
+
+    def prefetch(
+        self,
+        key: str,
+        func: Callable[[], ServiceResponse],
+        executor: Executor,
+        ttl: Optional[float] = None,
+    ) -> None:
+        """Start executing the function in the executor if it isn't cached
+        or pending, so that the later `get_or_call` with the same key waits
+        for (or directly gets) its result.
+
+        Args:
+            key (`str`):
+                The cache key obtained by `get_key`.
+            func (`Callable[[], ServiceResponse]`):
+                The function call to be executed.
+            executor (`Executor`):
+                The executor to run the function.
+            ttl (`Optional[float]`, defaults to `None`):
+                The time to live (in seconds) of the result.
+        """
+        with self._lock:
+            if self._lookup(key) is not None:
+                return
+            future = self._insert(key, ttl)
+        executor.submit(self._resolve, key, future, func)
+
+    def clear(self) -> None:
+        """Clear the cached results."""
+        with self._lock:
+            self._entries.clear()
+            self.hits = 0
+            self.misses = 0
+
+
+_default_cache = ServiceResultCache()
+
+
+def get_default_cache() -> ServiceResultCache:
+    """Get the cache shared by all the service toolkits in the process."""
+    return _default_cache
@@ -1,7 +1,11 @@
 # -*- coding: utf-8 -*-
+# pylint: disable=too-many-lines
 """Service Toolkit for service function usage."""
 import collections.abc
 import json
+import threading
+import time
+from concurrent import futures
 from functools import partial
 import inspect
 from typing import (
@@ -21,9 +25,12 @@ from ..exception import (
     JsonParsingError,
     FunctionNotFoundError,
     FunctionCallFormatError,
+    FunctionCallError,
+    ResponseParsingError,
 )
 from .service_response import ServiceResponse
 from .service_response import ServiceExecStatus
+from .service_cache import ServiceResultCache, get_default_cache
 
 try:
     from docstring_parser import parse
@@ -82,12 +89,38 @@ class ServiceFunction:
     may have default values, so it is not necessary to provide all arguments.
     """
 
+    parallel_safe: bool
+    """Whether the service function can be executed concurrently with other
+    service functions. A service function can declare itself unsafe by
+    setting the `parallel_safe` attribute of the original function to
+    `False`, e.g. when it changes the working directory of the process."""
+
+    timeout: Optional[float]
+    """The timeout (in seconds) of the service function in the parallel
+    execution mode, `None` means no timeout."""
+
+    pure: bool
+    """Whether the service function is pure, i.e. the same arguments always
+    lead to the same result without side effects, so that its results can
+    be cached. Declared by the `pure` attribute of the original function."""
+
+    ttl: Optional[float]
+    """The time to live (in seconds) of the cached results. Declared by the
+    `ttl` attribute of the original function. A function that is not pure
+    but returns stable results for a while without side effects (e.g. the
+    web searches, whose results hardly change within minutes) declares a
+    `ttl` to be cached for that long."""
+
     def __init__(
         self,
         name: str,
         original_func: Callable,
         processed_func: Callable,
         json_schema: dict,
+        parallel_safe: bool = True,
+        timeout: Optional[float] = None,
+        pure: bool = False,
+        ttl: Optional[float] = None,
     ) -> None:
         """Initialize the service function object."""
 
@@ -95,6 +128,10 @@ class ServiceFunction:
         self.original_func = original_func
         self.processed_func = processed_func
         self.json_schema = json_schema
+        self.parallel_safe = parallel_safe
+        self.timeout = timeout
+        self.pure = pure
+        self.ttl = ttl
 
         self.require_args = (
             len(
@@ -105,6 +142,65 @@ class ServiceFunction:
             != 0
         )
 
+    @property
+    def cacheable(self) -> bool:
+        """Whether the results can be cached, i.e. the function is pure or
+        declares a `ttl`."""
+        return self.pure or self.ttl is not None
+
+
+class _TimedCall:
+    """A function call submitted to a thread pool, whose timeout is counted
+    from when it starts running rather than when it's submitted. Waiting for
+    a free worker is bounded by the same timeout."""
+
+    def __init__(
+        self,
+        executor: futures.Executor,
+        func: Callable[[], ServiceResponse],
+        timeout: Optional[float],
+    ) -> None:
+        self.timeout = timeout
+        self.start_time: Optional[float] = None
+        self.stuck = False
+        self.started = threading.Event()
+        self.future = executor.submit(self._run, func)
+        # Also wake up the waiter if the call is cancelled
+        self.future.add_done_callback(lambda _: self.started.set())
+
+    def _run(self, func: Callable[[], ServiceResponse]) -> ServiceResponse:
+        self.start_time = time.monotonic()
+        self.started.set()
+        return func()
+
+    def result(self) -> ServiceResponse:
+        """Wait for the result, or report a failure if the call waits for a
+        worker or runs longer than the timeout."""
+        if self.timeout is None:
+            return self.future.result()
+
+        if not self.started.wait(self.timeout) and self.future.cancel():
+            return ServiceResponse(
+                status=ServiceExecStatus.ERROR,
+                content=f"Timeout after {self.timeout} seconds waiting for "
+                "a free worker.",
+            )
+
+        self.started.wait()
+        if self.start_time is not None:
+            remaining = self.start_time + self.timeout - time.monotonic()
+        else:
+            remaining = 0.0
+        try:
+            return self.future.result(timeout=max(0.0, remaining))
+        except futures.TimeoutError:
+            # The worker is still occupied by this call
+            self.stuck = True
+            return ServiceResponse(
+                status=ServiceExecStatus.ERROR,
+                content=f"Timeout after {self.timeout} seconds.",
+            )
+
 
 class ServiceToolkit:
     """A service toolkit class that turns service function into string
@@ -141,9 +237,48 @@ class ServiceToolkit:
     )
     """The prompt template for the execution results."""
 
-    def __init__(self) -> None:
-        """Initialize the service toolkit with a list of service functions."""
+    def __init__(
+        self,
+        parallel: bool = False,
+        max_workers: int = 4,
+        timeout: Optional[float] = None,
+        cache: Union[bool, ServiceResultCache] = False,
+    ) -> None:
+        """Initialize the service toolkit with a list of service functions.
+
+        Args:
+            parallel (`bool`, defaults to `False`):
+                Whether to execute the function calls parsed from one
+                response concurrently in a thread pool. The results are
+                still returned in the original order.
+            max_workers (`int`, defaults to `4`):
+                The maximum number of function calls executed at the same
+                time in the parallel mode.
+            timeout (`Optional[float]`, defaults to `None`):
+                The default timeout (in seconds) of each function call in the
+                parallel mode, which can be overridden by the `timeout`
+                attribute of the service function.
+            cache (`Union[bool, ServiceResultCache]`, defaults to `False`):
+                Whether to cache the results of the service functions that
+                are pure or declare a `ttl`. If `True`, the cache shared by
+                all toolkits in the process is used, so identical calls from
+                different agents are executed only once. The calls are
+                identical if they call the same function with the same
+                arguments and preset arguments (e.g. the API key), which are
+                hashed in the cache key. A `ServiceResultCache` object can be
+                given to isolate the results of a toolkit.
+        """
         self.service_funcs = {}
+        self.parallel = parallel
+        self.max_workers = max_workers
+        self.timeout = timeout
+        if cache is True:
+            self.cache = get_default_cache()
+        elif isinstance(cache, ServiceResultCache):
+            self.cache = cache
+        else:
+            self.cache = None
+        self._executor: Optional[futures.ThreadPoolExecutor] = None
 
     def add(self, service_func: Callable[..., Any], **kwargs: Any) -> None:
         """Add a service function to the toolkit, which will be processed into
@@ -213,6 +348,10 @@ class ServiceToolkit:
                 original_func=service_func,
                 processed_func=processed_func,
                 json_schema=json_schema,
+                parallel_safe=getattr(service_func, "parallel_safe", True),
+                timeout=getattr(service_func, "timeout", None),
+                pure=getattr(service_func, "pure", False),
+                ttl=getattr(service_func, "ttl", None),
             )
 
     @property
@@ -359,30 +498,19 @@ class ServiceToolkit:
             `str`: The prompt of the execution results.
         """
 
+        if self.parallel and len(cmds) > 1:
+            func_results = self._call_funcs_in_parallel(cmds)
+        else:
+            func_results = []
+            for cmd in cmds:
+                self._print_func_call(cmd)
+                func_results.append(self._call_func(cmd))
+                print(">>> END ")
+
         execute_results = []
-        for i, cmd in enumerate(cmds):
-            func_name = cmd["name"]
-            service_func = self.service_funcs[cmd["name"]]
+        for i, (cmd, func_res) in enumerate(zip(cmds, func_results)):
             kwargs = cmd.get("arguments", {})
 
-            print(f">>> Executing function {func_name} with arguments:")
-            for key, value in kwargs.items():
-                value = (
-                    value if len(str(value)) < 50 else str(value)[:50] + "..."
-                )
-                print(f">>> \t{key}: {value}")
-
-            # Execute the function
-            try:
-                func_res = service_func.processed_func(**kwargs)
-            except Exception as e:
-                func_res = ServiceResponse(
-                    status=ServiceExecStatus.ERROR,
-                    content=str(e),
-                )
-
-            print(">>> END ")
-
             status = (
                 "SUCCESS"
                 if func_res.status == ServiceExecStatus.SUCCESS
@@ -407,6 +535,158 @@ class ServiceToolkit:
 
         return execute_results_prompt
 
+    @staticmethod
+    def _print_func_call(cmd: dict) -> None:
+        """Print the function name and its arguments."""
+        print(f">>> Executing function {cmd['name']} with arguments:")
+        for key, value in cmd.get("arguments", {}).items():
+            value = value if len(str(value)) < 50 else str(value)[:50] + "..."
+            print(f">>> \t{key}: {value}")
+
+    def _call_func(self, cmd: dict) -> ServiceResponse:
+        """Call the service function and wrap the exception into a
+        `ServiceResponse` object. The results of cacheable functions are
+        obtained from the cache if enabled."""
+        service_func = self.service_funcs[cmd["name"]]
+        if self.cache is not None and service_func.cacheable:
+            return self.cache.get_or_call(
+                self._get_cache_key(cmd),
+                partial(self._call_func_directly, cmd),
+                service_func.ttl,
+            )
+        return self._call_func_directly(cmd)
+
+    def _call_func_directly(self, cmd: dict) -> ServiceResponse:
+        """Call the service function without the cache."""
+        service_func = self.service_funcs[cmd["name"]]
+        kwargs = cmd.get("arguments", {})
+        try:
+            return service_func.processed_func(**kwargs)
+        except Exception as e:
+            return ServiceResponse(
+                status=ServiceExecStatus.ERROR,
+                content=str(e),
+            )
+
+    def _get_cache_key(self, cmd: dict) -> str:
+        """Get the cache key of the function call, including the arguments
+        preset when adding the function."""
+        service_func = self.service_funcs[cmd["name"]]
+        presets = getattr(service_func.processed_func, "keywords", None)
+        func = service_func.original_func
+        return ServiceResultCache.get_key(
+            f"{func.__module__}.{func.__qualname__}",
+            cmd.get("arguments", {}),
+            presets,
+        )
+
+    def prefetch(self, text_cmd: Union[list[dict], str]) -> None:
+        """Start executing the cacheable function calls in the background as
+        soon as they are parsed, e.g. from a partially generated response,
+        so that the following `parse_and_call_func` with the same calls gets
+        their results without waiting. Invalid calls are ignored silently,
+        and only takes effect when the cache is enabled.
+
+        Args:
+            text_cmd (`Union[list[dict], str]`):
+                The function calls in the same format as
+                `parse_and_call_func`.
+        """
+        if self.cache is None:
+            return
+
+        try:
+            cmds = self._parse_and_check_text(text_cmd)
+        except (ResponseParsingError, FunctionCallError, KeyError):
+            return
+
+        for cmd in cmds:
+            service_func = self.service_funcs[cmd["name"]]
+            if service_func.cacheable:
+                self.cache.prefetch(
+                    self._get_cache_key(cmd),
+                    partial(self._call_func_directly, cmd),
+                    self._get_executor(),
+                    service_func.ttl,
+                )
+
+    def _get_executor(self) -> futures.ThreadPoolExecutor:
+        """Get the thread pool, which is created on first use."""
+        if self._executor is None:
+            self._executor = futures.ThreadPoolExecutor(
+                max_workers=self.max_workers,
+                thread_name_prefix="service_toolkit",
+            )
+        return self._executor
+
+    def close(self) -> None:
+        """Shut down the thread pool of the parallel mode and prefetching,
+        without waiting for the running function calls. The pool is created
+        again if the toolkit is used afterwards."""
+        if self._executor is not None:
+            self._executor.shutdown(wait=False, cancel_futures=True)
+            self._executor = None
+
+    def __del__(self) -> None:
+        executor = getattr(self, "_executor", None)
+        if executor is not None:
+            executor.shutdown(wait=False)
+
+    def _call_funcs_in_parallel(
+        self,
+        cmds: List[dict],
+    ) -> List[ServiceResponse]:
+        """Call the functions concurrently in the thread pool. The functions
+        that are not parallel-safe act as barriers: they are called alone in
+        the current thread after all the previous calls finish, so their
+        order relative to the other calls is kept.
+
+        Note:
+            The timeout is counted from when the function call starts
+            running, so the calls queued behind the busy workers are not
+            timed out before they start. A timed-out function call is
+            reported as failed, but it cannot be interrupted and keeps
+            running in its worker thread.
+        """
+        executor = self._get_executor()
+
+        for cmd in cmds:
+            self._print_func_call(cmd)
+
+        func_results: List[ServiceResponse] = []
+        submitted: List[_TimedCall] = []
+        all_submitted: List[_TimedCall] = []
+        for cmd in cmds:
+            service_func = self.service_funcs[cmd["name"]]
+            if service_func.parallel_safe:
+                timeout = service_func.timeout
+                if timeout is None:
+                    timeout = self.timeout
+                submitted.append(
+                    _TimedCall(
+                        executor,
+                        partial(self._call_func, cmd),
+                        timeout,
+                    ),
+                )
+            else:
+                func_results.extend(_.result() for _ in submitted)
+                all_submitted.extend(submitted)
+                submitted = []
+                func_results.append(self._call_func(cmd))
+        func_results.extend(_.result() for _ in submitted)
+        all_submitted.extend(submitted)
+
+        # The timed-out calls keep their workers busy, so leave the old pool
+        # to them and use a fresh one for the following calls
+        if any(_.stuck for _ in all_submitted) and self._executor is executor:
+            executor.shutdown(wait=False)
+            self._executor = None
+
+        print(">>> END ")
+
+        return func_results
+
     def parse_and_call_func(self, text_cmd: Union[list[dict], str]) -> str:
         """Parse, check the text and call the function."""
 
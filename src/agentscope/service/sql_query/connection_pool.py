@@ -0,0 +1,154 @@
+# -*- coding: utf-8 -*-
+"""Pools of database connections keyed by their DSNs, so that the query
+services don't connect to the database for each query."""
+import contextlib
+import os
+import threading
+from typing import Any, Callable, Generator, Hashable, List, Optional
+
+from loguru import logger
+
+from agentscope.constants import _DEFAULT_SQL_POOL_SIZE
+
+_pool_size = _DEFAULT_SQL_POOL_SIZE
+_pools: dict = {}
+_pools_lock = threading.Lock()
+
+
+def configure_sql_connection_pool(
+    pool_size: int = _DEFAULT_SQL_POOL_SIZE,
+) -> None:
+    """Configure the pools of connections used by `query_sqlite`,
+    `query_mysql` and `query_mongodb`. The existing connections are closed.
+
+    Args:
+        pool_size (`int`, defaults to `4`):
+            The maximum number of idle connections kept for each database.
+            The extra connections opened by concurrent queries are closed
+            after use. Set to 0 to connect for each query.
+    """
+    global _pool_size
+    _pool_size = pool_size
+    close_sql_connection_pools()
+
+
+def close_sql_connection_pools() -> None:
+    """Close all the idle connections in the pools."""
+    with _pools_lock:
+        pools = list(_pools.values())
+        _pools.clear()
+    for pool in pools:
+        pool.close()
+
+
+def get_connection_pool(
+    dsn: Hashable,
+    connect: Callable[[], Any],
+    validate: Optional[Callable[[Any], None]] = None,
+) -> "ConnectionPool":
+    """Get the pool of the connections to a database.
+
+    Note:
+        The connections cannot be shared across processes, so a forked
+        process gets its own pools.
+
+    Args:
+        dsn (`Hashable`):
+            The key identifying the database and the connection arguments.
+        connect (`Callable[[], Any]`):
+            The function to open a new connection.
+        validate (`Optional[Callable[[Any], None]]`, defaults to `None`):
+            The function to check an idle connection before reusing it,
+            e.g. to ping the server, which raises if the connection is
+            broken.
+    """
+    key = (os.getpid(), dsn)
+    with _pools_lock:
+        if key not in _pools:
+            _pools[key] = ConnectionPool(connect, _pool_size, validate)
+        return _pools[key]
+
+
+class ConnectionPool:
+    """A pool of the connections to a database. A connection is used by one
+    query at a time, and is kept for reuse after the query unless the query
+    fails and cannot be rolled back, or the connection is closed."""
+
+    def __init__(
+        self,
+        connect: Callable[[], Any],
+        size: int,
+        validate: Optional[Callable[[Any], None]] = None,
+    ) -> None:
+        self.connect = connect
+        self.size = size
+        self.validate = validate
+        self.closed = False
+        self._idle: List[Any] = []
+        self._lock = threading.Lock()
+
+    def acquire(self) -> Any:
+        """Get an idle connection, or open a new one if there is none."""
+        while True:
+            with self._lock:
+                conn = self._idle.pop() if self._idle else None
+            if conn is None:
+                return self.connect()
+            if self.validate is None:
+                return conn
+            try:
+                self.validate(conn)
+                return conn
+            except Exception as e:
+                logger.debug(f"Drop a broken pooled connection: {e}")
+                _close(conn)
+
+    def release(self, conn: Any, reuse: bool = True) -> None:
+        """Put the connection back to the pool, or close it if it shouldn't
+        be reused or the pool is full. A connection with a false `open`
+        attribute (e.g. closed pymysql connections) is not reused."""
+        if reuse and getattr(conn, "open", True):
+            with self._lock:
+                if not self.closed and len(self._idle) < self.size:
+                    self._idle.append(conn)
+                    return
+        _close(conn)
+
+    @contextlib.contextmanager
+    def connection(self) -> Generator[Any, None, None]:
+        """Acquire a connection, which is released after use. If the query
+        fails, the transaction is rolled back before the connection is
+        reused."""
+        conn = self.acquire()
+        try:
+            yield conn
+        except Exception:
+            self.release(conn, reuse=_rollback(conn))
+            raise
+        self.release(conn)
+
+    def close(self) -> None:
+        """Close the idle connections, and the connections released later."""
+        with self._lock:
+            self.closed = True
+            idle, self._idle = self._idle, []
+        for conn in idle:
+            _close(conn)
+
+
+def _rollback(conn: Any) -> bool:
+    """Roll back the transaction, and return whether it succeeds."""
+    try:
+        if hasattr(conn, "rollback"):
+            conn.rollback()
+        return True
+    except Exception:
+        return False
+
+
+def _close(conn: Any) -> None:
+    """Close a connection, ignoring the errors."""
+    try:
+        conn.close()
+    except Exception:
+        pass
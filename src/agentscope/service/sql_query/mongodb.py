@@ -1,9 +1,13 @@
 # -*- coding: utf-8 -*-
 """query in MongoDB """
+import itertools
 from typing import Optional, Any
 
 from ..service_response import ServiceResponse
 from ...service.service_status import ServiceExecStatus
+from ...constants import _DEFAULT_SQL_MAX_BYTES, _DEFAULT_SQL_PAGE_SIZE
+from .connection_pool import get_connection_pool
+from .paged_results import fetch_within_budget, summarize_rows
 
 try:
     import pymongo.errors
@@ -18,6 +22,8 @@ def query_mongodb(
     host: str,
     port: int,
     maxcount_results: Optional[int] = None,
+    max_bytes: Optional[int] = _DEFAULT_SQL_MAX_BYTES,
+    summarize: bool = True,
     **kwargs: Any,
 ) -> ServiceResponse:
     """Execute query within MongoDB database.
@@ -34,8 +40,15 @@ def query_mongodb(
         port (`int`):
             The port number of MongoDB server.
         maxcount_results (`int`, defaults to `None`):
-            The maximum number of results to return. Defaults to `100` to
-            avoid too many results.
+            The maximum number of results to return.
+        max_bytes (`int`, defaults to `65536`):
+            The maximum total size of the results to return, measured by
+            their text.
+        summarize (`bool`, defaults to `True`):
+            Whether to return a summary of the fields, the number of
+            documents and a sample of documents, when the results exceed
+            the budgets. Otherwise, the results within the budgets are
+            returned.
         **kwargs:
 
     Returns:
@@ -46,36 +59,64 @@ def query_mongodb(
         MongoDB is a little different from mysql and sqlite, for its
         operations corresponds to different functions. Now we only support
         `find` query and leave other operations in the future.
+        The clients are pooled, see `configure_sql_connection_pool`. The
+        documents are fetched in batches, and the cursor is closed once the
+        budgets are exceeded.
     """
     try:
-        # Establish connection to MongoDB
-        with pymongo.MongoClient(
-            host=host,
-            port=port,
-            **kwargs,
-        ) as mongo_client:
+        pool = get_connection_pool(
+            ("mongodb", host, port, repr(sorted(kwargs.items()))),
+            lambda: pymongo.MongoClient(
+                host=host,
+                port=port,
+                **kwargs,
+            ),
+        )
+        with pool.connection() as mongo_client:
             db = mongo_client[database]
             coll = db[collection]
 
-            # Perform the query
+            # Perform the query, with one more document to know whether
+            # the results exceed maxcount_results
+            results = coll.find(query).batch_size(_DEFAULT_SQL_PAGE_SIZE)
             if maxcount_results is not None:
-                results = coll.find(query).limit(maxcount_results)
-            else:
-                results = coll.find(query)
+                results = results.limit(maxcount_results + 1)
 
-            # mongo_client.close()
+            try:
+                documents, truncated = fetch_within_budget(
+                    lambda: list(
+                        itertools.islice(results, _DEFAULT_SQL_PAGE_SIZE),
+                    ),
+                    maxcount_results,
+                    max_bytes,
+                )
+            finally:
+                results.close()
 
-            # Convert the cursor to a list
-            documents = list(results)
+            if truncated and summarize:
+                documents = summarize_rows(
+                    list(dict.fromkeys(_ for doc in documents for _ in doc)),
+                    documents,
+                    _count_documents(coll, query),
+                    maxcount_results,
+                    max_bytes,
+                )
             return ServiceResponse(
                 status=ServiceExecStatus.SUCCESS,
                 content=documents,
             )
 
     except Exception as e:
-        # mongo_client.close()
         return ServiceResponse(
             status=ServiceExecStatus.ERROR,
             # TODO: more specific error message
             content=str(e),
         )
+
+
+def _count_documents(coll: Any, query: dict) -> Optional[int]:
+    """Count the documents matching the query, or `None` if it fails."""
+    try:
+        return coll.count_documents(query)
+    except Exception:
+        return None
@@ -6,9 +6,13 @@ from typing import Any
 from ..service_response import ServiceResponse
 from ...utils.common import _if_change_database
 from ...service.service_status import ServiceExecStatus
+from ...constants import _DEFAULT_SQL_MAX_BYTES, _DEFAULT_SQL_PAGE_SIZE
+from .connection_pool import get_connection_pool
+from .paged_results import count_query, fetch_within_budget, summarize_rows
 
 try:
     import pymysql
+    import pymysql.cursors
 except ImportError:
     pymysql = None
 
@@ -22,6 +26,8 @@ def query_mysql(
     port: int,
     allow_change_data: bool = False,
     maxcount_results: Optional[int] = None,
+    max_bytes: Optional[int] = _DEFAULT_SQL_MAX_BYTES,
+    summarize: bool = True,
     **kwargs: Any,
 ) -> ServiceResponse:
     """
@@ -44,12 +50,26 @@ def query_mysql(
             Whether to allow changing data in the database. Defaults to
             `False` to avoid accidental changes to the database.
         maxcount_results (`int`, defaults to `None`):
-            The maximum number of results to return. Defaults to `100` to
-            avoid too many results.
+            The maximum number of results to return.
+        max_bytes (`int`, defaults to `65536`):
+            The maximum total size of the results to return, measured by
+            their text.
+        summarize (`bool`, defaults to `True`):
+            Whether to return a summary of the columns, the number of rows
+            and a sample of rows, when the results exceed the budgets.
+            Otherwise, the results within the budgets are returned.
 
     Returns:
         `ServiceResponse`: A `ServiceResponse` object that contains
         execution results or error message.
+
+    Note:
+        The connections are pooled, see `configure_sql_connection_pool`.
+        The transaction of each query is committed (if it changes data) or
+        rolled back before the connection is reused, so that a query always
+        sees the latest committed data. The results are streamed from the
+        server by an unbuffered cursor page by page, and the fetching stops
+        once the budgets are exceeded.
     """
 
     # Check if the query is safe
@@ -60,34 +80,55 @@ def query_mysql(
             "set `allow_change_data` to `True`.",
         )
 
-    # Limit the number of results by adding LIMIT keywords if necessary
-    if maxcount_results is not None:
-        if "limit" not in query.lower():
-            query += f" LIMIT {maxcount_results}"
-
     # Execute the query
     try:
-        # Establish a connection to the database
-        conn = pymysql.connect(
-            host=host,
-            port=port,
-            user=user,
-            password=password,
-            database=database,
-            **kwargs,
+        pool = get_connection_pool(
+            ("mysql", host, port, user, password, database)
+            + (repr(sorted(kwargs.items())),),
+            lambda: pymysql.connect(
+                host=host,
+                port=port,
+                user=user,
+                password=password,
+                database=database,
+                **kwargs,
+            ),
+            validate=lambda _: _.ping(reconnect=False),
         )
+        with pool.connection() as conn:
+            cursor = conn.cursor(pymysql.cursors.SSCursor)
+            cursor.execute(query)
+            results, truncated = fetch_within_budget(
+                lambda: cursor.fetchmany(_DEFAULT_SQL_PAGE_SIZE),
+                maxcount_results,
+                max_bytes,
+            )
+            columns = [_[0] for _ in cursor.description or []]
 
-        cursor = conn.cursor()
-        cursor.execute(query)
-
-        if _if_change_database(query):
-            conn.commit()
+            is_read_only = _if_change_database(query)
+            if not is_read_only:
+                conn.commit()
 
-        cursor.close()
-        conn.close()
+            if truncated:
+                # closing the cursor would read the remaining rows, so the
+                # connection is closed to abort the result and not reused
+                conn.close()
+            else:
+                cursor.close()
+                if is_read_only:
+                    # end the transaction of the read-only query, otherwise
+                    # the pooled connection keeps reading the same snapshot
+                    # and holds the metadata locks
+                    conn.rollback()
 
-        # Fetch the results
-        results = cursor.fetchall()
+        if truncated and summarize:
+            results = summarize_rows(
+                columns,
+                results,
+                _count_rows(pool, query),
+                maxcount_results,
+                max_bytes,
+            )
         return ServiceResponse(
             status=ServiceExecStatus.SUCCESS,
             content=results,
@@ -98,3 +139,16 @@ def query_mysql(
             # TODO: more specific error message
             content=str(e),
         )
+
+
+def _count_rows(pool: Any, query: str) -> Optional[int]:
+    """Count the rows of the query, or `None` if it fails."""
+    try:
+        with pool.connection() as conn:
+            with conn.cursor() as cursor:
+                cursor.execute(count_query(query))
+                count = cursor.fetchone()[0]
+            conn.rollback()
+            return count
+    except Exception:
+        return None
@@ -0,0 +1,104 @@
+# -*- coding: utf-8 -*-
+"""Fetch the query results page by page within the row and byte budgets,
+and summarize the results exceeding the budgets, so that a large result is
+neither loaded into memory nor put into the prompt as a whole."""
+from typing import Any, Callable, List, Optional, Sequence, Tuple
+
+
+def fetch_within_budget(
+    fetch_page: Callable[[], Sequence[Any]],
+    max_rows: Optional[int] = None,
+    max_bytes: Optional[int] = None,
+) -> Tuple[List[Any], bool]:
+    """Fetch the rows page by page until the results are exhausted or a
+    budget is exceeded. The size of a row is the length of its text in
+    UTF-8, which is how it appears in the prompt.
+
+    Args:
+        fetch_page (`Callable[[], Sequence[Any]]`):
+            The function to fetch the next page of rows, e.g. the
+            `fetchmany` of a cursor, which returns an empty page at the end.
+        max_rows (`Optional[int]`, defaults to `None`):
+            The maximum number of rows to fetch.
+        max_bytes (`Optional[int]`, defaults to `None`):
+            The maximum total size of the rows to fetch.
+
+    Returns:
+        `Tuple[List[Any], bool]`: The rows within the budgets, and whether
+        there are more rows beyond the budgets.
+    """
+    rows: List[Any] = []
+    n_bytes = 0
+    while True:
+        page = fetch_page()
+        if not page:
+            return rows, False
+        for row in page:
+            if max_rows is not None and len(rows) >= max_rows:
+                return rows, True
+            size = len(str(row).encode("utf-8"))
+            if max_bytes is not None and n_bytes + size > max_bytes:
+                return rows, True
+            rows.append(row)
+            n_bytes += size
+
+
+def summarize_rows(
+    columns: Sequence[str],
+    sample: Sequence[Any],
+    count: Optional[int],
+    max_rows: Optional[int] = None,
+    max_bytes: Optional[int] = None,
+) -> dict:
+    """Summarize a result exceeding the budgets by its columns, the number
+    of rows and the sample of rows within the budgets.
+
+    Args:
+        columns (`Sequence[str]`):
+            The names of the columns or fields.
+        sample (`Sequence[Any]`):
+            The rows fetched within the budgets, as tuples of the column
+            values or dicts of the fields.
+        count (`Optional[int]`):
+            The total number of rows, or `None` if it's unknown.
+        max_rows (`Optional[int]`, defaults to `None`):
+            The row budget.
+        max_bytes (`Optional[int]`, defaults to `None`):
+            The byte budget.
+
+    Returns:
+        `dict`: The summary with the columns and their types inferred from
+        the sample, the count and the sample.
+    """
+    types = {}
+    for row in sample:
+        values = row.items() if isinstance(row, dict) else zip(columns, row)
+        for column, value in values:
+            if value is not None and column not in types:
+                types[column] = type(value).__name__
+    budgets = []
+    if max_rows is not None:
+        budgets.append(f"{max_rows} rows")
+    if max_bytes is not None:
+        budgets.append(f"{max_bytes} bytes")
+    total = "an unknown number of" if count is None else str(count)
+    return {
+        "summary": (
+            f"The result has {total} rows, which exceeds the budget of "
+            f"{' or '.join(budgets)}. Only the first {len(sample)} rows are "
+            f"returned as a sample. Narrow down the query by conditions, "
+            f"aggregations or LIMIT to get the exact result."
+        ),
+        "columns": [
+            {"name": column, "type": types.get(column, "unknown")}
+            for column in columns
+        ],
+        "count": count,
+        "sample": list(sample),
+    }
+
+
+def count_query(query: str) -> str:
+    """The SQL to count the rows of a query."""
+    query = query.strip().rstrip(";")
+    return f"SELECT COUNT(*) FROM ({query}) AS _counted"
@@ -6,6 +6,9 @@ from typing import Any
 from ...service.service_response import ServiceResponse
 from ...utils.common import _if_change_database
 from ...service.service_status import ServiceExecStatus
+from ...constants import _DEFAULT_SQL_MAX_BYTES, _DEFAULT_SQL_PAGE_SIZE
+from .connection_pool import ConnectionPool, get_connection_pool
+from .paged_results import count_query, fetch_within_budget, summarize_rows
 
 try:
     import sqlite3
@@ -18,6 +21,8 @@ def query_sqlite(
     query: str,
     allow_change_data: bool = False,
     maxcount_results: Optional[int] = None,
+    max_bytes: Optional[int] = _DEFAULT_SQL_MAX_BYTES,
+    summarize: bool = True,
     **kwargs: Any,
 ) -> ServiceResponse:
     """Executes query within sqlite database.
@@ -32,10 +37,25 @@ def query_sqlite(
             `False` to avoid accidental changes to the database.
         maxcount_results (`int`, defaults to `None`):
             The maximum number of results to return.
+        max_bytes (`int`, defaults to `65536`):
+            The maximum total size of the results to return, measured by
+            their text.
+        summarize (`bool`, defaults to `True`):
+            Whether to return a summary of the columns, the number of rows
+            and a sample of rows, when the results exceed the budgets.
+            Otherwise, the results within the budgets are returned.
 
     Returns:
         `ServiceResponse`: A `ServiceResponse` object that contains
         execution results or error message.
+
+    Note:
+        The connections are pooled, see `configure_sql_connection_pool`,
+        except for the in-memory and temporary databases (e.g. ":memory:"
+        and ""), which belong to their connections. They are connected for
+        each query as before, so their data don't persist between queries.
+        The results are fetched page by page, and the fetching stops once
+        the budgets are exceeded.
     """
 
     # Check if the query is safe
@@ -46,23 +66,45 @@ def query_sqlite(
             "set `allow_change_data` to `True`.",
         )
 
-    # Limit the number of results by adding LIMIT keywords if necessary
-    if maxcount_results is not None:
-        if "limit" not in query.lower():
-            query += f" LIMIT {maxcount_results}"
-
     try:
-        conn = sqlite3.connect(database, **kwargs)
-        cursor = conn.cursor()
-        cursor.execute(query)
-        results = cursor.fetchall()
+        # the pooled connection is used by one thread at a time
+        connect_kwargs = {"check_same_thread": False, **kwargs}
+        if _is_per_connection(database):
+            # a pool without idle connections, i.e. connect for each query
+            pool = ConnectionPool(
+                lambda: sqlite3.connect(database, **connect_kwargs),
+                0,
+            )
+        else:
+            pool = get_connection_pool(
+                ("sqlite", database, repr(sorted(connect_kwargs.items()))),
+                lambda: sqlite3.connect(database, **connect_kwargs),
+            )
+        with pool.connection() as conn:
+            cursor = conn.cursor()
+            try:
+                cursor.execute(query)
+                results, truncated = fetch_within_budget(
+                    lambda: cursor.fetchmany(_DEFAULT_SQL_PAGE_SIZE),
+                    maxcount_results,
+                    max_bytes,
+                )
+                columns = [_[0] for _ in cursor.description or []]
 
-        # commit the change if needed
-        if _if_change_database(query):
-            conn.commit()
+                # commit the change if needed
+                if not _if_change_database(query):
+                    conn.commit()
 
-        cursor.close()
-        conn.close()
+                if truncated and summarize:
+                    results = summarize_rows(
+                        columns,
+                        results,
+                        _count_rows(cursor, query),
+                        maxcount_results,
+                        max_bytes,
+                    )
+            finally:
+                cursor.close()
 
         return ServiceResponse(
             status=ServiceExecStatus.SUCCESS,
@@ -74,3 +116,18 @@ def query_sqlite(
             # TDOO: more specific error message
             content=str(e),
         )
+
+
+def _count_rows(cursor: Any, query: str) -> Optional[int]:
+    """Count the rows of the query, or `None` if it fails."""
+    try:
+        cursor.execute(count_query(query))
+        return cursor.fetchone()[0]
+    except Exception:
+        return None
+
+
+def _is_per_connection(database: str) -> bool:
+    """Whether the database is private to its connection, i.e. an in-memory
+    or a temporary database."""
+    return database in ("", ":memory:") or "mode=memory" in database
@@ -2,14 +2,55 @@
 """
 Service for text processing
 """
+import hashlib
+import re
+import threading
+from collections import OrderedDict
+from concurrent.futures import ThreadPoolExecutor
+from functools import partial
+from typing import List, Optional, Tuple
+
 from loguru import logger
 
 from agentscope.models import ModelWrapperBase
 from agentscope.service.service_status import ServiceExecStatus
 from agentscope.service.service_response import ServiceResponse
 from agentscope.message import Msg
+from agentscope.utils.token_utils import count_text_tokens
 from agentscope.constants import _DEFAULT_SYSTEM_PROMPT
 from agentscope.constants import _DEFAULT_TOKEN_LIMIT_PROMPT
+from agentscope.constants import _DEFAULT_MERGE_SUMMARY_PROMPT
+from agentscope.constants import _DEFAULT_SUMMARY_CACHE_SIZE
+
+# The summaries of the chunks and the intermediate merges, keyed by the
+# model, the system prompt and the hash of the text
+_summary_cache: OrderedDict = OrderedDict()
+_summary_cache_size = _DEFAULT_SUMMARY_CACHE_SIZE
+_summary_cache_lock = threading.Lock()
+
+
+def configure_summary_cache(
+    cache_size: int = _DEFAULT_SUMMARY_CACHE_SIZE,
+) -> None:
+    """Configure the in-memory cache of the chunk summaries used by
+    `summarization` with `chunk_tokens`, which is shared in the process.
+    The cached summaries are cleared.
+
+    Args:
+        cache_size (`int`, defaults to `4096`):
+            The maximum number of cached summaries, the least recently used
+            ones are evicted. Set to 0 to disable the cache.
+    """
+    global _summary_cache_size
+    with _summary_cache_lock:
+        _summary_cache_size = cache_size
+        _summary_cache.clear()
+
+
+def clear_summary_cache() -> None:
+    """Clear the cached chunk summaries."""
+    with _summary_cache_lock:
+        _summary_cache.clear()
 
 
 def summarization(
@@ -18,12 +59,21 @@ def summarization(
     system_prompt: str = _DEFAULT_SYSTEM_PROMPT,
     max_return_token: int = -1,
     token_limit_prompt: str = _DEFAULT_TOKEN_LIMIT_PROMPT,
+    chunk_tokens: Optional[int] = None,
+    max_workers: int = 4,
 ) -> ServiceResponse:
     """Summarize the input text.
 
     Summarization function (Notice: current version of token limitation is
     built with Open AI API)
 
+    If `chunk_tokens` is given and the text is longer than it, the text is
+    split into chunks at paragraph boundaries, which are summarized in
+    parallel and then merged hierarchically until the summaries fit in one
+    model call. The chunk summaries are cached by their content (see
+    `configure_summary_cache`), so summarizing an edited text again only
+    re-processes the changed chunks.
+
     Args:
         model (`ModelWrapperBase`):
             Model used to summarize provided text.
@@ -37,6 +87,11 @@ def summarization(
             number of tokens in summarization returned by the model.
         token_limit_prompt (`str`, defaults to `_DEFAULT_TOKEN_LIMIT_PROMPT`):
             Prompt to instruct the model follow token limitation.
+        chunk_tokens (`Optional[int]`, defaults to `None`):
+            The maximum number of tokens of the text in a model call, e.g.
+            3000. By default, the text is summarized in one call.
+        max_workers (`int`, defaults to `4`):
+            The maximum number of chunks summarized at the same time.
 
     Returns:
         `ServiceResponse`: If the model successfully summarized the text, and
@@ -69,16 +124,21 @@ def summarization(
 
     Messages will be processed by model.format() before feeding to models.
     """
+    final_prompt = system_prompt
     if max_return_token > 0:
-        system_prompt += token_limit_prompt.format(max_return_token)
+        final_prompt += token_limit_prompt.format(max_return_token)
     try:
-        msgs = [
-            Msg(name="system", role="system", content=system_prompt),
-            Msg(name="user", role="user", content=text),
-        ]
-        msgs = model.format(msgs)
-        model_output = model(messages=msgs)
-        summary = model_output.text
+        if chunk_tokens is not None and chunk_tokens > 0:
+            text, is_merged = _map_reduce(
+                model,
+                text,
+                system_prompt,
+                chunk_tokens,
+                max_workers,
+            )
+            if is_merged:
+                final_prompt += _DEFAULT_MERGE_SUMMARY_PROMPT
+        summary = _summarize(model, text, final_prompt)
         return ServiceResponse(
             ServiceExecStatus.SUCCESS,
             content=summary,
@@ -89,3 +149,171 @@ def summarization(
             ServiceExecStatus.ERROR,
             content=f"Summarization by model {model.model} fail",
         )
+
+
+def _map_reduce(
+    model: ModelWrapperBase,
+    text: str,
+    system_prompt: str,
+    chunk_tokens: int,
+    max_workers: int,
+) -> Tuple[str, bool]:
+    """Summarize the chunks of the text, and merge the summaries level by
+    level until they fit in `chunk_tokens`.
+
+    Returns:
+        `Tuple[str, bool]`: The text for the final summarization, and
+        whether it consists of the summaries of chunks.
+    """
+    model_name = getattr(model, "model_name", None)
+    chunks = _split_into_chunks(text, chunk_tokens, model_name)
+    if len(chunks) <= 1:
+        return text, False
+
+    prompt = system_prompt
+    while True:
+        workers = max(1, min(max_workers, len(chunks)))
+        with ThreadPoolExecutor(max_workers=workers) as executor:
+            summaries = list(
+                executor.map(
+                    partial(
+                        _summarize,
+                        model,
+                        system_prompt=prompt,
+                        use_cache=True,
+                    ),
+                    chunks,
+                ),
+            )
+        text = "\n\n".join(summaries)
+        if count_text_tokens(text, model_name) <= chunk_tokens:
+            break
+
+        prompt = system_prompt + _DEFAULT_MERGE_SUMMARY_PROMPT
+        chunks = _split_into_chunks(text, chunk_tokens, model_name)
+        if len(chunks) >= len(summaries):
+            # The summaries cannot be merged further within the limit
+            logger.warning(
+                f"The summaries of {len(summaries)} chunks exceed "
+                f"{chunk_tokens} tokens after merging.",
+            )
+            break
+
+    return text, True
+
+
+def _summarize(
+    model: ModelWrapperBase,
+    text: str,
+    system_prompt: str,
+    use_cache: bool = False,
+) -> str:
+    """Summarize the text in one model call."""
+    key = None
+    if use_cache:
+        key = (
+            getattr(model, "config_name", None),
+            getattr(model, "model_name", None),
+            system_prompt,
+            hashlib.md5(text.encode("utf-8")).hexdigest(),
+        )
+        with _summary_cache_lock:
+            if key in _summary_cache:
+                _summary_cache.move_to_end(key)
+                return _summary_cache[key]
+
+    msgs = [
+        Msg(name="system", role="system", content=system_prompt),
+        Msg(name="user", role="user", content=text),
+    ]
+    msgs = model.format(msgs)
+    summary = model(messages=msgs).text
+
+    if key is not None:
+        with _summary_cache_lock:
+            _summary_cache[key] = summary
+            while len(_summary_cache) > _summary_cache_size:
+                _summary_cache.popitem(last=False)
+    return summary
+
+
+def _split_into_chunks(
+    text: str,
+    chunk_tokens: int,
+    model_name: Optional[str] = None,
+) -> List[str]:
+    """Split the text into chunks within `chunk_tokens` at paragraph
+    boundaries.
+
+    Besides when it's full, a chunk ends at an anchor paragraph (selected
+    by its hash) once it's half full. So the boundaries are determined by
+    the nearby content, and an edit only changes the chunks around it
+    instead of shifting all the following ones.
+    """
+    pieces = []
+    for paragraph in re.split(r"\n\s*\n", text):
+        if paragraph.strip():
+            pieces.extend(
+                _split_paragraph(paragraph, chunk_tokens, model_name)
+            )
+
+    chunks: List[str] = []
+    current: List[str] = []
+    current_tokens = 0
+    for piece, n_tokens in pieces:
+        if current and current_tokens + n_tokens > chunk_tokens:
+            chunks.append("\n\n".join(current))
+            current, current_tokens = [], 0
+        current.append(piece)
+        current_tokens += n_tokens
+        if current_tokens >= chunk_tokens // 2 and _is_anchor(piece):
+            chunks.append("\n\n".join(current))
+            current, current_tokens = [], 0
+    if current:
+        chunks.append("\n\n".join(current))
+    return chunks
+
+
+def _split_paragraph(
+    paragraph: str,
+    chunk_tokens: int,
+    model_name: Optional[str] = None,
+) -> List[Tuple[str, int]]:
+    """Split a paragraph longer than `chunk_tokens` at the ends of sentences,
+    or by characters if a sentence is still too long.
+
+    Returns:
+        `List[Tuple[str, int]]`: The pieces and their numbers of tokens.
+    """
+    n_tokens = count_text_tokens(paragraph, model_name)
+    if n_tokens <= chunk_tokens:
+        return [(paragraph, n_tokens)]
+
+    pieces = []
+    current, current_tokens = "", 0
+    for sentence in re.findall(r"[^.!?。！？\n]*(?:[.!?。！？\n]+|$)", paragraph):
+        if not sentence:
+            continue
+        n_sentence = count_text_tokens(sentence, model_name)
+        if n_sentence > chunk_tokens:
+            if current:
+                pieces.append((current, current_tokens))
+                current, current_tokens = "", 0
+            step = max(1, len(sentence) * chunk_tokens // n_sentence)
+            for i in range(0, len(sentence), step):
+                part = sentence[i : i + step]
+                pieces.append((part, count_text_tokens(part, model_name)))
+            continue
+        if current and current_tokens + n_sentence > chunk_tokens:
+            pieces.append((current, current_tokens))
+            current, current_tokens = "", 0
+        current += sentence
+        current_tokens += n_sentence
+    if current:
+        pieces.append((current, current_tokens))
+    return pieces
+
+
+def _is_anchor(piece: str) -> bool:
+    """Whether a chunk can end after the piece, selected by its hash."""
+    return int(hashlib.md5(piece.encode("utf-8")).hexdigest(), 16) % 4 == 0
@@ -291,3 +291,6 @@ def arxiv_search(
             status=ServiceExecStatus.ERROR,
             content=f"Error: {e}",
         )
+
+
+arxiv_search.ttl = 600
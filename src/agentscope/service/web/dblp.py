@@ -316,3 +316,8 @@ def dblp_search_venues(
         }
         parsed_data.append(entry_dict)
     return ServiceResponse(ServiceExecStatus.SUCCESS, parsed_data)
+
+
+dblp_search_publications.ttl = 600
+dblp_search_authors.ttl = 600
+dblp_search_venues.ttl = 600
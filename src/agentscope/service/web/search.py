@@ -193,3 +193,7 @@ def google_search(
             for result in results
         ],
     )
+
+
+bing_search.ttl = 600
+google_search.ttl = 600
@@ -1,9 +1,19 @@
 # -*- coding: utf-8 -*-
 """parsing and digesting the web pages"""
+import hashlib
 import json
+import os
+import tempfile
+import threading
+import time
+from collections import defaultdict
+from concurrent.futures import ThreadPoolExecutor
+from html.parser import HTMLParser
+from itertools import zip_longest
 from urllib.parse import urlparse
-from typing import Optional, Callable, Sequence, Any
+from typing import Optional, Callable, Sequence, Any, List, Tuple
 import requests
+from requests.structures import CaseInsensitiveDict
 from loguru import logger
 
 
@@ -11,6 +21,11 @@ from agentscope.service.service_response import ServiceResponse
 from agentscope.service.service_status import ServiceExecStatus
 from agentscope.models.model import ModelWrapperBase
 from agentscope.service import summarization
+from agentscope.utils.http_session import get_http_session
+from agentscope.constants import (
+    _DEFAULT_WEB_CACHE_MAX_AGE,
+    _DEFAULT_WEB_CACHE_MAX_BYTES,
+)
 
 
 DEFAULT_WEB_SYS_PROMPT = (
@@ -18,6 +33,44 @@ DEFAULT_WEB_SYS_PROMPT = (
     "and useful information from html or webpage description.\n"
 )
 
+_DEFAULT_HEADERS = {
+    "Accept-Language": "zh-CN,zh;q=0.9,en;q=0.8,en-GB;q=0.7,en-US;q=0.6",
+    "Cache-Control": "max-age=0",
+    "Upgrade-Insecure-Requests": "1",
+    "User-Agent": "Mozilla/5.0 (X11; Linux x86_64)"
+    " AppleWebKit/537.36 (KHTML, like Gecko) ",
+}
+
+# The elements without children, whose end tags are omitted
+_VOID_ELEMENTS = {
+    "area",
+    "base",
+    "basefont",
+    "bgsound",
+    "br",
+    "col",
+    "command",
+    "embed",
+    "frame",
+    "hr",
+    "image",
+    "img",
+    "input",
+    "isindex",
+    "keygen",
+    "link",
+    "menuitem",
+    "meta",
+    "nextid",
+    "param",
+    "source",
+    "spacer",
+    "track",
+    "wbr",
+}
+# The elements whose content is not text
+_NON_TEXT_ELEMENTS = {"script", "style"}
+
 
 def is_valid_url(url: str) -> bool:
     """
@@ -43,6 +96,7 @@ def load_web(
     html_selected_tags: Optional[Sequence[str]] = None,
     self_parse_func: Optional[Callable[[requests.Response], Any]] = None,
     timeout: int = 5,
+    cache_dir: Optional[str] = None,
 ) -> ServiceResponse:
     """Function for parsing and digesting the web page.
 
@@ -62,6 +116,10 @@ def load_web(
             The result is stored with `self_define_func`
             key
         timeout (int): timeout parameter for requests.
+        cache_dir (Optional[str]):
+            The directory to cache the web pages. If given, the cached page
+            is revalidated by a conditional request with its ETag or
+            Last-Modified header, and reused if the page is not modified.
 
     Returns:
         `ServiceResponse`: If successful, `ServiceResponse` object is returned
@@ -87,15 +145,8 @@ def load_web(
                 "selected_tags_text": xxxxx
             }
     """
-    header = {
-        "Accept-Language": "zh-CN,zh;q=0.9,en;q=0.8,en-GB;q=0.7,en-US;q=0.6",
-        "Cache-Control": "max-age=0",
-        "Upgrade-Insecure-Requests": "1",
-        "User-Agent": "Mozilla/5.0 (X11; Linux x86_64)"
-        " AppleWebKit/537.36 (KHTML, like Gecko) ",
-    }
     try:
-        response = requests.get(url=url, headers=header, timeout=timeout)
+        response = _get_web_page(url, timeout, cache_dir)
 
         if response.status_code == 200:
             results = {}
@@ -150,6 +201,330 @@ def load_web(
         return ServiceResponse(ServiceExecStatus.ERROR, content="")
 
 
+def load_webs(
+    urls: Sequence[str],
+    keep_raw: bool = True,
+    html_selected_tags: Optional[Sequence[str]] = None,
+    self_parse_func: Optional[Callable[[requests.Response], Any]] = None,
+    timeout: int = 5,
+    max_workers: int = 8,
+    max_per_host: int = 2,
+    cache_dir: Optional[str] = None,
+) -> ServiceResponse:
+    """Load and parse a batch of web pages concurrently, e.g. the links in
+    a page of search results.
+
+    Args:
+        urls (Sequence[str]): the urls of the web pages
+        keep_raw (bool):
+            Whether to keep raw HTML. If True, the content is
+            stored with key "raw".
+        html_selected_tags (Optional[Sequence[str]]):
+            the text in elements of `html_selected_tags` will
+            be extracted and stored with "html_to_text"
+            key in return.
+        self_parse_func (Optional[Callable]):
+            if "self_parse_func" is not None, then the
+            function will be invoked with the
+            requests.Response as input.
+        timeout (int): timeout parameter for requests.
+        max_workers (int):
+            The maximum number of web pages loaded at the same time.
+        max_per_host (int):
+            The maximum number of web pages loaded from the same host at the
+            same time, so that a site is not flooded with requests.
+        cache_dir (Optional[str]):
+            The directory to cache the web pages, see `load_web`.
+
+    Returns:
+        `ServiceResponse`: The status is `SUCCESS` if any web page is
+        loaded, and the `content` field is a dict from each url to the
+        `ServiceResponse` of `load_web`, in the order of `urls`.
+    """
+    # Duplicated urls are loaded only once
+    unique_urls = list(dict.fromkeys(urls))
+
+    # Interleave the urls of different hosts, so that the workers are not
+    # all blocked by the limit of the same host
+    urls_by_host = defaultdict(list)
+    for url in unique_urls:
+        urls_by_host[urlparse(url).netloc].append(url)
+    ordered_urls = [
+        url
+        for group in zip_longest(*urls_by_host.values())
+        for url in group
+        if url is not None
+    ]
+    host_limits = {
+        host: threading.BoundedSemaphore(max(1, max_per_host))
+        for host in urls_by_host
+    }
+
+    def _load(url: str) -> ServiceResponse:
+        with host_limits[urlparse(url).netloc]:
+            return load_web(
+                url=url,
+                keep_raw=keep_raw,
+                html_selected_tags=html_selected_tags,
+                self_parse_func=self_parse_func,
+                timeout=timeout,
+                cache_dir=cache_dir,
+            )
+
+    with ThreadPoolExecutor(
+        max_workers=max(1, min(max_workers, len(ordered_urls))),
+    ) as executor:
+        responses = dict(
+            zip(ordered_urls, executor.map(_load, ordered_urls)),
+        )
+
+    results = {url: responses[url] for url in unique_urls}
+    if any(_.status == ServiceExecStatus.SUCCESS for _ in results.values()):
+        status = ServiceExecStatus.SUCCESS
+    else:
+        status = ServiceExecStatus.ERROR
+    return ServiceResponse(status, content=results)
+
+
+def _get_web_page(
+    url: str,
+    timeout: int,
+    cache_dir: Optional[str] = None,
+) -> requests.Response:
+    """Get the web page, which is revalidated and reused from the cache if
+    `cache_dir` is given."""
+    if cache_dir is None:
+        return get_http_session().get(
+            url=url,
+            headers=_DEFAULT_HEADERS,
+            timeout=timeout,
+        )
+
+    cache = _WebPageCache(cache_dir)
+    response = get_http_session().get(
+        url=url,
+        headers={**_DEFAULT_HEADERS, **cache.validators(url)},
+        timeout=timeout,
+    )
+    if response.status_code == 304:
+        cached_response = cache.load(url)
+        if cached_response is not None:
+            return cached_response
+        # The cached page is removed after the request, fetch it again
+        response = get_http_session().get(
+            url=url,
+            headers=_DEFAULT_HEADERS,
+            timeout=timeout,
+        )
+    if response.status_code == 200:
+        cache.save(url, response)
+    return response
+
+
+class _WebPageCache:
+    """A disk cache of the web pages keyed by url. Each page is stored in a
+    single file with a line of json metadata followed by the body, so that
+    it can be replaced atomically. The pages not used within `max_age`
+    seconds are evicted, and then the least recently used ones until the
+    cache fits in `max_bytes`."""
+
+    _CACHED_HEADERS = ("Content-Type", "ETag", "Last-Modified")
+
+    def __init__(
+        self,
+        cache_dir: str,
+        max_bytes: int = _DEFAULT_WEB_CACHE_MAX_BYTES,
+        max_age: float = _DEFAULT_WEB_CACHE_MAX_AGE,
+    ) -> None:
+        self.cache_dir = cache_dir
+        self.max_bytes = max_bytes
+        self.max_age = max_age
+        os.makedirs(cache_dir, exist_ok=True)
+
+    def _path(self, url: str) -> str:
+        """The path of the cache file of the url."""
+        key = hashlib.md5(url.encode("utf-8")).hexdigest()
+        return os.path.join(self.cache_dir, f"{key}.page")
+
+    def _read(self, url: str) -> Optional[Tuple[dict, bytes]]:
+        """Read the metadata and the body of the cached page."""
+        try:
+            with open(self._path(url), "rb") as file:
+                meta, body = file.read().split(b"\n", 1)
+            meta = json.loads(meta)
+        except (OSError, ValueError):
+            return None
+        # Guard against the collision of the hash
+        if meta.get("url") != url:
+            return None
+        return meta, body
+
+    def validators(self, url: str) -> dict:
+        """The headers of the conditional request for the cached page."""
+        cached = self._read(url)
+        if cached is None:
+            return {}
+        headers = CaseInsensitiveDict(cached[0]["headers"])
+        validators = {}
+        if headers.get("ETag"):
+            validators["If-None-Match"] = headers["ETag"]
+        if headers.get("Last-Modified"):
+            validators["If-Modified-Since"] = headers["Last-Modified"]
+        return validators
+
+    def load(self, url: str) -> Optional[requests.Response]:
+        """Rebuild the response of the cached page."""
+        cached = self._read(url)
+        if cached is None:
+            return None
+        meta, body = cached
+        try:
+            # Mark the page as recently used
+            os.utime(self._path(url))
+        except OSError:
+            pass
+        response = requests.Response()
+        response.status_code = 200
+        response.url = url
+        response.headers = CaseInsensitiveDict(meta["headers"])
+        response.encoding = meta["encoding"]
+        # pylint: disable=protected-access
+        response._content = body
+        return response
+
+    def save(self, url: str, response: requests.Response) -> None:
+        """Cache the page if it can be revalidated."""
+        response_headers = CaseInsensitiveDict(response.headers)
+        headers = {
+            key: response_headers[key]
+            for key in self._CACHED_HEADERS
+            if response_headers.get(key)
+        }
+        if "ETag" not in headers and "Last-Modified" not in headers:
+            return
+        meta = {
+            "url": url,
+            "headers": headers,
+            "encoding": response.encoding,
+        }
+        fd, tmp_path = tempfile.mkstemp(dir=self.cache_dir)
+        try:
+            with os.fdopen(fd, "wb") as file:
+                file.write(json.dumps(meta).encode("utf-8") + b"\n")
+                file.write(response.content)
+            os.replace(tmp_path, self._path(url))
+        except OSError as e:
+            logger.warning(f"Fail to cache the web page {url}: {e}")
+            if os.path.exists(tmp_path):
+                os.remove(tmp_path)
+            return
+        self._evict()
+
+    def _evict(self) -> None:
+        """Remove the expired pages, and then the least recently used ones
+        until the cache fits in the size limit."""
+        pages = []
+        with os.scandir(self.cache_dir) as entries:
+            for entry in entries:
+                if not entry.name.endswith(".page"):
+                    continue
+                try:
+                    stat = entry.stat()
+                except OSError:
+                    continue
+                pages.append((stat.st_mtime, stat.st_size, entry.path))
+
+        pages.sort()
+        expire_time = time.time() - self.max_age
+        total_bytes = sum(size for _, size, _ in pages)
+        for mtime, size, path in pages:
+            if mtime >= expire_time and total_bytes <= self.max_bytes:
+                break
+            try:
+                os.remove(path)
+            except OSError:
+                # Removed by another thread or process
+                pass
+            total_bytes -= size
+
+
+class HTMLTextExtractor(HTMLParser):
+    """Extract the text in the selected elements of HTML in a single pass.
+    The HTML can be fed in chunks, and only the text of the selected
+    elements is kept in memory.
+
+    The text of each outermost selected element is concatenated, where the
+    whitespaces are collapsed, and the text of a link is formatted as
+    `[text](href)` if `href` is a valid url.
+    """
+
+    def __init__(self, html_selected_tags: Sequence[str]) -> None:
+        super().__init__(convert_charrefs=True)
+        self.html_selected_tags = set(html_selected_tags)
+        # The open elements, each of (tag, href, text parts), where the text
+        # parts are None if the element is not within a selected one
+        self._stack: List[Tuple[str, Optional[str], Optional[list]]] = []
+        self._texts: List[str] = []
+
+    @property
+    def text(self) -> str:
+        """The text extracted from the closed elements."""
+        return "".join(self._texts)
+
+    def handle_starttag(
+        self,
+        tag: str,
+        attrs: List[Tuple[str, Optional[str]]],
+    ) -> None:
+        """Open an element."""
+        if tag in _VOID_ELEMENTS:
+            return
+        collecting = tag in self.html_selected_tags or (
+            bool(self._stack) and self._stack[-1][2] is not None
+        )
+        href = dict(attrs).get("href") if tag == "a" else None
+        self._stack.append((tag, href, [] if collecting else None))
+
+    def handle_endtag(self, tag: str) -> None:
+        """Close the element and the unclosed ones inside it, or ignore
+        the stray end tag."""
+        for index in range(len(self._stack) - 1, -1, -1):
+            if self._stack[index][0] == tag:
+                while len(self._stack) > index:
+                    self._close_element()
+                return
+
+    def handle_data(self, data: str) -> None:
+        """Collect the text of the innermost open element."""
+        if not self._stack or self._stack[-1][2] is None:
+            return
+        tag, href, parts = self._stack[-1]
+        if tag in _NON_TEXT_ELEMENTS:
+            return
+        if tag == "a" and href:
+            if is_valid_url(href):
+                parts.append(f"[{data.strip()}]({href})")
+        else:
+            parts.append(data)
+
+    def close(self) -> None:
+        """Finish parsing and close the remaining elements."""
+        super().close()
+        while self._stack:
+            self._close_element()
+
+    def _close_element(self) -> None:
+        """Pop the innermost open element and collect its text."""
+        _, _, parts = self._stack.pop()
+        if parts is None:
+            return
+        text = " ".join("".join(parts).split())
+        if self._stack and self._stack[-1][2] is not None:
+            self._stack[-1][2].append(text)
+        else:
+            self._texts.append(text)
+
+
 def parse_html_to_text(
     html_text: str,
     html_selected_tags: Optional[Sequence[str]] = None,
@@ -165,50 +540,18 @@ def parse_html_to_text(
             be extracted and returned.
 
     Returns:
-        `ServiceResponse`: If successful, `ServiceResponse` object is returned
-        with `content` field is processed text content of the selected tags,
+        `str`: The processed text content of the selected tags.
     """
-    if html_selected_tags:
-        logger.info(
-            f"extracting text information from tags: " f"{html_selected_tags}",
-        )
-        try:
-            from bs4 import BeautifulSoup, NavigableString, Tag
-        except ImportError as exc:
-            raise ImportError(
-                "BeautifulSoup4 is required for processing the "
-                "web page without model."
-                "Please install with `pip install bs4` .",
-            ) from exc
-
-        doc = BeautifulSoup(html_text, "html.parser")
-
-        def get_navigable_strings(
-            e: Tag,
-        ) -> str:
-            # pylint: disable=cell-var-from-loop
-            text = ""
-            for child in e.children:
-                if isinstance(child, Tag):
-                    # pylint: disable=cell-var-from-loop
-                    text += get_navigable_strings(child).strip(" \n\t")
-                elif isinstance(child, NavigableString):
-                    if (e.name == "a") and (href := e.get("href")):
-                        if is_valid_url(href):
-                            text += f"[{child.strip()}]({href})"
-                    else:
-                        text += child.text
-            return " ".join(text.split())
-
-        text_parts = ""
-        for element in doc.find_all(recursive=True):
-            if element.name in html_selected_tags:
-                text_parts += get_navigable_strings(element).strip(" \n\t")
-                element.decompose()
-    else:
-        text_parts = ""
+    if not html_selected_tags:
+        return ""
 
-    return text_parts
+    logger.info(
+        f"extracting text information from tags: " f"{html_selected_tags}",
+    )
+    extractor = HTMLTextExtractor(html_selected_tags)
+    extractor.feed(html_text)
+    extractor.close()
+    return extractor.text
 
 
 def digest_webpage(
@@ -216,6 +559,7 @@ def digest_webpage(
     model: ModelWrapperBase = None,
     html_selected_tags: Sequence[str] = ("h", "p", "li", "div", "a"),
     digest_prompt: str = DEFAULT_WEB_SYS_PROMPT,
+    chunk_tokens: Optional[int] = None,
 ) -> ServiceResponse:
     """Digest the given webpage.
 
@@ -227,6 +571,9 @@ def digest_webpage(
             be extracted and feed to the model
         digest_prompt (str): system prompt for the model to digest
             the web content
+        chunk_tokens (Optional[int]): if given, a web page longer than it
+            is digested by chunks, see `summarization`. By default, the web
+            page is digested in one model call.
 
     Returns:
         `ServiceResponse`: If successful, `ServiceResponse` object is returned
@@ -251,4 +598,5 @@ def digest_webpage(
         model=model,
         text=web_text,
         system_prompt=digest_prompt,
+        chunk_tokens=chunk_tokens,
     )
@@ -2,12 +2,12 @@
 """The client for AgentScope Studio."""
 from threading import Event
 from typing import Optional, Union
-import requests
 
 import socketio
 from loguru import logger
 
 from agentscope.message import Msg
+from agentscope.utils.http_session import get_http_session
 
 
 class _WebSocketClient:
@@ -114,7 +114,7 @@ class StudioClient:
     ) -> None:
         """Register a running instance to the AgentScope Studio."""
         url = f"{self.studio_url}/api/runs/register"
-        response = requests.post(
+        response = get_http_session().post(
             url,
             json={
                 "run_id": self.runtime_id,
@@ -149,7 +149,7 @@ class StudioClient:
                 The message to be pushed.
         """
         send_url = f"{self.studio_url}/api/messages/push"
-        response = requests.post(
+        response = get_http_session().post(
             send_url,
             json={
                 "run_id": self.runtime_id,
@@ -13,6 +13,7 @@ import requests
 
 from agentscope.service.service_response import ServiceResponse
 from agentscope.service.service_status import ServiceExecStatus
+from agentscope.utils.http_session import get_http_session
 
 
 @contextlib.contextmanager
@@ -149,10 +150,15 @@ def requests_get(
     # Make the request
     try:
         # Check if headers are provided, and include them if they are not None
+        # Reuse the pooled connections of the shared session
         if headers:
-            response = requests.get(url, params=params, headers=headers)
+            response = get_http_session().get(
+                url,
+                params=params,
+                headers=headers,
+            )
         else:
-            response = requests.get(url, params=params)
+            response = get_http_session().get(url, params=params)
         # This will raise an exception for HTTP error codes
         response.raise_for_status()
     except requests.RequestException as e:
@@ -0,0 +1,113 @@
+# -*- coding: utf-8 -*-
+"""A shared, connection-pooled HTTP session, so that the post-API model
+wrappers, web services and the studio client reuse keep-alive connections
+instead of doing a fresh TCP/TLS handshake per call."""
+import os
+import threading
+from http.cookiejar import DefaultCookiePolicy
+from typing import Optional
+
+import requests
+from requests.adapters import HTTPAdapter
+
+from ..constants import _DEFAULT_HTTP_POOL_CONNECTIONS
+from ..constants import _DEFAULT_HTTP_POOL_MAXSIZE
+
+_SESSION_CONFIG = {
+    "pool_connections": _DEFAULT_HTTP_POOL_CONNECTIONS,
+    "pool_maxsize": _DEFAULT_HTTP_POOL_MAXSIZE,
+    "pool_block": False,
+    "max_retries": 0,
+    "headers": None,
+}
+
+_session: Optional[requests.Session] = None
+_session_pid: Optional[int] = None
+_session_lock = threading.Lock()
+
+
+def _create_session() -> requests.Session:
+    """Create a session with the current configuration."""
+    session = requests.Session()
+    # The session is shared by unrelated callers and threads, so that the
+    # cookies set by a server are neither kept nor sent to it again
+    session.cookies.set_policy(DefaultCookiePolicy(allowed_domains=[]))
+    adapter = HTTPAdapter(
+        pool_connections=_SESSION_CONFIG["pool_connections"],
+        pool_maxsize=_SESSION_CONFIG["pool_maxsize"],
+        pool_block=_SESSION_CONFIG["pool_block"],
+        max_retries=_SESSION_CONFIG["max_retries"],
+    )
+    session.mount("http://", adapter)
+    session.mount("https://", adapter)
+    if _SESSION_CONFIG["headers"]:
+        session.headers.update(_SESSION_CONFIG["headers"])
+    return session
+
+
+def get_http_session() -> requests.Session:
+    """Get the HTTP session shared within the current process.
+
+    Note:
+        The pooled connections cannot be shared across processes, so a new
+        session is created after the process is forked. The session doesn't
+        keep cookies, which would otherwise leak between the callers; pass
+        them with `cookies=` in each request if needed, and don't modify
+        the shared session.
+
+    Returns:
+        `requests.Session`: The shared session.
+    """
+    global _session, _session_pid
+    if _session is not None and _session_pid == os.getpid():
+        return _session
+
+    with _session_lock:
+        if _session is None or _session_pid != os.getpid():
+            _session = _create_session()
+            _session_pid = os.getpid()
+    return _session
+
+
+def configure_http_session(
+    pool_connections: int = _DEFAULT_HTTP_POOL_CONNECTIONS,
+    pool_maxsize: int = _DEFAULT_HTTP_POOL_MAXSIZE,
+    pool_block: bool = False,
+    max_retries: int = 0,
+    headers: Optional[dict] = None,
+) -> None:
+    """Configure the shared HTTP session. The existing session (and its
+    pooled connections) will be closed and replaced.
+
+    Args:
+        pool_connections (`int`, defaults to `10`):
+            The number of hosts whose connection pools are cached.
+        pool_maxsize (`int`, defaults to `10`):
+            The maximum number of kept-alive connections per host.
+        pool_block (`bool`, defaults to `False`):
+            Whether to block when all the connections to a host are in use,
+            which limits the number of concurrent connections per host to
+            `pool_maxsize`. Otherwise, extra connections are opened and
+            discarded after use.
+        max_retries (`int`, defaults to `0`):
+            The number of retries for failed connections. Note it applies
+            only to failed DNS lookups, socket connections and connection
+            timeouts.
+        headers (`Optional[dict]`, defaults to `None`):
+            The default headers sent with every request.
+    """
+    global _session, _session_pid
+    with _session_lock:
+        _SESSION_CONFIG.update(
+            {
+                "pool_connections": pool_connections,
+                "pool_maxsize": pool_maxsize,
+                "pool_block": pool_block,
+                "max_retries": max_retries,
+                "headers": headers,
+            },
+        )
+        if _session is not None and _session_pid == os.getpid():
+            _session.close()
+        _session = None
+        _session_pid = None
@@ -714,3 +714,19 @@ class MonitorFactory:
         Flush the monitor singleton.
         """
         cls._instance = None
+
+
+def record_parse_tier(tier: str) -> None:
+    """Count the response parsing errors by the tier that recovers them,
+    i.e. `"repaired"`, `"continued"` and `"regenerated"`, or `"failed"` if
+    none of them works. The counts are recorded in the monitor as
+    `response_parsing.{tier}`.
+
+    Args:
+        tier (`str`):
+            The tier that recovers the parsing error.
+    """
+    monitor = MonitorFactory.get_monitor()
+    metric_name = get_full_name(name=tier, prefix="response_parsing")
+    monitor.register(metric_name, metric_unit="times")
+    monitor.add(metric_name, 1)
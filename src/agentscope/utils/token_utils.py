@@ -1,8 +1,12 @@
 # -*- coding: utf-8 -*-
 """Token utils."""
-from typing import Union
+import threading
+from collections import OrderedDict
+from typing import Union, Optional, Any
 from loguru import logger
 
+from .tools import _convert_to_str
+
 try:
     import tiktoken
 except ImportError:
@@ -153,3 +157,105 @@ def num_tokens_from_content(content: list, model: str) -> int:
     # every reply is primed with <|start|>assistant<|message|>
     num_tokens += 3
     return num_tokens
+
+
+_TOKENS_PER_MESSAGE = 4
+"""The approximate number of extra tokens used by each message for its role
+and separators in chat APIs."""
+
+_MSG_TOKEN_CACHE_SIZE = 65536
+_msg_token_cache: OrderedDict = OrderedDict()
+_msg_token_cache_lock = threading.Lock()
+_encodings: dict = {}
+
+
+def _get_encoding(model_name: Optional[str]) -> Any:
+    """Get the tiktoken encoding of the model, and fall back to cl100k_base
+    for unknown (e.g. non-OpenAI) models. Returns `None` if tiktoken is not
+    installed or the encoding cannot be loaded (e.g. offline)."""
+    if tiktoken is None:
+        return None
+    if model_name not in _encodings:
+        try:
+            try:
+                encoding = tiktoken.encoding_for_model(model_name)
+            except (KeyError, TypeError):
+                encoding = tiktoken.get_encoding("cl100k_base")
+        except Exception as e:
+            logger.warning(
+                f"Fail to load the tiktoken encoding for model "
+                f"[{model_name}], estimate the tokens by characters "
+                f"instead: {e}",
+            )
+            encoding = None
+        _encodings[model_name] = encoding
+    return _encodings[model_name]
+
+
+def count_text_tokens(text: str, model_name: Optional[str] = None) -> int:
+    """Count the tokens of a piece of text. For models without a known
+    tokenizer, the count of cl100k_base encoding is used as an estimation,
+    or 4 characters per token if tiktoken is not available.
+
+    Args:
+        text (`str`):
+            The text to be counted.
+        model_name (`Optional[str]`, defaults to `None`):
+            The name of the model.
+
+    Returns:
+        `int`: The (estimated) number of tokens.
+    """
+    encoding = _get_encoding(model_name)
+    if encoding is None:
+        return (len(text) + 3) // 4
+    return len(encoding.encode(text, disallowed_special=()))
+
+
+def count_msg_tokens(msg: Any, model_name: Optional[str] = None) -> int:
+    """Count the tokens of a message (a `Msg` object, a dict or a string)
+    in a chat prompt. The count of a `Msg` object is cached by its id and
+    content, so that counting the whole memory on every call only costs the
+    newly added messages.
+
+    Args:
+        msg (`Any`):
+            The message to be counted.
+        model_name (`Optional[str]`, defaults to `None`):
+            The name of the model.
+
+    Returns:
+        `int`: The (estimated) number of tokens.
+    """
+    if not isinstance(msg, dict):
+        return count_text_tokens(_convert_to_str(msg), model_name)
+
+    text = _convert_to_str(msg.get("content", ""))
+    name = msg.get("name", None) or ""
+
+    msg_id = getattr(msg, "id", None)
+    if msg_id is None:
+        return (
+            count_text_tokens(text, model_name)
+            + count_text_tokens(name, model_name)
+            + _TOKENS_PER_MESSAGE
+        )
+
+    key = (msg_id, model_name)
+    fingerprint = hash((name, text))
+    with _msg_token_cache_lock:
+        cached = _msg_token_cache.get(key, None)
+        if cached is not None and cached[0] == fingerprint:
+            _msg_token_cache.move_to_end(key)
+            return cached[1]
+
+    n_tokens = (
+        count_text_tokens(text, model_name)
+        + count_text_tokens(name, model_name)
+        + _TOKENS_PER_MESSAGE
+    )
+    with _msg_token_cache_lock:
+        _msg_token_cache[key] = (fingerprint, n_tokens)
+        while len(_msg_token_cache) > _MSG_TOKEN_CACHE_SIZE:
+            _msg_token_cache.popitem(last=False)
+    return n_tokens
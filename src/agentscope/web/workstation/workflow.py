@@ -22,34 +22,49 @@ def load_config(config_path: str) -> dict:
     return config
 
 
-def start_workflow(config: dict) -> None:
+def start_workflow(config: dict, max_workers: int = 1) -> None:
     """Start the application workflow based on the given configuration.
 
     Args:
         config: A dictionary containing the application configuration.
+        max_workers: The maximum number of nodes executed at the same time,
+            defaults to executing the nodes one by one.
 
     This function will initialize and launch the application.
     """
     logger.info("Launching...")
 
     dag = build_dag(config)
-    dag.run()
+    dag.run(max_workers=max_workers)
 
     logger.info("Finished.")
 
 
-def compile_workflow(config: dict, compiled_filename: str = "main.py") -> None:
+def compile_workflow(
+    config: dict,
+    compiled_filename: str = "main.py",
+    parallel: bool = False,
+    max_workers: int = 4,
+) -> None:
     """Generates Python code based on the given configuration.
 
     Args:
         config: A dictionary containing the application configuration.
         compiled_filename: complied file name.
+        parallel: Whether to generate the code executing the independent
+            nodes concurrently.
+        max_workers: The maximum number of nodes executed at the same time
+            in the parallel code.
 
     """
     logger.info("Compiling...")
 
     dag = build_dag(config)
-    dag.compile(compiled_filename)
+    dag.compile(
+        compiled_filename,
+        parallel=parallel,
+        max_workers=max_workers,
+    )
 
     logger.info("Finished.")
 
@@ -78,6 +93,20 @@ def main() -> None:
         nargs="?",
         const="",
     )
+    parser.add_argument(
+        "--parallel",
+        action="store_true",
+        help="Execute the independent nodes concurrently, or compile the "
+        "workflow into the code doing so. Don't use it if the independent "
+        "nodes ask for user input.",
+    )
+    parser.add_argument(
+        "--max-workers",
+        type=int,
+        help="The maximum number of nodes executed at the same time with "
+        "--parallel.",
+        default=4,
+    )
     args = parser.parse_args()
     cfg_path = args.cfg
     compiled_filename = args.compile
@@ -85,7 +114,10 @@ def main() -> None:
     if cfg_path:
         config = load_config(cfg_path)
         if not compiled_filename:
-            start_workflow(config)
+            start_workflow(
+                config,
+                max_workers=args.max_workers if args.parallel else 1,
+            )
         else:
             if os.path.exists(compiled_filename):
                 while True:
@@ -101,7 +133,12 @@ def main() -> None:
                         break
 
                     logger.info("Invalid input.")
-            compile_workflow(config, compiled_filename)
+            compile_workflow(
+                config,
+                compiled_filename,
+                parallel=args.parallel,
+                max_workers=args.max_workers,
+            )
     else:
         raise FileNotFoundError("Please provide config file.")
 
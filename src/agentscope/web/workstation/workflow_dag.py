@@ -7,6 +7,7 @@ a computational DAG. Each node represents a step in the DAG and
 can perform certain actions when called.
 """
 import copy
+from functools import partial
 from typing import Any
 from loguru import logger
 
@@ -19,6 +20,7 @@ from agentscope.web.workstation.workflow_node import (
 from agentscope.web.workstation.workflow_utils import (
     is_callable_expression,
     kwarg_converter,
+    run_dag,
 )
 
 try:
@@ -72,47 +74,71 @@ class ASDiGraph(nx.DiGraph):
 
         self.execs = ["\n"]
 
-    def run(self) -> None:
+        # The running time of each node in the last run
+        self.node_timings = {}
+
+    def _sorted_nodes(self) -> list:
+        """Get the nodes in the computation graph in topological order."""
+        return [
+            node_id
+            for node_id in nx.topological_sort(self)
+            if node_id not in self.nodes_not_in_graph
+        ]
+
+    def run(self, max_workers: int = 1) -> None:
         """
         Execute the computations associated with each node in the graph.
 
         The method initializes AgentScope, performs a topological sort of
-        the nodes, and then runs each node's computation sequentially using
-        the outputs from its predecessors as inputs.
+        the nodes, and then runs each node's computation as soon as its
+        predecessors finish, using the output of its first predecessor as
+        input.
+
+        Args:
+            max_workers (`int`, defaults to `1`):
+                The maximum number of nodes executed at the same time. The
+                nodes are executed one by one by default. Only set it larger
+                than 1 if the independent nodes don't ask for user input,
+                otherwise the user agents on different branches may prompt
+                for input at the same time.
         """
         agentscope.init(logger_level="DEBUG")
-        sorted_nodes = list(nx.topological_sort(self))
-        sorted_nodes = [
-            node_id
-            for node_id in sorted_nodes
-            if node_id not in self.nodes_not_in_graph
-        ]
+        sorted_nodes = self._sorted_nodes()
         logger.info(f"sorted_nodes: {sorted_nodes}")
         logger.info(f"nodes_not_in_graph: {self.nodes_not_in_graph}")
 
-        # Cache output
-        values = {}
-
-        # Run with predecessors outputs
-        for node_id in sorted_nodes:
-            inputs = [
-                values[predecessor]
-                for predecessor in self.predecessors(node_id)
-            ]
-            if not inputs:
-                values[node_id] = self.exec_node(node_id)
-            elif len(inputs):
-                # Note: only support exec with the first predecessor now
-                values[node_id] = self.exec_node(node_id, inputs[0])
-            else:
-                raise ValueError("Too many predecessors!")
+        _, self.node_timings = run_dag(
+            {
+                node_id: partial(self.exec_node, node_id)
+                for node_id in sorted_nodes
+            },
+            {
+                node_id: list(self.predecessors(node_id))
+                for node_id in sorted_nodes
+            },
+            max_workers=max_workers,
+        )
 
     def compile(  # type: ignore[no-untyped-def]
         self,
         compiled_filename: str = "",
+        parallel: bool = False,
+        max_workers: int = 4,
         **kwargs,
     ) -> str:
-        """Compile DAG to a runnable python code"""
+        """Compile DAG to a runnable python code
+
+        Args:
+            compiled_filename (`str`, defaults to `""`):
+                The file to write the code into, not written if empty.
+            parallel (`bool`, defaults to `False`):
+                Whether to compile each node into a function and execute
+                them concurrently as `run` does, otherwise the nodes are
+                executed one by one in topological order.
+            max_workers (`int`, defaults to `4`):
+                The maximum number of nodes executed at the same time in the
+                parallel code.
+        """
 
         def format_python_code(code: str) -> str:
             try:
@@ -127,16 +153,20 @@ class ASDiGraph(nx.DiGraph):
             0
         ] = f'agentscope.init(logger_level="DEBUG", {kwarg_converter(kwargs)})'
 
-        sorted_nodes = list(nx.topological_sort(self))
-        sorted_nodes = [
-            node_id
-            for node_id in sorted_nodes
-            if node_id not in self.nodes_not_in_graph
-        ]
+        sorted_nodes = self._sorted_nodes()
 
-        for node_id in sorted_nodes:
-            node = self.nodes[node_id]
-            self.execs.append(node["compile_dict"]["execs"])
+        if parallel:
+            self.imports.append(
+                "from agentscope.web.workstation.workflow_utils import "
+                "run_dag",
+            )
+            self.execs.extend(
+                self._compile_parallel_execs(sorted_nodes, max_workers),
+            )
+        else:
+            for node_id in sorted_nodes:
+                node = self.nodes[node_id]
+                self.execs.append(node["compile_dict"]["execs"])
 
         header = "\n".join(self.imports)
 
@@ -161,6 +191,40 @@ class ASDiGraph(nx.DiGraph):
                 file.write(formatted_code)
         return formatted_code
 
+    def _compile_parallel_execs(
+        self,
+        sorted_nodes: list,
+        max_workers: int,
+    ) -> list:
+        """Compile each node into a function, and execute them by
+        `run_dag`."""
+        execs = []
+        funcs = []
+        for node_id in sorted_nodes:
+            func_name = f"node_{node_id}".replace("-", "_")
+            # Indent the continuation lines of the node code, since it's
+            # nested in a function
+            node_execs = self.nodes[node_id]["compile_dict"]["execs"].replace(
+                "\n",
+                "\n    ",
+            )
+            execs.append(
+                f"def {func_name}({DEFAULT_FLOW_VAR}):\n"
+                f"        {node_execs}\n"
+                f"        return {DEFAULT_FLOW_VAR}\n",
+            )
+            funcs.append(f'"{node_id}": {func_name}')
+
+        predecessors = {
+            node_id: list(self.predecessors(node_id))
+            for node_id in sorted_nodes
+        }
+        execs.append(
+            f"run_dag({{{', '.join(funcs)}}}, {predecessors!r}, "
+            f"{DEFAULT_FLOW_VAR}, max_workers={max_workers})",
+        )
+        return execs
+
     # pylint: disable=R0912
     def add_as_node(
         self,
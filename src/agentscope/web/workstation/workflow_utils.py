@@ -1,5 +1,15 @@
 # -*- coding: utf-8 -*-
 """Workflow node utils."""
+import time
+from concurrent.futures import (
+    FIRST_COMPLETED,
+    Future,
+    ThreadPoolExecutor,
+    wait,
+)
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+from loguru import logger
 
 
 def is_callable_expression(s: str) -> bool:
@@ -36,3 +46,141 @@ def dict_converter(dictionary: dict) -> str:
     for key, value in dictionary.items():
         result_parts.append(f'"{key}": {value}')
     return "{" + ", ".join(result_parts) + "}"
+
+
+def critical_path(
+    predecessors: Dict[str, List[str]],
+    timings: Dict[str, float],
+) -> Tuple[List[str], float]:
+    """Find the critical path of the executed DAG, i.e. the chain of nodes
+    with the longest total running time, which bounds the running time of
+    the DAG no matter how many workers are used.
+
+    Args:
+        predecessors (`Dict[str, List[str]]`):
+            The predecessors of each node, where the nodes are in
+            topological order.
+        timings (`Dict[str, float]`):
+            The running time of each executed node in seconds.
+
+    Returns:
+        `Tuple[List[str], float]`: The nodes on the critical path and their
+        total running time.
+    """
+    finish: Dict[str, float] = {}
+    previous: Dict[str, Optional[str]] = {}
+    for node_id, preds in predecessors.items():
+        if node_id not in timings:
+            continue
+        prev = max(
+            (_ for _ in preds if _ in finish),
+            key=lambda _: finish[_],
+            default=None,
+        )
+        previous[node_id] = prev
+        finish[node_id] = timings[node_id] + (
+            finish[prev] if prev is not None else 0.0
+        )
+
+    if len(finish) == 0:
+        return [], 0.0
+
+    node_id = max(finish, key=lambda _: finish[_])
+    total = finish[node_id]
+    path = []
+    while node_id is not None:
+        path.append(node_id)
+        node_id = previous[node_id]
+    return path[::-1], total
+
+
+def run_dag(
+    nodes: Dict[str, Callable[..., Any]],
+    predecessors: Dict[str, List[str]],
+    x: Any = None,
+    max_workers: int = 4,
+) -> Tuple[Dict[str, Any], Dict[str, float]]:
+    """Execute the nodes of a DAG concurrently, where a node is executed as
+    soon as all its predecessors finish. A node without predecessors takes
+    `x` as input, and the others take the output of their first
+    predecessor.
+
+    If a node fails, no more nodes are started, and the error is raised
+    after the running nodes finish.
+
+    Args:
+        nodes (`Dict[str, Callable[..., Any]]`):
+            The function of each node, in topological order.
+        predecessors (`Dict[str, List[str]]`):
+            The predecessors of each node.
+        x (`Any`, defaults to `None`):
+            The input of the nodes without predecessors.
+        max_workers (`int`, defaults to `4`):
+            The maximum number of nodes executed at the same time.
+
+    Returns:
+        `Tuple[Dict[str, Any], Dict[str, float]]`: The output and the
+        running time in seconds of each node.
+    """
+    values: Dict[str, Any] = {}
+    timings: Dict[str, float] = {}
+    n_waiting = {
+        node_id: len([_ for _ in predecessors[node_id] if _ in nodes])
+        for node_id in nodes
+    }
+    successors: Dict[str, List[str]] = {node_id: [] for node_id in nodes}
+    for node_id in nodes:
+        for pred in predecessors[node_id]:
+            if pred in nodes:
+                successors[pred].append(node_id)
+
+    def _exec(node_id: str, x_in: Any) -> Any:
+        start = time.perf_counter()
+        try:
+            return nodes[node_id](x_in)
+        finally:
+            timings[node_id] = time.perf_counter() - start
+
+    running: Dict[Future, str] = {}
+    error = None
+    start_time = time.perf_counter()
+    with ThreadPoolExecutor(
+        max_workers=max(1, max_workers),
+        thread_name_prefix="workflow",
+    ) as executor:
+
+        def _submit(node_id: str) -> None:
+            preds = [_ for _ in predecessors[node_id] if _ in nodes]
+            x_in = values[preds[0]] if len(preds) > 0 else x
+            running[executor.submit(_exec, node_id, x_in)] = node_id
+
+        for node_id, count in n_waiting.items():
+            if count == 0:
+                _submit(node_id)
+
+        while len(running) > 0:
+            done, _ = wait(running, return_when=FIRST_COMPLETED)
+            for future in done:
+                node_id = running.pop(future)
+                try:
+                    values[node_id] = future.result()
+                except Exception as e:
+                    logger.error(f"Node [{node_id}] failed: {e}")
+                    error = error or e
+                if error is not None:
+                    continue
+                for succ in successors[node_id]:
+                    n_waiting[succ] -= 1
+                    if n_waiting[succ] == 0:
+                        _submit(succ)
+
+    if error is not None:
+        raise error
+
+    path, path_time = critical_path(predecessors, timings)
+    logger.info(
+        f"Executed {len(timings)} nodes in "
+        f"{time.perf_counter() - start_time:.3f}s, the critical path "
+        f"{' -> '.join(path)} takes {path_time:.3f}s",
+    )
+    return values, timings
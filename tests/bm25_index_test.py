@@ -0,0 +1,90 @@
+# -*- coding: utf-8 -*-
+"""Unit tests for the BM25 index."""
+import shutil
+import tempfile
+import unittest
+
+from agentscope.rag.bm25_index import BM25Index, tokenize
+
+
+class BM25IndexTest(unittest.TestCase):
+    """Test cases for BM25Index."""
+
+    def setUp(self) -> None:
+        """Prepare the chunks."""
+        self.persist_dir = tempfile.mkdtemp()
+        self.ids = ["node0", "node1", "node2", "node3"]
+        self.ref_doc_ids = ["doc0", "doc0", "doc1", "doc2"]
+        self.texts = [
+            "def get_user_name(user): return user.name",
+            "The user name is shown on the profile page.",
+            "class HttpClient: sends requests with retries",
+            "Retries are disabled by default.",
+        ]
+
+    def tearDown(self) -> None:
+        """Remove the persisted files."""
+        shutil.rmtree(self.persist_dir, ignore_errors=True)
+
+    def test_tokenize(self) -> None:
+        """Test the identifiers are indexed as a whole and by parts."""
+        self.assertListEqual(
+            tokenize("get_user_name(HTTPClient)"),
+            [
+                "get_user_name",
+                "get",
+                "user",
+                "name",
+                "httpclient",
+                "http",
+                "client",
+            ],
+        )
+        self.assertListEqual(
+            tokenize("检索 v2"),
+            ["检", "索", "v2", "v", "2"],
+        )
+
+    def test_query(self) -> None:
+        """Test the exact identifier ranks first and misses are dropped."""
+        index = BM25Index(self.persist_dir)
+        index.add(self.ids, self.ref_doc_ids, self.texts)
+        ids, scores = index.query("get_user_name", top_k=3)
+        self.assertListEqual(ids, ["node0", "node1"])
+        self.assertGreater(scores[0], scores[1])
+        self.assertListEqual(index.query("retries", top_k=1)[0], ["node3"])
+        self.assertListEqual(index.query("unknown", top_k=3)[0], [])
+
+        # The normalized scores are in [0, 1], and the chunk matching all
+        # the terms best scores 1
+        ids, normalized = index.query("get_user_name", 3, normalize=True)
+        self.assertListEqual(ids, ["node0", "node1"])
+        self.assertAlmostEqual(normalized[0], 1.0, places=5)
+        self.assertTrue(0 < normalized[1] < 1)
+        self.assertAlmostEqual(
+            normalized[1] / normalized[0],
+            scores[1] / scores[0],
+            places=5,
+        )
+
+    def test_delete_and_persist(self) -> None:
+        """Test the deleted chunks are dropped after reloading."""
+        index = BM25Index(self.persist_dir)
+        index.add(self.ids, self.ref_doc_ids, self.texts)
+        index.persist()
+        self.assertTrue(BM25Index.exists(self.persist_dir))
+
+        index = BM25Index(self.persist_dir)
+        index.delete_ref_doc("doc0")
+        index.add(["node3"], ["doc2"], ["the user name"])
+        self.assertListEqual(index.query("user", top_k=3)[0], ["node3"])
+        index.persist()
+
+        loaded = BM25Index(self.persist_dir)
+        self.assertEqual(len(loaded), 2)
+        self.assertListEqual(loaded.query("user", top_k=3)[0], ["node3"])
+        self.assertListEqual(loaded.query("retries", top_k=3)[0], ["node2"])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,84 @@
+# -*- coding: utf-8 -*-
+"""Unit tests for the embedding batcher."""
+import threading
+import unittest
+from typing import Any, Union, List
+
+from agentscope.models import EmbeddingBatcher, ModelResponse
+from agentscope.models import ModelWrapperBase
+
+
+class DummyEmbeddingModel(ModelWrapperBase):
+    """A dummy embedding model recording the size of each request."""
+
+    max_batch_size: int = 4
+
+    def __init__(self) -> None:
+        super().__init__(config_name="dummy_embedding")
+        self.batch_sizes = []
+        self.lock = threading.Lock()
+
+    def __call__(
+        self,
+        texts: Union[List[str], str],
+        **kwargs: Any,
+    ) -> ModelResponse:
+        if isinstance(texts, str):
+            texts = [texts]
+        with self.lock:
+            self.batch_sizes.append(len(texts))
+        return ModelResponse(embedding=[[float(len(_))] for _ in texts])
+
+    def format(self, *args: Any) -> str:
+        return ""
+
+
+class EmbeddingBatcherTest(unittest.TestCase):
+    """Test cases for EmbeddingBatcher."""
+
+    def test_split_by_max_batch_size(self) -> None:
+        """Test a large request is split by the provider limit."""
+        model = DummyEmbeddingModel()
+        batcher = EmbeddingBatcher(model, max_wait=0.05)
+
+        texts = ["a" * i for i in range(1, 11)]
+        embeddings = batcher(texts).embedding
+
+        self.assertListEqual(embeddings, [[float(i)] for i in range(1, 11)])
+        self.assertTrue(all(_ <= 4 for _ in model.batch_sizes))
+        self.assertEqual(sum(model.batch_sizes), 10)
+        batcher.close()
+
+    def test_coalesce_concurrent_requests(self) -> None:
+        """Test the requests from different threads are coalesced."""
+        model = DummyEmbeddingModel()
+        batcher = EmbeddingBatcher(model, max_batch_size=100, max_wait=0.2)
+
+        results = {}
+
+        def embed(i: int) -> None:
+            results[i] = batcher("b" * i).embedding
+
+        threads = [
+            threading.Thread(target=embed, args=(i,)) for i in range(1, 9)
+        ]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        for i in range(1, 9):
+            self.assertListEqual(results[i], [[float(i)]])
+        self.assertLess(len(model.batch_sizes), 8)
+        batcher.close()
+
+    def test_shared_batcher(self) -> None:
+        """Test the batcher is shared by config name."""
+        batcher1 = EmbeddingBatcher.get_batcher(DummyEmbeddingModel())
+        batcher2 = EmbeddingBatcher.get_batcher(DummyEmbeddingModel())
+        self.assertIs(batcher1, batcher2)
+        self.assertIs(EmbeddingBatcher.get_batcher(batcher1), batcher1)
+
+
+if __name__ == "__main__":
+    unittest.main()
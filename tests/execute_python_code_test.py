@@ -3,7 +3,8 @@
 import unittest
 import sys
 
-from agentscope.service import execute_python_code
+from agentscope.service import configure_sandbox_pool, execute_python_code
+from agentscope.service import ServiceExecStatus
 
 
 class ExecutePythonCodeTest(unittest.TestCase):
@@ -85,6 +86,50 @@ class ExecutePythonCodeTest(unittest.TestCase):
         """Execute no input code test."""
         self.run_test(self.arg4, "", "")
 
+    def test_sandbox_pool(self) -> None:
+        """Test reusing and recycling the sandbox processes."""
+
+        def run(code: str) -> str:
+            return execute_python_code(code, timeout=5, use_docker=False)
+
+        # A fresh process for each execution by default
+        configure_sandbox_pool(pool_size=1)
+        self.addCleanup(configure_sandbox_pool)
+        pid = run("import os\nprint(os.getpid())").content
+        self.assertNotEqual(run("import os\nprint(os.getpid())").content, pid)
+
+        configure_sandbox_pool(pool_size=1, max_runs=3)
+
+        # The globals don't leak between the executions in the same process
+        pid = run("import os\nx = 1\nprint(os.getpid())").content
+        self.assertEqual(run("import os\nprint(os.getpid())").content, pid)
+        self.assertIn("NameError", run("print(x)").content)
+
+        # Recycled after a failed execution
+        self.assertNotEqual(run("import os\nprint(os.getpid())").content, pid)
+
+        # Recycled after max_runs
+        pids = [run("import os\nprint(os.getpid())").content for _ in "abc"]
+        self.assertEqual(len(set(pids)), 2)
+
+        # Recycled after changing the state of the process
+        configure_sandbox_pool(pool_size=1, max_runs=10)
+        for code in [
+            "import sys\nsys.modules['sandbox_test'] = sys",
+            "import sys\nsys.path.append('/tmp')",
+            "import sys\nsys.setrecursionlimit(100)",
+        ]:
+            pid = run("import os\nprint(os.getpid())").content
+            self.assertEqual(run(code).status, ServiceExecStatus.SUCCESS)
+            self.assertNotEqual(
+                run("import os\nprint(os.getpid())").content,
+                pid,
+            )
+
+        # Disable the pool
+        configure_sandbox_pool(pool_size=0)
+        self.run_test(self.arg0, "Hello World\n", "")
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,66 @@
+# -*- coding: utf-8 -*-
+""" Unit test for the shared http session."""
+import email
+import os
+import unittest
+import urllib.request
+from unittest.mock import MagicMock, patch
+
+import requests
+
+from agentscope.utils.http_session import (
+    configure_http_session,
+    get_http_session,
+)
+
+
+class HttpSessionTest(unittest.TestCase):
+    """Http session test."""
+
+    def tearDown(self) -> None:
+        configure_http_session()
+
+    def test_shared_session(self) -> None:
+        """Test the session is shared within a process, and created again
+        after fork."""
+        session = get_http_session()
+        self.assertIs(get_http_session(), session)
+
+        with patch("os.getpid", return_value=os.getpid() + 1):
+            forked_session = get_http_session()
+        self.assertIsNot(forked_session, session)
+
+    def test_configure_http_session(self) -> None:
+        """Test the session is replaced with the new configuration."""
+        session = get_http_session()
+        configure_http_session(
+            pool_maxsize=3,
+            max_retries=2,
+            headers={"X-Test": "test"},
+        )
+        new_session = get_http_session()
+        self.assertIsNot(new_session, session)
+        self.assertEqual(new_session.headers["X-Test"], "test")
+        adapter = new_session.get_adapter("https://example.com")
+        self.assertEqual(adapter.max_retries.total, 2)
+        self.assertEqual(
+            adapter._pool_maxsize,  # pylint: disable=protected-access
+            3,
+        )
+
+    def test_no_cookies(self) -> None:
+        """Test the cookies set by a server are not kept by the shared
+        session."""
+        request = urllib.request.Request("http://example.com/")
+        response = MagicMock()
+        response.info.return_value = email.message_from_string(
+            "Set-Cookie: token=secret\n\n",
+        )
+
+        jar = requests.Session().cookies
+        jar.extract_cookies(response, request)
+        self.assertEqual(len(jar), 1)
+
+        jar = get_http_session().cookies
+        jar.extract_cookies(response, request)
+        self.assertEqual(len(jar), 0)
@@ -8,7 +8,7 @@ import unittest
 from typing import Any
 import shutil
 
-from agentscope.rag import LlamaIndexKnowledge
+from agentscope.rag import LlamaIndexKnowledge, Reranker
 from agentscope.models import OpenAIEmbeddingWrapper, ModelResponse
 
 
@@ -20,9 +20,25 @@ class DummyModel(OpenAIEmbeddingWrapper):
     def __init__(self) -> None:
         """dummy init"""
 
-    def __call__(self, *args: Any, **kwargs: Any) -> ModelResponse:
+    def __call__(self, texts: Any, **kwargs: Any) -> ModelResponse:
         """dummy call"""
-        return ModelResponse(embedding=[[1.0, 2.0]])
+        n_texts = 1 if isinstance(texts, str) else len(texts)
+        return ModelResponse(embedding=[[1.0, 2.0]] * n_texts)
+
+
+class CountingDummyModel(DummyModel):
+    """
+    Dummy model wrapper counting the embedded texts
+    """
+
+    def __init__(self) -> None:
+        """dummy init"""
+        self.n_texts = 0
+
+    def __call__(self, texts: Any, **kwargs: Any) -> ModelResponse:
+        """dummy call"""
+        self.n_texts += 1 if isinstance(texts, str) else len(texts)
+        return super().__call__(texts, **kwargs)
 
 
 class KnowledgeTest(unittest.TestCase):
@@ -87,6 +103,204 @@ class KnowledgeTest(unittest.TestCase):
             retrieved,
             [self.content],
         )
+        # the retriever is cached, and the query embedding can be shared
+        # pylint: disable=protected-access
+        self.assertIs(knowledge._get_retriever(2), knowledge._get_retriever(2))
+        retrieved = knowledge.retrieve(
+            query="testing",
+            similarity_top_k=2,
+            to_list_strs=True,
+            query_embedding=knowledge.embed_query("testing"),
+        )
+        self.assertEqual(retrieved, [self.content])
+
+    def test_refresh_index(self) -> None:
+        """test refreshing the index incrementally"""
+        dummy_model = CountingDummyModel()
+        file_name_2 = "tmp_data_dir/file2.txt"
+        with open(file_name_2, "w", encoding="utf-8") as f:
+            f.write("another file")
+
+        knowledge_config = {
+            "knowledge_id": "",
+            "data_processing": [
+                {
+                    "load_data": {
+                        "loader": {
+                            "create_object": True,
+                            "module": "llama_index.core",
+                            "class": "SimpleDirectoryReader",
+                            "init_args": {
+                                "input_dir": self.data_dir,
+                                "required_exts": ".txt",
+                            },
+                        },
+                    },
+                },
+            ],
+        }
+        knowledge = LlamaIndexKnowledge(
+            knowledge_id="test_refresh_knowledge",
+            emb_model=dummy_model,
+            knowledge_config=knowledge_config,
+            overwrite_index=True,
+        )
+        self.assertEqual(dummy_model.n_texts, 2)
+
+        # the unchanged documents are not embedded again
+        knowledge.refresh_index()
+        self.assertEqual(dummy_model.n_texts, 2)
+
+        # only the changed chunk is embedded again
+        with open(file_name_2, "w", encoding="utf-8") as f:
+            f.write("another file changed")
+        knowledge.refresh_index()
+        self.assertEqual(dummy_model.n_texts, 3)
+
+        # the deleted documents are removed from the index
+        os.remove(self.file_name_1)
+        knowledge.refresh_index()
+        self.assertEqual(dummy_model.n_texts, 3)
+        retrieved = knowledge.retrieve(
+            query="testing",
+            similarity_top_k=2,
+            to_list_strs=True,
+        )
+        self.assertEqual(retrieved, ["another file changed"])
+
+    def test_mmap_vector_store(self) -> None:
+        """test llamaindexknowledge with the mmap vector store"""
+        knowledge_config = {
+            "knowledge_id": "",
+            "vector_store": {"type": "mmap", "dtype": "float16"},
+            "data_processing": [
+                {
+                    "load_data": {
+                        "loader": {
+                            "create_object": True,
+                            "module": "llama_index.core",
+                            "class": "SimpleDirectoryReader",
+                            "init_args": {
+                                "input_dir": self.data_dir,
+                                "required_exts": ".txt",
+                            },
+                        },
+                    },
+                },
+            ],
+        }
+        for _ in range(2):
+            # build the index, then load the persisted index
+            knowledge = LlamaIndexKnowledge(
+                knowledge_id="test_mmap_knowledge",
+                emb_model=DummyModel(),
+                knowledge_config=knowledge_config,
+            )
+            retrieved = knowledge.retrieve(
+                query="testing",
+                similarity_top_k=2,
+                to_list_strs=True,
+            )
+            self.assertEqual(retrieved, [self.content])
+
+    def test_bm25_retrieval(self) -> None:
+        """test the sparse and hybrid retrieval by the bm25 index"""
+        with open(
+            os.path.join(self.data_dir, "file2.txt"),
+            "w",
+            encoding="utf-8",
+        ) as f:
+            f.write("def get_user_name(): pass")
+        dummy_model = CountingDummyModel()
+        knowledge_config = {
+            "knowledge_id": "",
+            "bm25": {"mode": "sparse"},
+            "data_processing": [
+                {
+                    "load_data": {
+                        "loader": {
+                            "create_object": True,
+                            "module": "llama_index.core",
+                            "class": "SimpleDirectoryReader",
+                            "init_args": {
+                                "input_dir": self.data_dir,
+                                "required_exts": ".txt",
+                            },
+                        },
+                    },
+                },
+            ],
+        }
+        knowledge = LlamaIndexKnowledge(
+            knowledge_id="test_bm25_knowledge",
+            emb_model=dummy_model,
+            knowledge_config=knowledge_config,
+        )
+        n_texts = dummy_model.n_texts
+        # the sparse retrieval doesn't embed the query
+        self.assertIsNone(knowledge.query_embedding_key)
+        retrieved = knowledge.retrieve(
+            query="user name",
+            similarity_top_k=2,
+            to_list_strs=True,
+        )
+        self.assertEqual(retrieved, ["def get_user_name(): pass"])
+        self.assertEqual(dummy_model.n_texts, n_texts)
+
+        retrieved = knowledge.retrieve(
+            query="testing",
+            similarity_top_k=2,
+            to_list_strs=True,
+            mode="hybrid",
+        )
+        self.assertEqual(retrieved[0], self.content)
+        self.assertEqual(len(retrieved), 2)
+        self.assertEqual(dummy_model.n_texts, n_texts + 1)
+
+    def test_rerank(self) -> None:
+        """test the retrieved candidates are reranked"""
+        with open(
+            os.path.join(self.data_dir, "file2.txt"),
+            "w",
+            encoding="utf-8",
+        ) as f:
+            f.write("another document")
+        knowledge_config = {
+            "knowledge_id": "",
+            "data_processing": [
+                {
+                    "load_data": {
+                        "loader": {
+                            "create_object": True,
+                            "module": "llama_index.core",
+                            "class": "SimpleDirectoryReader",
+                            "init_args": {
+                                "input_dir": self.data_dir,
+                                "required_exts": ".txt",
+                            },
+                        },
+                    },
+                },
+            ],
+        }
+        knowledge = LlamaIndexKnowledge(
+            knowledge_id="test_rerank_knowledge",
+            emb_model=DummyModel(),
+            knowledge_config=knowledge_config,
+        )
+        reranker = Reranker(
+            lambda query, texts: [float(query in _) for _ in texts],
+        )
+        for query in ["another", "testing"]:
+            # the dummy embeddings can't tell the files apart
+            retrieved = knowledge.retrieve(
+                query=query,
+                similarity_top_k=1,
+                to_list_strs=True,
+                reranker=reranker,
+            )
+            self.assertEqual(len(retrieved), 1)
+            self.assertIn(query, retrieved[0])
 
 
 if __name__ == "__main__":
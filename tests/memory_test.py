@@ -5,10 +5,39 @@ Unit tests for memory classes and functions
 
 import os
 import unittest
+from typing import Any
 from unittest.mock import patch, MagicMock
 
 from agentscope.message import Msg
-from agentscope.memory import TemporaryMemory
+from agentscope.memory import TemporaryMemory, PromptBudget
+from agentscope.models import (
+    ModelResponse,
+    ModelWrapperBase,
+    clear_model_configs,
+    load_model_by_config_name,
+    read_model_configs,
+)
+
+
+class _KeywordEmbeddingWrapper(ModelWrapperBase):  # pylint: disable=W0223
+    """An embedding model counting the keywords, which records the texts
+    it embeds."""
+
+    model_type: str = "keyword_embedding_for_test"
+
+    max_batch_size: int = 16
+
+    def __init__(self, config_name: str, **kwargs: Any) -> None:
+        super().__init__(config_name=config_name, **kwargs)
+        self.embedded: list = []
+
+    def __call__(self, texts: list, **kwargs: Any) -> ModelResponse:
+        self.embedded.extend(texts)
+        return ModelResponse(
+            embedding=[
+                [_.count("apple") + 0.1, _.count("hello") + 0.1] for _ in texts
+            ],
+        )
 
 
 class TemporaryMemoryTest(unittest.TestCase):
@@ -113,5 +142,111 @@ class TemporaryMemoryTest(unittest.TestCase):
         )
 
 
+class PromptBudgetTest(unittest.TestCase):
+    """
+    Test cases for PromptBudget
+    """
+
+    def setUp(self) -> None:
+        self.sys_msg = Msg("system", "You're a helpful assistant.", "system")
+        self.msgs = [
+            Msg("user", f"Message {i}: " + "hello " * 10, role="user")
+            for i in range(10)
+        ]
+
+    def test_recency(self) -> None:
+        """Test keeping the most recent messages within the budget."""
+        budget = PromptBudget(max_tokens=10**6)
+        self.assertListEqual(
+            budget.select([self.sys_msg] + self.msgs),
+            [self.sys_msg] + self.msgs,
+        )
+
+        budget.max_tokens = budget.count([self.sys_msg] + self.msgs[-3:])
+        self.assertListEqual(
+            budget.select([self.sys_msg] + self.msgs),
+            [self.sys_msg] + self.msgs[-3:],
+        )
+
+        # The reserved tokens are deducted from the budget
+        budget.max_tokens = budget.count(self.msgs[-3:])
+        self.assertListEqual(
+            budget.select(self.msgs, reserved=[self.msgs[0]]),
+            self.msgs[-2:],
+        )
+
+    def test_summarize(self) -> None:
+        """Test the dropped messages are summarized incrementally."""
+        model = MagicMock()
+        model.model_name = None
+        model.return_value = ModelResponse(text="summary")
+
+        budget = PromptBudget(
+            max_tokens=0,
+            model=model,
+            strategy="summarize",
+            max_summary_tokens=0,
+        )
+        budget.max_tokens = budget.count(self.msgs[-2:])
+
+        selected = budget.select(self.msgs[:5])
+        self.assertEqual(len(selected), 3)
+        self.assertIn("summary", selected[0].content)
+        self.assertListEqual(selected[1:], self.msgs[3:5])
+        self.assertEqual(model.call_count, 1)
+
+        # Only the newly dropped messages are summarized
+        budget.select(self.msgs)
+        self.assertEqual(model.call_count, 2)
+        history = model.format.call_args[0][1].content
+        self.assertIn("Summary: summary", history)
+        self.assertNotIn("Message 0", history)
+        self.assertIn("Message 7", history)
+
+    def test_retrieval_from_config(self) -> None:
+        """Test building the retrieval strategy from the model config, and
+        caching the embeddings without modifying the messages."""
+        read_model_configs(
+            configs=[
+                {
+                    "config_name": "prompt_budget_chat",
+                    "model_type": "post_api_chat",
+                    "api_url": "http://localhost",
+                    "prompt_budget": {
+                        "max_tokens": 0,
+                        "strategy": "retrieval",
+                        "embedding_model_config_name": "prompt_budget_emb",
+                    },
+                },
+                {
+                    "config_name": "prompt_budget_emb",
+                    "model_type": "keyword_embedding_for_test",
+                },
+            ],
+            clear_existing=True,
+        )
+        self.addCleanup(clear_model_configs)
+
+        budget = PromptBudget.from_model(
+            load_model_by_config_name("prompt_budget_chat"),
+        )
+        self.assertEqual(budget.strategy, "retrieval")
+        embedding_model = budget.embedding_model.model
+        self.assertIsInstance(embedding_model, _KeywordEmbeddingWrapper)
+
+        msgs = self.msgs[:5]
+        msgs[1] = Msg("user", "I like apple " * 10, role="user")
+        msgs[-1] = Msg("user", "apple?", role="user")
+        budget.max_tokens = budget.count([msgs[1], msgs[-1]])
+        self.assertListEqual(budget.select(msgs), [msgs[1], msgs[-1]])
+        self.assertTrue(all(_.get("embedding") is None for _ in msgs))
+        self.assertEqual(len(embedding_model.embedded), 5)
+
+        # Only the new messages are embedded
+        msgs.append(Msg("user", "apple!", role="user"))
+        budget.select(msgs)
+        self.assertListEqual(embedding_model.embedded[5:], ["apple!"])
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,130 @@
+# -*- coding: utf-8 -*-
+"""Unit tests for the memory-mapped embedding store."""
+import os
+import shutil
+import tempfile
+import unittest
+from unittest.mock import patch
+
+import numpy as np
+
+from agentscope.rag.mmap_vector_store import MmapEmbeddingStore
+
+
+class MmapEmbeddingStoreTest(unittest.TestCase):
+    """Test cases for MmapEmbeddingStore."""
+
+    def setUp(self) -> None:
+        """Generate the embeddings."""
+        self.persist_dir = tempfile.mkdtemp()
+        rng = np.random.default_rng(0)
+        self.embeddings = rng.normal(size=(500, 16)).astype(np.float32)
+        self.ids = [f"node{i}" for i in range(500)]
+        self.ref_doc_ids = [f"doc{i // 10}" for i in range(500)]
+
+    def tearDown(self) -> None:
+        """Remove the persisted files."""
+        shutil.rmtree(self.persist_dir, ignore_errors=True)
+
+    def _exact_top_k(self, query: np.ndarray, top_k: int) -> list:
+        """The ids of the top k embeddings by cosine similarity."""
+        norms = np.linalg.norm(self.embeddings, axis=1)
+        scores = self.embeddings @ query / norms
+        return [self.ids[_] for _ in np.argsort(-scores)[:top_k]]
+
+    def test_query_before_and_after_persist(self) -> None:
+        """Test the queries are exact before and after persisting."""
+        store = MmapEmbeddingStore(self.persist_dir)
+        store.add(self.ids, self.ref_doc_ids, self.embeddings)
+        query = self.embeddings[42] + 0.1
+        expected = self._exact_top_k(query, 5)
+        self.assertListEqual(store.query(query, 5)[0], expected)
+
+        store.persist()
+        self.assertTrue(MmapEmbeddingStore.exists(self.persist_dir))
+        loaded = MmapEmbeddingStore(self.persist_dir)
+        ids, similarities = loaded.query(query, 5)
+        self.assertListEqual(ids, expected)
+        self.assertEqual(len(loaded), 500)
+        self.assertTrue(similarities[0] >= similarities[-1])
+        np.testing.assert_allclose(
+            loaded.get("node42"),
+            self.embeddings[42],
+            rtol=1e-6,
+        )
+
+    def test_delete_and_add(self) -> None:
+        """Test deleting the documents and replacing the embeddings."""
+        store = MmapEmbeddingStore(self.persist_dir)
+        store.add(self.ids, self.ref_doc_ids, self.embeddings)
+        store.persist()
+
+        store = MmapEmbeddingStore(self.persist_dir)
+        store.delete_ref_doc("doc4")
+        store.add(["node0"], ["doc0"], [self.embeddings[42]])
+        # node42 of doc4 is deleted, and node0 is replaced by its embedding
+        ids = store.query(self.embeddings[42], 10)[0]
+        self.assertEqual(ids[0], "node0")
+        self.assertNotIn("node42", ids)
+
+        store.persist()
+        loaded = MmapEmbeddingStore(self.persist_dir)
+        self.assertEqual(len(loaded), 490)
+        ids = loaded.query(self.embeddings[42], 10)[0]
+        self.assertEqual(ids[0], "node0")
+        self.assertNotIn("node42", ids)
+        self.assertListEqual(
+            loaded.query(self.embeddings[42], 3, node_ids=["node1"])[0],
+            ["node1"],
+        )
+
+    def test_float16_with_ivf(self) -> None:
+        """Test the float16 embeddings with the IVF index."""
+        store = MmapEmbeddingStore(
+            self.persist_dir,
+            dtype="float16",
+            nlist=8,
+            nprobe=8,
+        )
+        store.add(self.ids, self.ref_doc_ids, self.embeddings)
+        store.persist()
+
+        # probing all the clusters gives the exact result
+        loaded = MmapEmbeddingStore(self.persist_dir, nlist=8, nprobe=8)
+        query = self.embeddings[7]
+        self.assertListEqual(
+            loaded.query(query, 3)[0],
+            self._exact_top_k(query, 3),
+        )
+        self.assertEqual(loaded.dtype, np.float16)
+
+    def test_interrupted_persist(self) -> None:
+        """Test an interrupted persist leaves the previous version intact,
+        and the files of the old versions are removed."""
+        store = MmapEmbeddingStore(self.persist_dir)
+        store.add(
+            self.ids[:100], self.ref_doc_ids[:100], self.embeddings[:100]
+        )
+        store.persist()
+        files = sorted(os.listdir(self.persist_dir))
+
+        store.add(
+            self.ids[100:], self.ref_doc_ids[100:], self.embeddings[100:]
+        )
+        with patch("os.replace", side_effect=OSError("disk full")):
+            with self.assertRaises(OSError):
+                store.persist()
+        self.assertEqual(len(MmapEmbeddingStore(self.persist_dir)), 100)
+
+        store.persist()
+        self.assertEqual(len(MmapEmbeddingStore(self.persist_dir)), 500)
+        new_files = sorted(os.listdir(self.persist_dir))
+        self.assertEqual(len(new_files), len(files))
+        self.assertListEqual(
+            sorted(set(files) & set(new_files)),
+            ["mmap_ids.json"],
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
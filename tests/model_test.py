@@ -8,6 +8,7 @@ import unittest
 from unittest.mock import patch, MagicMock
 
 from agentscope.message import Msg
+from agentscope.parsers import MarkdownJsonDictParser
 from agentscope.models import (
     ModelResponse,
     ModelWrapperBase,
@@ -33,6 +34,38 @@ class TestModelWrapperSimple(ModelWrapperBase):
         return ""
 
 
+class TestModelWrapperTruncated(ModelWrapperBase):
+    """A model wrapper class whose first response is truncated"""
+
+    def __init__(self, config_name: str, **kwargs: Any) -> None:
+        super().__init__(config_name=config_name, **kwargs)
+        self.calls = []
+
+    def __call__(self, messages: list, **kwargs: Any) -> ModelResponse:
+        self.calls.append(messages)
+        if len(self.calls) == 1:
+            return ModelResponse(text='```json\n{"speak": "Hello, wor')
+        return ModelResponse(text='ld!", "end": true}\n```')
+
+    def format(
+        self,
+        *args: Union[Msg, Sequence[Msg]],
+    ) -> Union[List[dict], str]:
+        return ""
+
+
+class TestModelWrapperFailedContinuation(TestModelWrapperTruncated):
+    """A model wrapper class whose continuation request fails"""
+
+    def __call__(self, messages: list, **kwargs: Any) -> ModelResponse:
+        self.calls.append(messages)
+        if len(self.calls) == 1:
+            return ModelResponse(text='```json\n{"speak": "Hello, wor')
+        if len(self.calls) == 2:
+            raise RuntimeError("The context is too long")
+        return ModelResponse(text='```json\n{"speak": "Hi", "end": true}```')
+
+
 class BasicModelTest(unittest.TestCase):
     """Test cases for basic model wrappers"""
 
@@ -114,3 +147,37 @@ class BasicModelTest(unittest.TestCase):
             load_model_by_config_name,
             "test_model_wrapper",
         )
+
+    def test_continue_truncated_response(self) -> None:
+        """Test the truncated response is continued rather than
+        regenerated."""
+        model = TestModelWrapperTruncated(config_name="truncated")
+        parser = MarkdownJsonDictParser(required_keys=["speak", "end"])
+
+        messages = [{"role": "user", "content": "Hi"}]
+        res = model(messages, parse_func=parser.parse, max_retries=1)
+
+        self.assertDictEqual(
+            res.parsed, {"speak": "Hello, world!", "end": True}
+        )
+        self.assertEqual(len(model.calls), 2)
+        # Only the tail is requested, with the truncated response as context
+        self.assertEqual(model.calls[1][:1], messages)
+        self.assertEqual(
+            model.calls[1][1]["content"],
+            '```json\n{"speak": "Hello, wor',
+        )
+
+    @patch("time.sleep")
+    def test_failed_continuation(self, _: MagicMock) -> None:
+        """Test the response is regenerated if the continuation request
+        fails."""
+        model = TestModelWrapperFailedContinuation(config_name="failed")
+        parser = MarkdownJsonDictParser(required_keys=["speak", "end"])
+
+        messages = [{"role": "user", "content": "Hi"}]
+        res = model(messages, parse_func=parser.parse, max_retries=2)
+
+        self.assertDictEqual(res.parsed, {"speak": "Hi", "end": True})
+        self.assertEqual(len(model.calls), 3)
+        self.assertEqual(model.calls[2], messages)
@@ -1,5 +1,7 @@
 # -*- coding: utf-8 -*-
 """ Unit test for msghub."""
+import threading
+import time
 import unittest
 from typing import Optional, Union, Sequence
 
@@ -20,6 +22,55 @@ class TestAgent(AgentBase):
             return {}
 
 
+class SlowObserveAgent(TestAgent):
+    """Test agent that observes slowly, and records the batched
+    observations."""
+
+    batches: list = []
+
+    def observe(self, x: Union[dict, Sequence[dict]]) -> None:
+        """Observe the input slowly."""
+        time.sleep(0.1)
+        super().observe(x)
+
+    @classmethod
+    def observe_all(
+        cls,
+        agents: Sequence[AgentBase],
+        x: Union[dict, Sequence[dict]],
+    ) -> None:
+        """Record the agents observing together."""
+        cls.batches.append([_.name for _ in agents])
+        super().observe_all(agents, x)
+
+
+class SlowLocalAgent(TestAgent):
+    """Test agent that observes slowly with the default `observe_all`, and
+    records the observing thread."""
+
+    thread: Optional[int] = None
+
+    def observe(self, x: Union[dict, Sequence[dict]]) -> None:
+        """Observe the input slowly."""
+        self.thread = threading.get_ident()
+        time.sleep(0.2)
+        super().observe(x)
+
+
+class ConcurrentLocalAgent(SlowLocalAgent):
+    """Test agent that opts in to observe concurrently."""
+
+    concurrent_observe = True
+
+
+class FailingObserveAgent(TestAgent):
+    """Test agent that fails to observe."""
+
+    def observe(self, x: Union[dict, Sequence[dict]]) -> None:
+        """Fail to observe the input."""
+        raise RuntimeError(f"{self.name} fails to observe")
+
+
 class MsgHubTest(unittest.TestCase):
     """
     Test for MsgHub
@@ -97,6 +148,79 @@ class MsgHubTest(unittest.TestCase):
             [],
         )
 
+    def test_broadcast_groups(self) -> None:
+        """Test the agents observe the broadcast in groups."""
+        SlowObserveAgent.batches = []
+        slow1 = SlowObserveAgent("slow1")
+        slow2 = SlowObserveAgent("slow2")
+        msg = Msg(name="host", content="hello")
+
+        with msghub(participants=[self.agent1, slow1, slow2]) as hub:
+            hub.broadcast(msg)
+
+        self.assertListEqual(SlowObserveAgent.batches, [["slow1", "slow2"]])
+        for agent in [self.agent1, slow1, slow2]:
+            self.assertListEqual(agent.memory.get_memory(), [msg])
+
+    def test_broadcast_local_agents(self) -> None:
+        """Test the local agents observe the broadcast one by one in the
+        calling thread, unless they opt in to observe concurrently."""
+        agents = [SlowLocalAgent(f"local{i}") for i in range(2)]
+        msg = Msg(name="host", content="hello")
+
+        AgentBase.broadcast(agents, msg)
+        for agent in agents:
+            self.assertEqual(agent.thread, threading.get_ident())
+            self.assertListEqual(agent.memory.get_memory(), [msg])
+
+        agents = [ConcurrentLocalAgent(f"concurrent{i}") for i in range(4)]
+        start = time.time()
+        AgentBase.broadcast(agents, msg)
+        self.assertLess(time.time() - start, 0.6)
+        for agent in agents:
+            self.assertNotEqual(agent.thread, threading.get_ident())
+            self.assertListEqual(agent.memory.get_memory(), [msg])
+
+    def test_close_inboxes_on_error(self) -> None:
+        """Test all the inboxes are closed when one of them fails."""
+        failing = FailingObserveAgent("failing")
+        slow = SlowObserveAgent("slow")
+        msg = Msg(name="host", content="hello")
+
+        with self.assertRaisesRegex(RuntimeError, "failing fails"):
+            with msghub(
+                participants=[failing, slow],
+                async_observe=True,
+            ) as hub:
+                hub.broadcast(msg)
+
+        for agent in [failing, slow]:
+            self.assertIsNone(agent._inbox)  # pylint: disable=W0212
+            self.assertIsNone(agent._audience)  # pylint: disable=W0212
+        self.assertListEqual(slow.memory.get_memory(), [msg])
+
+    def test_async_observe(self) -> None:
+        """Test the broadcast messages are observed asynchronously, and
+        before the agent replies."""
+        slow1 = SlowObserveAgent("slow1")
+        slow2 = SlowObserveAgent("slow2")
+        msgs = [Msg(name="host", content=f"msg{i}") for i in range(3)]
+        reply = Msg(name="user", content="reply")
+
+        with msghub(
+            participants=[slow1, slow2],
+            async_observe=True,
+        ) as hub:
+            start = time.time()
+            for msg in msgs:
+                hub.broadcast(msg)
+            self.assertLess(time.time() - start, 0.2)
+
+            slow1(reply)
+            self.assertListEqual(slow1.memory.get_memory(), msgs + [reply])
+
+        self.assertListEqual(slow2.memory.get_memory(), msgs + [reply])
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -4,6 +4,11 @@ import unittest
 
 from pydantic import BaseModel, Field
 
+from agentscope.exception import (
+    JsonParsingError,
+    JsonTypeError,
+    TagNotFoundError,
+)
 from agentscope.models import ModelResponse
 from agentscope.parsers import (
     MarkdownJsonDictParser,
@@ -271,6 +276,121 @@ class ModelResponseParserTest(unittest.TestCase):
             self.gt_to_metadata,
         )
 
+    def test_multitaggedcontentparser_missing_end_tag(self) -> None:
+        """Test the fields after a begin tag without end tag are found"""
+        parser = MultiTaggedContentParser(
+            TaggedContent("a", "<a>", "", "</a>"),
+            TaggedContent("b", "<b>", "", "</b>"),
+            keys_allow_missing=["a"],
+        )
+        res = parser.parse(ModelResponse(text="<a>x <b>y</b>"))
+        self.assertDictEqual(res.parsed, {"b": "y"})
+
+        # The field without end tag is still reported if required
+        parser.keys_allow_missing = ["b"]
+        with self.assertRaises(TagNotFoundError) as cm:
+            parser.parse(ModelResponse(text="<a>x <b>y</b>"))
+        self.assertTrue(cm.exception.missing_end_tag)
+        self.assertFalse(cm.exception.missing_begin_tag)
+
+    def test_multitaggedcontentparser_stream(self) -> None:
+        """Test the incremental parsing of MultiTaggedContentParser"""
+        parser = MultiTaggedContentParser(
+            TaggedContent("speak", "[SPEAK]", "", "[/SPEAK]"),
+            TaggedContent("thought", "[THOUGHT]", "", "[/THOUGHT]"),
+            TaggedContent(
+                "end_discussion",
+                "[END_DISCUSSION]",
+                "",
+                "[/END_DISCUSSION]",
+                parse_json=True,
+            ),
+        )
+
+        # Feed the response in small pieces, splitting the tags
+        stream = parser.stream()
+        text = self.res_dict_2.text
+        completed = {}
+        for i in range(0, len(text), 3):
+            for name, value in stream.feed(text[i : i + 3]).items():
+                completed[name] = value
+                if name == "speak":
+                    self.assertNotIn("thought", completed)
+
+        self.assertDictEqual(completed, self.gt_dict)
+        res = stream.close()
+        self.assertDictEqual(res.parsed, self.gt_dict)
+        self.assertEqual(res.text, text)
+
+        # The malformed JSON content is reported before the response ends
+        stream = parser.stream()
+        with self.assertRaises(JsonParsingError):
+            stream.feed("[END_DISCUSSION]yes[/END_DISCUSSION][SPEAK]")
+
+        # The missing tags are reported when the stream is closed
+        stream = parser.stream()
+        stream.feed("[SPEAK]Hi[/SPEAK][THOUGHT]xxx")
+        with self.assertRaises(TagNotFoundError) as cm:
+            stream.close()
+        self.assertFalse(cm.exception.missing_begin_tag)
+        self.assertTrue(cm.exception.missing_end_tag)
+
+    def test_markdownjsondictparser_stream(self) -> None:
+        """Test the incremental parsing of MarkdownJsonDictParser"""
+        parser = MarkdownJsonDictParser(required_keys=["speak"])
+
+        stream = parser.stream()
+        text = self.res_dict_1.text
+        completed = []
+        for i in range(0, len(text), 4):
+            completed.extend(stream.feed(text[i : i + 4]).keys())
+
+        self.assertListEqual(completed, ["speak", "thought", "end_discussion"])
+        self.assertDictEqual(stream.close().parsed, self.gt_dict)
+
+        # Not a JSON dictionary
+        stream = parser.stream()
+        with self.assertRaises(JsonTypeError):
+            stream.feed("```json\n[1, 2")
+
+        # A malformed field is reported once it's complete
+        stream = parser.stream()
+        stream.feed('```json\n{"speak": "a, b", "thought": ')
+        with self.assertRaises(JsonParsingError):
+            stream.feed('xxx, "end_discussion": true')
+
+    def test_markdownjsondictparser_repair(self) -> None:
+        """Test the small defects in the JSON object are repaired"""
+        parser = MarkdownJsonDictParser()
+
+        res = parser.parse(
+            ModelResponse(
+                text='```json\n{"speak": "He said "hi"", "n": [1, 2,],}\n```',
+            ),
+        )
+        self.assertDictEqual(
+            res.parsed, {"speak": 'He said "hi"', "n": [1, 2]}
+        )
+
+        # The truncated string cannot be repaired
+        with self.assertRaises(JsonParsingError) as cm:
+            parser.parse(ModelResponse(text='```json\n{"speak": "He sa'))
+        self.assertTrue(cm.exception.truncated)
+
+        # The unclosed brackets are reported as truncated rather than
+        # closed, since the following items may be lost
+        with self.assertRaises(JsonParsingError) as cm:
+            parser.parse(
+                ModelResponse(text='```json\n{"speak": "Hi", "n": [1, 2,'),
+            )
+        self.assertTrue(cm.exception.truncated)
+
+        # Within a closed code block, the missing brackets are closed
+        res = parser.parse(
+            ModelResponse(text='```json\n{"speak": "Hi", "n": [1, 2\n```'),
+        )
+        self.assertDictEqual(res.parsed, {"speak": "Hi", "n": [1, 2]})
+
     def test_DictFilterMixin_default_value(self) -> None:
         """Test the default value of the DictFilterMixin class"""
         mixin = DictFilterMixin(
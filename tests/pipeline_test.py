@@ -5,6 +5,7 @@ Unit tests for pipeline classes and functions
 
 import unittest
 import random
+import time
 
 from agentscope.pipelines import (
     SequentialPipeline,
@@ -12,8 +13,10 @@ from agentscope.pipelines import (
     SwitchPipeline,
     ForLoopPipeline,
     WhileLoopPipeline,
+    ParallelPipeline,
     sequentialpipeline,
     ifelsepipeline,
+    parallelpipeline,
 )
 
 from agentscope.agents import AgentBase
@@ -114,6 +117,19 @@ class Loop_while_agent(AgentBase):
         return x
 
 
+class Sleep_agent(AgentBase):
+    """Operator that sleeps before replying"""
+
+    def __init__(self, name: str, delay: float) -> None:
+        self.name = name
+        self.delay = delay
+        super().__init__(name=name)
+
+    def __call__(self, x: dict = None) -> dict:
+        time.sleep(self.delay)
+        return {"name": self.name, "value": x["value"]}
+
+
 class BasicPipelineTest(unittest.TestCase):
     """Test cases for Basic Pipelines"""
 
@@ -210,6 +226,20 @@ class BasicPipelineTest(unittest.TestCase):
             x = p(x)
             self.assertTrue(x["round"] >= 10 or x["token_num"] > 500)
 
+    def test_parallel_pipeline(self) -> None:
+        """Test ParallelPipeline executes agents concurrently and keeps the
+        order of outputs"""
+        agents = [Sleep_agent(f"agent{i}", 0.3 - i * 0.1) for i in range(3)]
+
+        p = ParallelPipeline(agents)
+        start = time.time()
+        outputs = p({"value": 1})
+        self.assertLess(time.time() - start, 0.55)
+        self.assertListEqual(
+            [_["name"] for _ in outputs],
+            ["agent0", "agent1", "agent2"],
+        )
+
 
 class FunctionalPipelineTest(unittest.TestCase):
     """Test cases for Functional Pipelines"""
@@ -254,6 +284,21 @@ class FunctionalPipelineTest(unittest.TestCase):
         self.assertEqual(if_x["operation"], "A")
         self.assertEqual(else_x["operation"], "B")
 
+    def test_parallel_pipeline(self) -> None:
+        """Test parallelpipeline combines the outputs by reduce_func"""
+        add1 = Add("add1", 1)
+        mult3 = Mult("mult3", 3)
+
+        total = parallelpipeline(
+            operators=[
+                Sleep_agent("agent0", 0.1),
+                [Sleep_agent("agent1", 0.1), add1, mult3],
+            ],
+            x={"value": 1},
+            reduce_func=lambda outputs: sum(_["value"] for _ in outputs),
+        )
+        self.assertEqual(total, 1 + (1 + 1) * 3)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,155 @@
+# -*- coding: utf-8 -*-
+"""Unit tests for the concurrent comparison of system prompts."""
+import json
+import os
+import shutil
+import tempfile
+import threading
+import time
+import unittest
+from typing import Any, List, Sequence, Union
+
+from agentscope.message import Msg
+from agentscope.models import (
+    ModelResponse,
+    ModelWrapperBase,
+    read_model_configs,
+    clear_model_configs,
+)
+from agentscope.prompt import SystemPromptComparer
+
+
+class DummyComparerModel(ModelWrapperBase):
+    """A dummy chat model that echoes the system prompt and the query."""
+
+    model_type: str = "dummy_comparer_chat"
+
+    calls: List[str] = []
+
+    running: int = 0
+
+    max_running: int = 0
+
+    lock = threading.Lock()
+
+    def __call__(self, messages: List[dict], **kwargs: Any) -> ModelResponse:
+        cls = DummyComparerModel
+        with cls.lock:
+            cls.running += 1
+            cls.max_running = max(cls.max_running, cls.running)
+        time.sleep(0.05)
+        with cls.lock:
+            cls.running -= 1
+            text = f"{messages[0]['content']}|{messages[1]['content']}"
+            cls.calls.append(text)
+        return ModelResponse(text=text)
+
+    def format(
+        self,
+        *args: Union[Msg, Sequence[Msg]],
+    ) -> Union[List[dict], str]:
+        """Format the messages into the chat format."""
+        return [{"role": _.role, "content": _.content} for _ in args]
+
+
+class PromptComparerTest(unittest.TestCase):
+    """Test cases for SystemPromptComparer."""
+
+    def setUp(self) -> None:
+        self.tmp_dir = tempfile.mkdtemp()
+        DummyComparerModel.calls = []
+        DummyComparerModel.max_running = 0
+        read_model_configs(
+            [
+                {
+                    "config_name": "dummy_comparer",
+                    "model_type": "dummy_comparer_chat",
+                },
+            ],
+            clear_existing=True,
+        )
+        self.comparer = SystemPromptComparer(
+            "dummy_comparer",
+            ["prompt-a", "prompt-b"],
+        )
+        self.queries = ["q1", "q2", "q3"]
+
+    def tearDown(self) -> None:
+        shutil.rmtree(self.tmp_dir)
+        clear_model_configs()
+
+    def test_compare_with_queries(self) -> None:
+        """Test the results are complete and in order when inferred
+        concurrently."""
+        results = self.comparer.compare_with_queries(
+            self.queries,
+            max_workers=4,
+        )
+
+        self.assertEqual(len(DummyComparerModel.calls), 6)
+        self.assertGreater(DummyComparerModel.max_running, 1)
+        self.assertLessEqual(DummyComparerModel.max_running, 4)
+        for query, result in zip(self.queries, results):
+            self.assertEqual(result["query"], query)
+            self.assertListEqual(
+                [_["response"] for _ in result["results"]],
+                [f"prompt-a|{query}", f"prompt-b|{query}"],
+            )
+
+    def test_resume_from_checkpoint(self) -> None:
+        """Test the completed pairs in the checkpoint are not inferred
+        again."""
+        checkpoint_path = os.path.join(self.tmp_dir, "checkpoint.jsonl")
+
+        # Interrupt after two results are completed
+        stream = self.comparer.iter_compare_with_queries(
+            self.queries,
+            max_workers=1,
+            checkpoint_path=checkpoint_path,
+        )
+        next(stream)
+        next(stream)
+        stream.close()
+
+        with open(checkpoint_path, "r", encoding="utf-8") as file:
+            n_completed = len([json.loads(_) for _ in file])
+        self.assertGreaterEqual(n_completed, 2)
+
+        DummyComparerModel.calls = []
+        results = self.comparer.compare_with_queries(
+            self.queries,
+            checkpoint_path=checkpoint_path,
+        )
+        self.assertEqual(len(DummyComparerModel.calls), 6 - n_completed)
+        self.assertEqual(results[2]["results"][1]["response"], "prompt-b|q3")
+
+    def test_resume_from_truncated_checkpoint(self) -> None:
+        """Test the unfinished last line of the checkpoint is dropped when
+        resuming."""
+        checkpoint_path = os.path.join(self.tmp_dir, "checkpoint.jsonl")
+        record = {
+            "query_index": 0,
+            "query": "q1",
+            "prompt_index": 0,
+            "system_prompt": "prompt-a",
+            "response": "prompt-a|q1",
+        }
+        with open(checkpoint_path, "w", encoding="utf-8") as file:
+            file.write(json.dumps(record) + "\n")
+            file.write(json.dumps(record)[:20])
+
+        results = self.comparer.compare_with_queries(
+            self.queries,
+            checkpoint_path=checkpoint_path,
+        )
+        self.assertEqual(len(DummyComparerModel.calls), 5)
+        self.assertEqual(results[0]["results"][0]["response"], "prompt-a|q1")
+
+        # The following records are appended after the last complete line
+        with open(checkpoint_path, "r", encoding="utf-8") as file:
+            records = [json.loads(_) for _ in file]
+        self.assertEqual(len(records), 6)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,125 @@
+# -*- coding: utf-8 -*-
+"""Unit tests for the example selection in system prompt generator."""
+import shutil
+import tempfile
+import unittest
+from typing import Any, List, Sequence, Union
+
+import numpy as np
+
+from agentscope.file_manager import file_manager
+from agentscope.message import Msg
+from agentscope.models import (
+    ModelResponse,
+    ModelWrapperBase,
+    read_model_configs,
+    clear_model_configs,
+)
+from agentscope.prompt import EnglishSystemPromptGenerator
+from agentscope.prompt._prompt_utils import _find_top_k_embeddings
+
+
+class DummyExampleEmbeddingModel(ModelWrapperBase):
+    """A dummy embedding model recording the texts of each request."""
+
+    model_type: str = "dummy_example_embedding"
+
+    requests: List[List[str]] = []
+
+    max_batch_size: int = 64
+
+    def __call__(
+        self,
+        texts: Union[List[str], str],
+        **kwargs: Any,
+    ) -> ModelResponse:
+        if isinstance(texts, str):
+            texts = [texts]
+        DummyExampleEmbeddingModel.requests.append(texts)
+        return ModelResponse(
+            embedding=[
+                [float(len(_)), float(_.count("a")), 1.0] for _ in texts
+            ],
+        )
+
+    def format(
+        self,
+        *args: Union[Msg, Sequence[Msg]],
+    ) -> Union[List[dict], str]:
+        """No need to format for embedding."""
+        return ""
+
+
+class PromptGeneratorExampleTest(unittest.TestCase):
+    """Test cases for selecting examples by similarity."""
+
+    def setUp(self) -> None:
+        self.cache_dir = tempfile.mkdtemp()
+        self.default_cache_dir = file_manager.cache_dir
+        file_manager.cache_dir = self.cache_dir
+        DummyExampleEmbeddingModel.requests = []
+
+        read_model_configs(
+            [
+                {
+                    "config_name": "dummy_chat",
+                    "model_type": "post_api_chat",
+                    "api_url": "http://127.0.0.1:1",
+                },
+                {
+                    "config_name": "dummy_example_embedding",
+                    "model_type": "dummy_example_embedding",
+                },
+            ],
+            clear_existing=True,
+        )
+
+    def tearDown(self) -> None:
+        file_manager.cache_dir = self.default_cache_dir
+        shutil.rmtree(self.cache_dir)
+        clear_model_configs()
+
+    def test_find_top_k_embeddings(self) -> None:
+        """Test the top k embeddings are sorted by cosine similarity."""
+        rng = np.random.default_rng(0)
+        embeddings = rng.normal(size=(100, 8))
+        query = rng.normal(size=8)
+
+        similarities = embeddings @ query / np.linalg.norm(embeddings, axis=1)
+        expected = list(np.argsort(-similarities)[:5])
+
+        self.assertListEqual(
+            _find_top_k_embeddings(list(query), embeddings.tolist(), 5),
+            expected,
+        )
+
+    def test_example_embeddings_cache(self) -> None:
+        """Test the examples are embedded in batch only once."""
+        kwargs = {
+            "model_config_name": "dummy_chat",
+            "example_num": 2,
+            "example_selection_strategy": "similarity",
+            "embed_model_config_name": "dummy_example_embedding",
+        }
+
+        generator = EnglishSystemPromptGenerator(**kwargs)
+        n_examples = len(generator.example_list)
+        self.assertEqual(
+            sum(len(_) for _ in DummyExampleEmbeddingModel.requests),
+            n_examples,
+        )
+        self.assertLess(len(DummyExampleEmbeddingModel.requests), n_examples)
+        self.assertEqual(generator.example_embeddings.dtype, np.float32)
+
+        # The example embeddings are loaded from the cache as a whole
+        DummyExampleEmbeddingModel.requests = []
+        generator = EnglishSystemPromptGenerator(**kwargs)
+        self.assertListEqual(DummyExampleEmbeddingModel.requests, [])
+
+        query = DummyExampleEmbeddingModel(config_name="query")("aaaa")
+        selected = generator.example_index.search(query.embedding[0], 2)
+        self.assertEqual(len(selected), 2)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,81 @@
+# -*- coding: utf-8 -*-
+"""Unit tests for the fusion of retrieved results."""
+import unittest
+
+from agentscope.rag.fusion import fuse_results
+
+
+class FuseResultsTest(unittest.TestCase):
+    """Test cases for fuse_results."""
+
+    def setUp(self) -> None:
+        """The ranked (text, score) results of two sources."""
+        self.ranked_lists = [
+            [("apple is red", 0.9), ("banana is yellow", 0.8)],
+            [("grape is purple", 0.95), ("Apple  is red", 0.7)],
+        ]
+
+    def test_rrf(self) -> None:
+        """Test a chunk retrieved by both sources ranks first."""
+        fused = fuse_results(self.ranked_lists, get_text=lambda _: _[0])
+        self.assertListEqual(
+            [item[0] for item, _ in fused],
+            ["apple is red", "grape is purple", "banana is yellow"],
+        )
+        self.assertAlmostEqual(fused[0][1], 1 / 61 + 1 / 62)
+
+    def test_score(self) -> None:
+        """Test the results are ranked by their highest scores."""
+        fused = fuse_results(
+            self.ranked_lists,
+            get_text=lambda _: _[0],
+            get_score=lambda _: _[1],
+            method="score",
+        )
+        self.assertListEqual(
+            [(item[0], score) for item, score in fused],
+            [
+                ("grape is purple", 0.95),
+                ("apple is red", 0.9),
+                ("banana is yellow", 0.8),
+            ],
+        )
+
+    def test_weighted(self) -> None:
+        """Test the normalized scores are summed by the weights."""
+        ranked_lists = [
+            [("apple is red", 0.9), ("banana is yellow", 0.5)],
+            [("grape is purple", 12.0), ("apple is red", 2.0)],
+        ]
+        fused = fuse_results(
+            ranked_lists,
+            get_text=lambda _: _[0],
+            get_score=lambda _: _[1],
+            method="weighted",
+            weights=[0.7, 0.3],
+        )
+        self.assertListEqual(
+            [(item[0], round(score, 6)) for item, score in fused],
+            [
+                ("apple is red", 0.7),
+                ("grape is purple", 0.3),
+                ("banana is yellow", 0.0),
+            ],
+        )
+
+    def test_near_duplicates(self) -> None:
+        """Test the near-identical chunks are merged by the threshold."""
+        text = " ".join(f"word{i}" for i in range(20))
+        ranked_lists = [[text + " more"], [text]]
+        self.assertEqual(
+            len(fuse_results(ranked_lists, get_text=str)),
+            1,
+        )
+        self.assertEqual(
+            len(fuse_results(ranked_lists, get_text=str, dedup_threshold=1)),
+            2,
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,120 @@
+# -*- coding: utf-8 -*-
+"""Unit tests for the reranker of retrieved chunks."""
+import unittest
+from typing import Any, List
+
+from agentscope.models import ModelResponse, ModelWrapperBase
+from agentscope.rag.reranker import Reranker
+from agentscope.utils.token_utils import count_text_tokens
+
+
+class DummyChatModel(ModelWrapperBase):
+    """A chat model rating the passages by a fixed response."""
+
+    model_type: str = "dummy_rerank_chat"
+
+    def __init__(self, response: str) -> None:
+        """dummy init"""
+        self.response = response
+        self.prompts: list = []
+
+    def format(self, *args: Any) -> List[dict]:
+        """Format the messages as dicts."""
+        return [{"role": _.role, "content": _.content} for _ in args]
+
+    def __call__(self, messages: List[dict], **kwargs: Any) -> ModelResponse:
+        """Return the fixed response."""
+        self.prompts.append(messages)
+        return ModelResponse(text=self.response)
+
+
+class RerankerTest(unittest.TestCase):
+    """Test cases for Reranker."""
+
+    def setUp(self) -> None:
+        """A scorer counting the chunks, which scores by the shared words."""
+        self.batches: list = []
+
+        def score(query: str, texts: List[str]) -> List[float]:
+            self.batches.append(len(texts))
+            words = set(query.split())
+            return [float(len(words & set(_.split()))) for _ in texts]
+
+        self.score = score
+        self.texts = [
+            "the weather is sunny",
+            "the capital of france is paris",
+            "paris is the capital and largest city of france",
+            "bananas are yellow",
+        ]
+
+    def test_batches_and_cache(self) -> None:
+        """Test the uncached texts are scored in batches."""
+        reranker = Reranker(self.score, batch_size=3)
+        query = "capital of france"
+        reranked, _ = reranker.rerank(query, self.texts, get_text=str)
+        self.assertListEqual(
+            [text for text, _ in reranked],
+            [self.texts[1], self.texts[2], self.texts[0], self.texts[3]],
+        )
+        self.assertListEqual(self.batches, [3, 1])
+
+        # only the new text is scored, and the duplicate once
+        texts = self.texts + ["france", "france"]
+        reranker.rerank(query, texts, get_text=str)
+        self.assertListEqual(self.batches, [3, 1, 1])
+
+    def test_top_n_and_token_budget(self) -> None:
+        """Test the chunks are kept in top_n and the token budget."""
+        reranker = Reranker(self.score, top_n=2)
+        query = "largest city of france"
+        reranked, report = reranker.rerank(query, self.texts, get_text=str)
+        self.assertListEqual(
+            [text for text, _ in reranked],
+            [self.texts[2], self.texts[1]],
+        )
+        self.assertEqual(report["candidates"], 4)
+        self.assertEqual(report["kept"], 2)
+        # compared with the first top_n chunks in the retrieval order
+        self.assertEqual(
+            report["baseline_tokens"],
+            sum(count_text_tokens(_, None) for _ in self.texts[:2]),
+        )
+        self.assertEqual(
+            report["saved_tokens"],
+            report["baseline_tokens"] - report["kept_tokens"],
+        )
+
+        # the chunk exceeding the budget is skipped, and the next one fits
+        budget = report["kept_tokens"] - 1
+        reranked, report = reranker.rerank(
+            query,
+            self.texts,
+            get_text=str,
+            max_tokens=budget,
+        )
+        self.assertLessEqual(report["kept_tokens"], budget)
+        self.assertListEqual(
+            [text for text, _ in reranked],
+            [self.texts[2], self.texts[0]],
+        )
+
+    def test_chat_model(self) -> None:
+        """Test the chat model rates a batch in one call, and the original
+        order is kept if the response can't be parsed."""
+        model = DummyChatModel("Scores: [1, 9, 5, 0]")
+        reranker = Reranker(model)
+        reranked, _ = reranker.rerank("query", self.texts, get_text=str)
+        self.assertListEqual(
+            [score for _, score in reranked],
+            [9.0, 5.0, 1.0, 0.0],
+        )
+        self.assertEqual(len(model.prompts), 1)
+
+        reranker = Reranker(DummyChatModel("[1, 9]"))
+        reranked, _ = reranker.rerank("query", self.texts, get_text=str)
+        self.assertListEqual([text for text, _ in reranked], self.texts)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -6,13 +6,23 @@ import unittest
 import time
 import os
 import shutil
-from typing import Optional, Union, Sequence
+from typing import Any, Optional, Union, Sequence
+from unittest.mock import patch
 
+import dill
 from loguru import logger
 
 import agentscope
-from agentscope.agents import AgentBase, DistConf
-from agentscope.server import RpcAgentServerLauncher
+from agentscope.agents import AgentBase, DistConf, RpcAgent
+from agentscope.server import (
+    RpcAgentServerLauncher,
+    configure_server_pool,
+    configure_server_template,
+)
+from agentscope.server.server_template import (
+    AgentServerTemplate,
+    ForkedServer,
+)
 from agentscope.message import Msg
 from agentscope.message import PlaceholderMessage
 from agentscope.message import deserialize
@@ -21,6 +31,11 @@ from agentscope.pipelines import sequentialpipeline
 from agentscope.utils import MonitorFactory, QuotaExceededError
 
 
+def _hanging_agent_server(**kwargs: Any) -> None:
+    """An agent server that never starts."""
+    kwargs["stop_event"].wait()
+
+
 class DemoRpcAgent(AgentBase):
     """A demo Rpc agent for test usage."""
 
@@ -543,6 +558,144 @@ class BasicRpcAgentTest(unittest.TestCase):
         self.assertEqual(res3.content["mem_size"], 1)
         self.assertEqual(res4.content["mem_size"], 1)
 
+    def test_create_in_batch(self) -> None:
+        """Test creating the agents in bulk across servers"""
+        launchers = [
+            RpcAgentServerLauncher(
+                host="localhost",
+                port=None,
+                custom_agents=[DemoRpcAgentWithMemory],
+            )
+            for _ in range(2)
+        ]
+        for launcher in launchers:
+            launcher.launch()
+            self.addCleanup(launcher.shutdown)
+
+        with RpcAgent.create_in_batch(batch_size=3):
+            agents = [
+                DemoRpcAgentWithMemory(name=f"a{i}").to_dist(
+                    host="localhost",
+                    port=launchers[i % 2].port,
+                )
+                for i in range(10)
+            ]
+            # The agents are created when the context exits
+            self.assertRaises(
+                Exception,
+                agents[0].client.call_func,
+                "_observe",
+                "[]",
+            )
+        for i, agent in enumerate(agents):
+            msg = agent(Msg(name="System", content="hi", role="system"))
+            self.assertEqual(msg.name, f"a{i}")
+            self.assertEqual(msg.content["mem_size"], 1)
+
+        # Clone the agents in one request
+        clones = agents[0].clone_instances(5, including_self=False)
+        self.assertEqual(len(clones), 5)
+        self.assertEqual(len({_.agent_id for _ in clones}), 5)
+        for agent in clones:
+            self.assertEqual(agent.port, launchers[0].port)
+            msg = agent(Msg(name="System", content="hi", role="system"))
+            self.assertEqual(msg.content["mem_size"], 1)
+
+    def test_shared_server_pool(self) -> None:
+        """Test packing the agents into the shared servers"""
+        configure_server_pool(num_servers=2)
+        self.addCleanup(configure_server_pool)
+
+        agents = [
+            DemoRpcAgentWithMemory(name=f"a{i}").to_dist(lazy_launch=False)
+            for i in range(4)
+        ] + [DemoRpcAgentAdd(name="b", to_dist=True)]
+        # The agents are placed on two servers by load
+        ports = [agent.port for agent in agents[:4]]
+        self.assertEqual(len(set(ports)), 2)
+        self.assertEqual(ports.count(ports[0]), 2)
+
+        # The agents in the same server are independent
+        for agent in agents[:4]:
+            msg = agent(Msg(name="System", content="hi", role="system"))
+            self.assertEqual(msg.content["mem_size"], 1)
+        # A new agent class is registered to the shared server
+        msg = agents[4](Msg(name="System", content={"value": 1}))
+        self.assertEqual(msg.content["value"], 2)
+        self.assertIn(agents[4].port, ports)
+
+        # The server is shut down after all its agents are stopped
+        launcher = agents[0].server_launcher
+        for agent in agents:
+            if agent.server_launcher is launcher:
+                agent.stop()
+        self.assertIsNone(launcher.server)
+
+    def test_server_template(self) -> None:
+        """Test forking the agent servers from the server template"""
+        launchers = [
+            RpcAgentServerLauncher(
+                host="localhost",
+                port=None,
+                local_mode=True,
+                custom_agents=[DemoRpcAgentAdd],
+            )
+            for _ in range(2)
+        ]
+        for launcher in launchers:
+            launcher.launch()
+            self.addCleanup(launcher.shutdown)
+            self.assertIsInstance(launcher.server, ForkedServer)
+            self.assertTrue(launcher.server.is_alive())
+        self.assertIs(
+            launchers[0].server.template,
+            launchers[1].server.template,
+        )
+
+        agent = DemoRpcAgentAdd(name="a").to_dist(
+            host="localhost",
+            port=launchers[1].port,
+        )
+        msg = agent(Msg(name="System", content={"value": 1}, role="system"))
+        self.assertEqual(msg.content["value"], 2)
+
+        launchers[0].shutdown()
+        self.assertIsNone(launchers[0].server)
+        msg = agent(Msg(name="System", content={"value": 2}, role="system"))
+        self.assertEqual(msg.content["value"], 3)
+
+        # Start the servers as new processes if the template is disabled
+        configure_server_template(enable=False)
+        self.addCleanup(configure_server_template)
+        launcher = RpcAgentServerLauncher(host="localhost", local_mode=True)
+        launcher.launch()
+        self.assertNotIsInstance(launcher.server, ForkedServer)
+        launcher.shutdown()
+
+    def test_server_template_timeout(self) -> None:
+        """Test the template kills a server that doesn't start in time"""
+        with patch(
+            "agentscope.server.launcher._setup_agent_server",
+            _hanging_agent_server,
+        ):
+            template = AgentServerTemplate(init_settings={})
+        self.addCleanup(template.close)
+
+        start = time.time()
+        with self.assertRaisesRegex(RuntimeError, "doesn't start in 0.5"):
+            template.launch(timeout=0.5, server_id="hanging")
+        self.assertLess(time.time() - start, 5)
+        self.assertFalse(template.request("is_alive", "hanging"))
+
+        # The reply isn't waited for longer than the timeout of the request
+        with self.assertRaises(TimeoutError):
+            template.request(
+                "launch",
+                dill.dumps({"server_id": "hanging"}),
+                2,
+                timeout=0.2,
+            )
+
     def test_error_handling(self) -> None:
         """Test error handling"""
         agent = DemoErrorAgent(name="a").to_dist()
@@ -1,6 +1,7 @@
 # -*- coding: utf-8 -*-
 """ Unit test for service toolkit. """
 import json
+import time
 import unittest
 from typing import Literal
 
@@ -14,6 +15,8 @@ from agentscope.service import (
     summarization,
 )
 from agentscope.service import ServiceToolkit
+from agentscope.service import ServiceResponse, ServiceExecStatus
+from agentscope.service.service_cache import ServiceResultCache
 
 
 class ServiceToolkitTest(unittest.TestCase):
@@ -260,6 +263,8 @@ class ServiceToolkitTest(unittest.TestCase):
             port=3306,
             allow_change_data=False,
             maxcount_results=None,
+            max_bytes=65536,
+            summarize=True,
         )
 
         self.assertDictEqual(
@@ -276,6 +281,8 @@ class ServiceToolkitTest(unittest.TestCase):
             summarization_prompt="",
             max_return_token=-1,
             token_limit_prompt="",
+            chunk_tokens=3000,
+            max_workers=4,
         )
 
         print(json.dumps(doc_dict, indent=4))
@@ -322,6 +329,141 @@ The following tool functions are available in the format of
             },
         )
 
+    def test_parallel_execution(self) -> None:
+        """Test executing the function calls in parallel."""
+
+        def sleep_and_echo(text: str) -> ServiceResponse:
+            """Sleep for a while and echo the text.
+
+            Args:
+                text (`str`):
+                    The text to echo.
+            """
+            time.sleep(0.5)
+            return ServiceResponse(ServiceExecStatus.SUCCESS, text)
+
+        def slow_func() -> ServiceResponse:
+            """A function that runs too long."""
+            time.sleep(2)
+            return ServiceResponse(ServiceExecStatus.SUCCESS, "done")
+
+        slow_func.timeout = 0.2
+
+        service_toolkit = ServiceToolkit(parallel=True, max_workers=4)
+        service_toolkit.add(sleep_and_echo)
+        service_toolkit.add(slow_func)
+
+        cmds = [
+            {"name": "sleep_and_echo", "arguments": {"text": f"echo{i}"}}
+            for i in range(3)
+        ] + [{"name": "slow_func", "arguments": {}}]
+
+        start = time.time()
+        res = service_toolkit.parse_and_call_func(cmds)
+        self.assertLess(time.time() - start, 1.2)
+
+        # The results are kept in the original order
+        positions = [res.find(f"[RESULT]: echo{i}") for i in range(3)]
+        self.assertTrue(all(_ != -1 for _ in positions))
+        self.assertListEqual(positions, sorted(positions))
+        self.assertIn("[STATUS]: FAILED", res)
+        self.assertIn("Timeout after 0.2 seconds.", res)
+
+        # The queued calls are not timed out before they start
+        service_toolkit = ServiceToolkit(
+            parallel=True,
+            max_workers=1,
+            timeout=0.8,
+        )
+        self.addCleanup(service_toolkit.close)
+        service_toolkit.add(sleep_and_echo)
+        res = service_toolkit.parse_and_call_func(cmds[:3])
+        self.assertNotIn("[STATUS]: FAILED", res)
+
+        # A timeout of 0 in the function overrides the default
+        service_toolkit.service_funcs["sleep_and_echo"].timeout = 0
+        res = service_toolkit.parse_and_call_func(cmds[:2])
+        self.assertIn("Timeout after 0 seconds", res)
+
+        # The calls queued behind a stuck worker time out as well, and the
+        # following calls get a fresh pool
+        service_toolkit = ServiceToolkit(
+            parallel=True,
+            max_workers=1,
+            timeout=0.6,
+        )
+        self.addCleanup(service_toolkit.close)
+        service_toolkit.add(sleep_and_echo)
+        service_toolkit.add(slow_func)
+        start = time.time()
+        res = service_toolkit.parse_and_call_func(cmds[3:] + cmds[:1])
+        self.assertLess(time.time() - start, 1.2)
+        self.assertIn("Timeout after 0.2 seconds.", res)
+        self.assertIn("Timeout after 0.6 seconds waiting for a free", res)
+
+        start = time.time()
+        res = service_toolkit.parse_and_call_func(cmds[:2])
+        self.assertLess(time.time() - start, 1.5)
+        self.assertNotIn("[STATUS]: FAILED", res)
+
+    def test_result_cache(self) -> None:
+        """Test caching the results of pure functions."""
+        counter = {"n_calls": 0}
+
+        def search(query: str, num_results: int = 3) -> ServiceResponse:
+            """Search the query.
+
+            Args:
+                query (`str`):
+                    The query to search.
+                num_results (`int`, defaults to `3`):
+                    The number of results.
+            """
+            counter["n_calls"] += 1
+            return ServiceResponse(
+                ServiceExecStatus.SUCCESS,
+                f"{query}-{num_results}",
+            )
+
+        search.pure = True
+
+        service_toolkit = ServiceToolkit(cache=ServiceResultCache())
+        service_toolkit.add(search)
+
+        cmd1 = [{"name": "search", "arguments": {"query": "a"}}]
+        cmd2 = '[{"arguments": {"query": "a"}, "name": "search"}]'
+        cmd3 = [{"name": "search", "arguments": {"query": "b"}}]
+
+        res1 = service_toolkit.parse_and_call_func(cmd1)
+        res2 = service_toolkit.parse_and_call_func(cmd2)
+        self.assertEqual(res1, res2)
+        self.assertEqual(counter["n_calls"], 1)
+
+        # Prefetched results are reused
+        service_toolkit.prefetch(cmd3)
+        res3 = service_toolkit.parse_and_call_func(cmd3)
+        self.assertIn("[RESULT]: b-3", res3)
+        self.assertEqual(counter["n_calls"], 2)
+
+        # A function declaring only a ttl is cached, and the calls with
+        # different preset arguments are not shared
+        del search.pure
+        search.ttl = 600
+        cache = ServiceResultCache()
+        toolkit1 = ServiceToolkit(cache=cache)
+        toolkit1.add(search, num_results=1)
+        toolkit2 = ServiceToolkit(cache=cache)
+        toolkit2.add(search, num_results=2)
+        toolkit1.parse_and_call_func(cmd1)
+        toolkit1.parse_and_call_func(cmd1)
+        self.assertEqual(counter["n_calls"], 3)
+        self.assertIn("[RESULT]: a-2", toolkit2.parse_and_call_func(cmd1))
+        self.assertEqual(counter["n_calls"], 4)
+
+        # The preset values are hashed in the cache key
+        key = ServiceResultCache.get_key("search", {}, {"api_key": "secret"})
+        self.assertNotIn("secret", key)
+
     def test_multi_tagged_content(self) -> None:
         """Test multi tagged content"""
 
@@ -1,8 +1,16 @@
 # -*- coding: utf-8 -*-
 """ Python sql query test."""
+import os
+import shutil
+import sqlite3
+import tempfile
 import unittest
+from typing import Any
 from unittest.mock import MagicMock, patch
 
+from agentscope.service.sql_query.connection_pool import (
+    close_sql_connection_pools,
+)
 from agentscope.service.sql_query.mongodb import query_mongodb
 
 from agentscope.service.sql_query.mysql import query_mysql
@@ -10,15 +18,75 @@ from agentscope.service.service_response import ServiceExecStatus
 from agentscope.service.sql_query.sqlite import query_sqlite
 
 
+class _SnapshotCursor:
+    """A cursor reading the snapshot of its connection."""
+
+    def __init__(self, conn: "_SnapshotConnection") -> None:
+        self.conn = conn
+        self.rows: list = []
+        self.description = [("id",)]
+
+    def execute(self, query: str) -> None:  # pylint: disable=W0613
+        """Read the table in the snapshot of the transaction."""
+        if self.conn.snapshot is None:
+            self.conn.snapshot = list(self.conn.table)
+        self.rows = list(self.conn.snapshot)
+
+    def fetchmany(self, size: int) -> list:
+        """Fetch a page of rows."""
+        page, self.rows = self.rows[:size], self.rows[size:]
+        return page
+
+    def close(self) -> None:
+        """Close the cursor."""
+
+
+class _SnapshotConnection:
+    """A connection with the REPEATABLE READ isolation level, where a
+    transaction reads the snapshot taken by its first query."""
+
+    def __init__(self, table: list) -> None:
+        self.table = table
+        self.snapshot = None
+        self.open = True
+
+    def cursor(self, *args: Any) -> _SnapshotCursor:  # pylint: disable=W0613
+        """Open a cursor."""
+        return _SnapshotCursor(self)
+
+    def commit(self) -> None:
+        """End the transaction."""
+        self.snapshot = None
+
+    def rollback(self) -> None:
+        """End the transaction."""
+        self.snapshot = None
+
+    def ping(self, reconnect: bool = False) -> None:
+        """Check the connection."""
+
+    def close(self) -> None:
+        """Close the connection."""
+        self.open = False
+
+
 class TestSQLQueries(unittest.TestCase):
     """ExampleTest for a unit test."""
 
+    def setUp(self) -> None:
+        """Clear the pooled connections."""
+        close_sql_connection_pools()
+
+    def tearDown(self) -> None:
+        """Clear the pooled connections."""
+        close_sql_connection_pools()
+
     @patch("agentscope.service.sql_query.mysql.pymysql.connect")
     def test_query_mysql_success(self, mock_connect: MagicMock) -> None:
         """Test query mysql success"""
         # Set up a mock connection and cursor
         mock_cursor = mock_connect.return_value.cursor.return_value
-        mock_cursor.fetchall.return_value = [("data1",), ("data2",)]
+        mock_cursor.fetchmany.side_effect = [[("data1",), ("data2",)], ()]
 
         # Call the query_mysql function
         response = query_mysql(
@@ -38,10 +106,79 @@ class TestSQLQueries(unittest.TestCase):
 
         # Ensure that the SQL query was executed correctly
         mock_cursor.execute.assert_called_once_with(
-            "SELECT * FROM my_table LIMIT 10",
+            "SELECT * FROM my_table",
         )
-        # Ensure that all results were fetched
-        mock_cursor.fetchall.assert_called_once()
+        # Ensure that the results were streamed in pages
+        self.assertEqual(mock_cursor.fetchmany.call_count, 2)
+
+        # The pooled connection is reused
+        query_mysql(
+            database="test_mysql_db",
+            query="SELECT * FROM my_table",
+            host="localhost",
+            user="user",
+            password="pass",
+            port=3306,
+        )
+        mock_connect.assert_called_once()
+        mock_connect.return_value.ping.assert_called_once()
+
+    @patch("agentscope.service.sql_query.mysql.pymysql.connect")
+    def test_query_mysql_pooled_snapshot(
+        self,
+        mock_connect: MagicMock,
+    ) -> None:
+        """Test a pooled connection sees the rows committed by another
+        connection after a SELECT"""
+        table = [(1,)]
+        mock_connect.side_effect = lambda **kwargs: _SnapshotConnection(table)
+        kwargs = {
+            "database": "test_mysql_db",
+            "query": "SELECT id FROM my_table",
+            "host": "localhost",
+            "user": "user",
+            "password": "pass",
+            "port": 3306,
+        }
+
+        self.assertEqual(query_mysql(**kwargs).content, [(1,)])
+        # Another connection commits a new row
+        table.append((2,))
+        self.assertEqual(query_mysql(**kwargs).content, [(1,), (2,)])
+        mock_connect.assert_called_once()
+
+    @patch("agentscope.service.sql_query.mysql.pymysql.connect")
+    def test_query_mysql_budget(self, mock_connect: MagicMock) -> None:
+        """Test the results exceeding the budget are summarized"""
+        mock_conn = mock_connect.return_value
+        mock_cursor = mock_conn.cursor.return_value
+        mock_cursor.fetchmany.side_effect = [[(1, "a"), (2, "b"), (3, "c")]]
+        mock_cursor.description = [("id",), ("name",)]
+        mock_cursor.__enter__.return_value.fetchone.return_value = (1000,)
+
+        response = query_mysql(
+            database="test_mysql_db",
+            query="SELECT * FROM my_table;",
+            host="localhost",
+            user="user",
+            password="pass",
+            port=3306,
+            maxcount_results=2,
+        )
+
+        self.assertEqual(response.status, ServiceExecStatus.SUCCESS)
+        self.assertEqual(response.content["count"], 1000)
+        self.assertEqual(response.content["sample"], [(1, "a"), (2, "b")])
+        self.assertEqual(
+            response.content["columns"],
+            [{"name": "id", "type": "int"}, {"name": "name", "type": "str"}],
+        )
+        mock_cursor.__enter__.return_value.execute.assert_called_with(
+            "SELECT COUNT(*) FROM (SELECT * FROM my_table) AS _counted",
+        )
+        # The unfinished result is aborted by closing the connection
+        mock_conn.close.assert_called_once()
+        mock_cursor.close.assert_not_called()
 
     @patch("agentscope.service.sql_query.mysql.pymysql.connect")
     def test_query_mysql_failure(self, mock_connect: MagicMock) -> None:
@@ -69,16 +206,16 @@ class TestSQLQueries(unittest.TestCase):
         """Test query mongodb success"""
         # Set up a mock connection
         mock_collection = MagicMock()
-        mock_collection.find.return_value.limit.return_value = [
-            {"_id": 1, "data": "test"},
-        ]
+        mock_results = MagicMock()
+        mock_results.__iter__.return_value = iter([{"_id": 1, "data": "test"}])
+        mock_cursor = mock_collection.find.return_value.batch_size.return_value
+        mock_cursor.limit.return_value = mock_results
         mock = MagicMock()
         mock_db = MagicMock()
         mock.__getitem__.return_value = mock_db
         mock_db.__getitem__.return_value = mock_collection
 
-        mock_client = MagicMock()
-        mock_mongo_client.return_value.__enter__.return_value = mock_client
+        mock_client = mock_mongo_client.return_value
         mock_client.__getitem__.return_value = mock_db
 
         # Call the query_mongodb function
@@ -98,7 +235,8 @@ class TestSQLQueries(unittest.TestCase):
         # Ensure that the query was executed correctly
         mock_db.__getitem__.assert_called_with("collection_name")
         mock_collection.find.assert_called_with({"data": "test"})
-        mock_collection.find.return_value.limit.assert_called_with(10)
+        mock_cursor.limit.assert_called_with(11)
+        mock_results.close.assert_called_once()
 
     @patch("agentscope.service.sql_query.mongodb.pymongo.MongoClient")
     def test_query_mongodb_failure(self, mock_mongo_client: MagicMock) -> None:
@@ -125,7 +263,7 @@ class TestSQLQueries(unittest.TestCase):
         """Test successful SELECT query without data modification"""
         # Mock sqlite connection and cursor
         mock_cursor = MagicMock()
-        mock_cursor.fetchall.return_value = [("data1",), ("data2",)]
+        mock_cursor.fetchmany.side_effect = [[("data1",), ("data2",)], []]
 
         mock_connection = MagicMock()
         mock_connection.cursor.return_value = mock_cursor
@@ -146,10 +284,10 @@ class TestSQLQueries(unittest.TestCase):
 
         # Verify the correct SQL query was executed
         mock_cursor.execute.assert_called_with(
-            "SELECT * FROM my_table LIMIT 10",
+            "SELECT * FROM my_table",
         )
-        # Ensure all results were fetched
-        mock_cursor.fetchall.assert_called_once()
+        # Ensure the results were fetched in pages
+        self.assertEqual(mock_cursor.fetchmany.call_count, 2)
 
     @patch("agentscope.service.sql_query.sqlite.sqlite3.connect")
     def test_query_sqlite_exception_handling(
@@ -170,6 +308,79 @@ class TestSQLQueries(unittest.TestCase):
         self.assertEqual(response.status, ServiceExecStatus.ERROR)
         self.assertIn("Connection Error", str(response.content))
 
+    def test_query_sqlite_memory(self) -> None:
+        """Test the in-memory databases are not pooled"""
+        response = query_sqlite(
+            database=":memory:",
+            query="CREATE TABLE t (id INTEGER)",
+            allow_change_data=True,
+        )
+        self.assertEqual(response.status, ServiceExecStatus.SUCCESS)
+        # the table doesn't persist in a new in-memory database
+        response = query_sqlite(database=":memory:", query="SELECT * FROM t")
+        self.assertEqual(response.status, ServiceExecStatus.ERROR)
+        self.assertIn("no such table", response.content)
+
+    def test_query_sqlite_pooled_and_budget(self) -> None:
+        """Test the pooled connections and the budgets on a sqlite file"""
+        tmp_dir = tempfile.mkdtemp()
+        database = os.path.join(tmp_dir, "test.sqlite")
+        try:
+            conn = sqlite3.connect(database)
+            conn.execute("CREATE TABLE t (id INTEGER, name TEXT)")
+            conn.executemany(
+                "INSERT INTO t VALUES (?, ?)",
+                [(i, f"name{i}") for i in range(1000)],
+            )
+            conn.commit()
+            conn.close()
+
+            with patch(
+                "agentscope.service.sql_query.sqlite.sqlite3.connect",
+                side_effect=sqlite3.connect,
+            ) as mock_connect:
+                # the change is committed on the pooled connection
+                response = query_sqlite(
+                    database=database,
+                    query="INSERT INTO t VALUES (-1, 'new')",
+                    allow_change_data=True,
+                )
+                self.assertEqual(response.status, ServiceExecStatus.SUCCESS)
+                response = query_sqlite(
+                    database=database,
+                    query="SELECT name FROM t WHERE id < 2 ORDER BY id",
+                )
+                self.assertEqual(
+                    response.content,
+                    [("new",), ("name0",), ("name1",)],
+                )
+                mock_connect.assert_called_once()
+
+                # the result exceeding the budget is summarized
+                response = query_sqlite(
+                    database=database,
+                    query="SELECT * FROM t",
+                    max_bytes=100,
+                )
+                self.assertEqual(response.content["count"], 1001)
+                self.assertEqual(len(response.content["sample"]), 8)
+
+                # or truncated
+                response = query_sqlite(
+                    database=database,
+                    query="SELECT * FROM t",
+                    maxcount_results=3,
+                    summarize=False,
+                )
+                self.assertEqual(
+                    response.content,
+                    [(0, "name0"), (1, "name1"), (2, "name2")],
+                )
+                mock_connect.assert_called_once()
+        finally:
+            close_sql_connection_pools()
+            shutil.rmtree(tmp_dir, ignore_errors=True)
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -0,0 +1,124 @@
+# -*- coding: utf-8 -*-
+"""Unit test for the map-reduce summarization."""
+import unittest
+from typing import List, Sequence, Union
+
+from agentscope.message import Msg
+from agentscope.models import ModelResponse, ModelWrapperBase
+from agentscope.service import (
+    summarization,
+    configure_summary_cache,
+    clear_summary_cache,
+)
+from agentscope.service.service_status import ServiceExecStatus
+
+
+class DummyModel(ModelWrapperBase):
+    """Dummy model that records the texts to summarize."""
+
+    def __init__(self) -> None:
+        self.config_name = "dummy"
+        self.model_name = "dummy"
+        self.texts: List[str] = []
+
+    def __call__(self, messages: list) -> ModelResponse:
+        text = messages[-1]["content"]
+        self.texts.append(text)
+        return ModelResponse(text=f"summary of {text.split()[0]}")
+
+    def format(
+        self,
+        *args: Union[Msg, Sequence[Msg]],
+    ) -> Union[List[dict], str]:
+        return [{"content": _.content} for _ in args[0]]
+
+
+class SummarizationTest(unittest.TestCase):
+    """Tests for the summarization service."""
+
+    def setUp(self) -> None:
+        """Generate a document of 40 paragraphs."""
+        self.paragraphs = [
+            f"p{i} " + " ".join(["word"] * 30) for i in range(40)
+        ]
+        clear_summary_cache()
+        self.addCleanup(configure_summary_cache)
+
+    def test_one_call_by_default(self) -> None:
+        """The long text is summarized in one call unless chunk_tokens is
+        given."""
+        model = DummyModel()
+        text = "\n\n".join(self.paragraphs)
+        response = summarization(model, text)
+        self.assertEqual(response.status, ServiceExecStatus.SUCCESS)
+        self.assertEqual(model.texts, [text])
+
+    def test_summary_cache(self) -> None:
+        """The cached chunk summaries are bounded and can be cleared."""
+        model = DummyModel()
+        text = "\n\n".join(self.paragraphs)
+        summarization(model, text, chunk_tokens=100)
+        n_calls = len(model.texts)
+
+        # The cached chunks are not summarized again
+        summarization(model, text, chunk_tokens=100)
+        self.assertEqual(len(model.texts), n_calls + 1)
+
+        clear_summary_cache()
+        summarization(model, text, chunk_tokens=100)
+        self.assertEqual(len(model.texts), 2 * n_calls + 1)
+
+        # The cache is disabled with size 0
+        configure_summary_cache(cache_size=0)
+        summarization(model, text, chunk_tokens=100)
+        self.assertEqual(len(model.texts), 3 * n_calls + 1)
+
+    def test_short_text(self) -> None:
+        """The short text is summarized in one call."""
+        model = DummyModel()
+        response = summarization(model, "short text", chunk_tokens=100)
+        self.assertEqual(response.status, ServiceExecStatus.SUCCESS)
+        self.assertEqual(response.content, "summary of short")
+        self.assertEqual(model.texts, ["short text"])
+
+    def test_map_reduce(self) -> None:
+        """The long text is summarized by chunks and then merged."""
+        model = DummyModel()
+        text = "\n\n".join(self.paragraphs)
+        # Summarize the chunks one by one to check their order
+        response = summarization(model, text, chunk_tokens=100, max_workers=1)
+
+        self.assertEqual(response.status, ServiceExecStatus.SUCCESS)
+        chunks = model.texts[:-1]
+        self.assertGreater(len(chunks), 1)
+        # The chunks cover the paragraphs in order
+        self.assertEqual("\n\n".join(chunks), text)
+        # The last call merges the summaries of the chunks
+        self.assertEqual(
+            model.texts[-1],
+            "\n\n".join(f"summary of {_.split()[0]}" for _ in chunks),
+        )
+
+        # Only the chunks around the edited paragraph are summarized again
+        model.texts.clear()
+        self.paragraphs[20] = "edited " + self.paragraphs[20]
+        summarization(model, "\n\n".join(self.paragraphs), chunk_tokens=100)
+        self.assertLessEqual(len(model.texts), 3)
+        self.assertTrue(any("edited" in _ for _ in model.texts[:-1]))
+
+    def test_hierarchical_reduce(self) -> None:
+        """The summaries are merged level by level if they're too long."""
+        model = DummyModel()
+        text = "\n\n".join(self.paragraphs)
+        # Each chunk holds a paragraph, and the summaries of 40 chunks
+        # don't fit in a chunk
+        response = summarization(model, text, chunk_tokens=20)
+
+        self.assertEqual(response.status, ServiceExecStatus.SUCCESS)
+        self.assertTrue(
+            any(_.startswith("summary of") for _ in model.texts[:-1]),
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
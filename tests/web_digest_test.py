@@ -1,12 +1,18 @@
 # -*- coding: utf-8 -*-
 """ Python web digest test."""
 
+import os
+import shutil
+import tempfile
+import time
 import unittest
-from typing import Union, Sequence, List
+from typing import Any, Union, Sequence, List
 from unittest.mock import patch, MagicMock, Mock
 
 from agentscope.service import ServiceResponse
-from agentscope.service import load_web, digest_webpage
+from agentscope.service import load_web, load_webs, digest_webpage
+from agentscope.service import parse_html_to_text
+from agentscope.service.web.web_digest import _WebPageCache
 from agentscope.service.service_status import ServiceExecStatus
 from agentscope.models import ModelWrapperBase, ModelResponse
 from agentscope.message import Msg
@@ -15,7 +21,7 @@ from agentscope.message import Msg
 class TestWebDigest(unittest.TestCase):
     """Tests for web loading and digesting."""
 
-    @patch("requests.get")
+    @patch("requests.Session.get")
     def test_web_load(self, mock_get: MagicMock) -> None:
         """test web_load function loading html"""
         # Set up the mock response
@@ -70,6 +76,136 @@ class TestWebDigest(unittest.TestCase):
             expected_result,
         )
 
+    @patch("requests.Session.get")
+    def test_web_load_batch(self, mock_get: MagicMock) -> None:
+        """test load_webs function loading web pages concurrently"""
+
+        def fake_get(url: str, **_: Any) -> Mock:
+            mock_response = Mock()
+            mock_response.text = f"<p>{url}</p>"
+            mock_response.content = bytes(mock_response.text, "utf-8")
+            mock_response.status_code = 404 if "missing" in url else 200
+            mock_response.headers = {"Content-Type": "text/html"}
+            return mock_response
+
+        mock_get.side_effect = fake_get
+
+        urls = [
+            "http://a.com/1",
+            "http://b.com/missing",
+            "http://a.com/2",
+            "http://a.com/1",
+        ]
+        results = load_webs(
+            urls,
+            keep_raw=False,
+            html_selected_tags=["p"],
+            max_per_host=1,
+        )
+
+        self.assertEqual(results.status, ServiceExecStatus.SUCCESS)
+        # In the order of urls, and the duplicated url is loaded once
+        self.assertEqual(list(results.content), urls[:3])
+        self.assertEqual(mock_get.call_count, 3)
+        self.assertEqual(
+            results.content["http://a.com/2"],
+            ServiceResponse(
+                status=ServiceExecStatus.SUCCESS,
+                content={"html_to_text": "http://a.com/2"},
+            ),
+        )
+        self.assertEqual(
+            results.content["http://b.com/missing"].status,
+            ServiceExecStatus.ERROR,
+        )
+
+    @patch("requests.Session.get")
+    def test_web_load_cache(self, mock_get: MagicMock) -> None:
+        """test load_web function revalidating the cached web page"""
+        cache_dir = tempfile.mkdtemp()
+        self.addCleanup(shutil.rmtree, cache_dir)
+
+        page = Mock()
+        page.text = "<p>cached page</p>"
+        page.content = bytes(page.text, "utf-8")
+        page.encoding = "utf-8"
+        page.status_code = 200
+        page.headers = {"Content-Type": "text/html", "ETag": '"v1"'}
+        not_modified = Mock()
+        not_modified.status_code = 304
+        not_modified.headers = {}
+        mock_get.side_effect = [page, not_modified]
+
+        expected_result = ServiceResponse(
+            status=ServiceExecStatus.SUCCESS,
+            content={
+                "raw": page.content,
+                "html_to_text": "cached page",
+            },
+        )
+        for _ in range(2):
+            results = load_web(
+                url="http://a.com",
+                html_selected_tags=["p"],
+                cache_dir=cache_dir,
+            )
+            self.assertEqual(results, expected_result)
+
+        # The second request is conditional on the ETag of the cached page
+        self.assertNotIn(
+            "If-None-Match",
+            mock_get.call_args_list[0].kwargs["headers"],
+        )
+        self.assertEqual(
+            mock_get.call_args_list[1].kwargs["headers"]["If-None-Match"],
+            '"v1"',
+        )
+
+    def test_web_cache_eviction(self) -> None:
+        """test the web page cache evicting the expired and the least
+        recently used pages"""
+        cache_dir = tempfile.mkdtemp()
+        self.addCleanup(shutil.rmtree, cache_dir)
+
+        page = Mock()
+        page.content = b"<p>" + b"x" * 100 + b"</p>"
+        page.encoding = "utf-8"
+        page.headers = {"ETag": '"v1"'}
+
+        cache = _WebPageCache(cache_dir, max_bytes=400, max_age=3600)
+        now = time.time()
+        for i, url in enumerate(["http://a.com", "http://b.com"]):
+            cache.save(url, page)
+            path = cache._path(url)  # pylint: disable=W0212
+            os.utime(path, (now - 10 + i, now - 10 + i))
+
+        # The least recently used page is evicted to fit in the size limit
+        cache.load("http://a.com")
+        cache.save("http://c.com", page)
+        self.assertIsNotNone(cache.load("http://a.com"))
+        self.assertIsNone(cache.load("http://b.com"))
+        self.assertIsNotNone(cache.load("http://c.com"))
+
+        # The expired page is evicted
+        old_time = now - 7200
+        path = cache._path("http://a.com")  # pylint: disable=W0212
+        os.utime(path, (old_time, old_time))
+        cache.save("http://d.com", page)
+        self.assertIsNone(cache.load("http://a.com"))
+        self.assertIsNotNone(cache.load("http://c.com"))
+
+    def test_parse_html_to_text(self) -> None:
+        """test the text of script and style is dropped from the selected
+        elements"""
+        html = (
+            "<div>Hello <script>var x = 1;</script><style>p {}</style>"
+            "<a href='http://a.com'>world</a></div><p>skipped</p>"
+        )
+        self.assertEqual(
+            parse_html_to_text(html, ["div"]),
+            "Hello [world](http://a.com)",
+        )
+
     def test_web_digest(self) -> None:
         """test web_digest function"""
 
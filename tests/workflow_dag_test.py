@@ -0,0 +1,74 @@
+# -*- coding: utf-8 -*-
+"""Unit tests for the parallel executor of workstation workflow."""
+import time
+import unittest
+from typing import Any, Callable
+
+from agentscope.web.workstation.workflow_utils import (
+    critical_path,
+    run_dag,
+)
+
+
+def _sleep_node(delay: float, value: str) -> Callable[[Any], Any]:
+    """Create a node that appends its value to the input after a delay."""
+
+    def _node(x: Any) -> Any:
+        time.sleep(delay)
+        return (x or "") + value
+
+    return _node
+
+
+class WorkflowDagTest(unittest.TestCase):
+    """Test cases for run_dag."""
+
+    def setUp(self) -> None:
+        """Init the diamond DAG: a -> (b, c) -> d."""
+        self.nodes = {
+            "a": _sleep_node(0.05, "a"),
+            "b": _sleep_node(0.3, "b"),
+            "c": _sleep_node(0.3, "c"),
+            "d": _sleep_node(0.05, "d"),
+        }
+        self.predecessors = {
+            "a": [],
+            "b": ["a"],
+            "c": ["a"],
+            "d": ["b", "c"],
+        }
+
+    def test_run_dag(self) -> None:
+        """Test the independent nodes are executed concurrently."""
+        start = time.perf_counter()
+        values, timings = run_dag(self.nodes, self.predecessors, x=">")
+        self.assertLess(time.perf_counter() - start, 0.6)
+
+        self.assertDictEqual(
+            values,
+            {"a": ">a", "b": ">ab", "c": ">ac", "d": ">abd"},
+        )
+
+        path, total = critical_path(self.predecessors, timings)
+        self.assertEqual(path[0], "a")
+        self.assertEqual(path[-1], "d")
+        self.assertEqual(len(path), 3)
+        self.assertGreaterEqual(total, 0.4)
+
+    def test_failure_propagation(self) -> None:
+        """Test the successors of a failed node are not executed."""
+
+        def _fail(_: Any) -> Any:
+            raise RuntimeError("failed")
+
+        executed = []
+        self.nodes["b"] = _fail
+        self.nodes["d"] = executed.append
+
+        with self.assertRaises(RuntimeError):
+            run_dag(self.nodes, self.predecessors)
+        self.assertListEqual(executed, [])
+
+
+if __name__ == "__main__":
+    unittest.main()